@@ -0,0 +1,206 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the calendar of the absences
+
+  \details The tree needs no pointers: the range [first, last) has its root at the middle, the left
+           subtree is [first, middle) and the right subtree [middle + 1, last). Because the entries are
+           ordered by the first day, all entries of the right subtree begin after `to` when the root
+           does, and max_to tells when a whole subtree ends before `from`.
+
+  \version 1.0
+  \date    17.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "AbsenceCalendar.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <algorithm>
+#include <utility>
+#include <tuple>
+#include <iterator>
+
+namespace {
+
+   bool before(AbsenceEntry const& lhs, AbsenceEntry const& rhs) {
+      return std::tie(lhs.from, lhs.absenceId) < std::tie(rhs.from, rhs.absenceId);
+      }
+
+   bool by_employee(AbsenceEntry const& lhs, AbsenceEntry const& rhs) {
+      return std::tie(lhs.personId, lhs.from, lhs.absenceId) < std::tie(rhs.personId, rhs.from, rhs.absenceId);
+      }
+
+   /// \brief reports the entries of the subtree [first, last) which overlap [from, to]
+   void collect(std::vector<AbsenceEntry> const& entries, std::vector<std::chrono::sys_days> const& max_to,
+                std::size_t first, std::size_t last, std::chrono::sys_days from, std::chrono::sys_days to,
+                std::vector<AbsenceEntry>& result) {
+      while (first < last) {
+         auto const middle = first + (last - first) / 2;
+         if (max_to[middle] < from) return;   // the whole subtree ends before the range
+         collect(entries, max_to, first, middle, from, to, result);
+         auto const& entry = entries[middle];
+         if (entry.from > to) return;         // the root and the right subtree begin after the range
+         if (entry.to >= from) result.emplace_back(entry);
+         first = middle + 1;                  // right subtree without a further recursion
+         }
+      }
+
+   }
+
+std::chrono::sys_days AbsenceCalendar::build_tree(Index& index, std::size_t first, std::size_t last) {
+   auto const middle = first + (last - first) / 2;
+   auto latest = index.entries[middle].to;
+   if (first < middle) latest = std::max(latest, build_tree(index, first, middle));
+   if (middle + 1 < last) latest = std::max(latest, build_tree(index, middle + 1, last));
+   index.max_to[middle] = latest;
+   return latest;
+   }
+
+void AbsenceCalendar::rebuild(Index& index) {
+   index.max_to.resize(index.entries.size());
+   if (!index.entries.empty()) build_tree(index, 0, index.entries.size());
+   }
+
+AbsenceCalendar::entries_ty::iterator AbsenceCalendar::employee_position(Index& index, AbsenceEntry const& entry) {
+   return std::ranges::lower_bound(index.employees, entry, by_employee);
+   }
+
+template <typename func_ty>
+auto AbsenceCalendar::update(func_ty&& change) {
+   std::lock_guard lock(writer_);
+   // the copy gets room for one more entry, so an insert doesn't copy the arrays a second time
+   auto const current = current_.load(std::memory_order_relaxed);
+   auto next = std::make_shared<Index>();
+   auto copy = [](auto const& source, auto& target) {
+      target.reserve(source.size() + 1);
+      target.assign(source.begin(), source.end());
+      };
+   copy(current->entries, next->entries);
+   copy(current->max_to, next->max_to);
+   copy(current->employees, next->employees);
+   auto result = change(*next);
+   current_.store(std::move(next), std::memory_order_release);
+   return result;
+   }
+
+std::uint64_t AbsenceCalendar::add(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to,
+                                   Organization::EAbsenceKind kind, bool approved) {
+   return add(AbsenceEntry { .absenceId = 0, .personId = personId, .from = from, .to = to, .kind = kind, .approved = approved });
+   }
+
+std::uint64_t AbsenceCalendar::add(AbsenceEntry entry) {
+   auto const added = update([&](Index& index) {
+                                if (entry.absenceId == 0) entry.absenceId = next_id_++;
+                                else if (std::ranges::find(index.entries, entry.absenceId, &AbsenceEntry::absenceId) != index.entries.end()) return false;
+                                next_id_ = std::max(next_id_, entry.absenceId + 1);
+                                index.entries.insert(std::ranges::upper_bound(index.entries, entry, before), entry);
+                                index.employees.insert(employee_position(index, entry), entry);
+                                rebuild(index);
+                                return true;
+                                });
+   if (added) log_trace<4>("[AbsenceCalendar {}] absence {} of employee {} added.", ::getTimeStamp(), entry.absenceId, entry.personId);
+   return entry.absenceId;
+   }
+
+std::uint64_t AbsenceCalendar::reserve_id() {
+   std::lock_guard lock(writer_);
+   return next_id_++;
+   }
+
+std::uint64_t AbsenceCalendar::next_id() const {
+   std::lock_guard lock(writer_);
+   return next_id_;
+   }
+
+void AbsenceCalendar::load(entries_ty entries, std::uint64_t next_id) {
+   update([&](Index& index) {
+             next_id_ = std::max(next_id_, next_id);
+             for (auto& entry : entries) if (entry.absenceId == 0) entry.absenceId = next_id_++;
+             for (auto const& entry : entries) next_id_ = std::max(next_id_, entry.absenceId + 1);
+             index.employees = entries;
+             std::ranges::sort(index.employees, by_employee);
+             std::ranges::sort(entries, before);
+             index.entries = std::move(entries);
+             rebuild(index);
+             return true;
+             });
+   log_trace<4>("[AbsenceCalendar {}] {} absences loaded.", ::getTimeStamp(), size());
+   }
+
+bool AbsenceCalendar::remove(std::uint64_t absenceId) {
+   return update([absenceId](Index& index) {
+                    auto it = std::ranges::find(index.entries, absenceId, &AbsenceEntry::absenceId);
+                    if (it == index.entries.end()) return false;
+                    index.employees.erase(employee_position(index, *it));
+                    index.entries.erase(it);
+                    rebuild(index);
+                    return true;
+                    });
+   }
+
+bool AbsenceCalendar::approve(std::uint64_t absenceId, bool approved) {
+   return update([absenceId, approved](Index& index) {
+                    auto it = std::ranges::find(index.entries, absenceId, &AbsenceEntry::absenceId);
+                    if (it == index.entries.end()) return false;
+                    it->approved = approved;   // the order and the tree don't depend on the approval
+                    employee_position(index, *it)->approved = approved;
+                    return true;
+                    });
+   }
+
+std::optional<AbsenceEntry> AbsenceCalendar::find(std::uint64_t absenceId) const {
+   auto const index = current_.load(std::memory_order_acquire);
+   if (auto it = std::ranges::find(index->entries, absenceId, &AbsenceEntry::absenceId); it != index->entries.end()) return *it;
+   return std::nullopt;
+   }
+
+AbsenceCalendar::entries_ty AbsenceCalendar::overlapping(std::chrono::sys_days from, std::chrono::sys_days to) const {
+   auto const index = current_.load(std::memory_order_acquire);
+   entries_ty result;
+   collect(index->entries, index->max_to, 0, index->entries.size(), from, to, result);
+   return result;
+   }
+
+AbsenceCalendar::entries_ty AbsenceCalendar::overlapping(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to) const {
+   auto const index = current_.load(std::memory_order_acquire);
+   entries_ty result;
+   auto const first = std::ranges::lower_bound(index->employees, personId, { }, &AbsenceEntry::personId);
+   auto const last  = std::ranges::upper_bound(first, index->employees.end(), std::tuple { personId, to },
+                                               std::less<> { }, [](auto const& entry) { return std::tuple { entry.personId, entry.from }; });
+   std::copy_if(first, last, std::back_inserter(result), [from](auto const& entry) { return entry.to >= from; });
+   return result;
+   }
+
+std::vector<std::chrono::sys_days> AbsenceCalendar::absent_days(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to) const {
+   std::vector<std::chrono::sys_days> days;
+   for (auto const& entry : overlapping(personId, from, to)) {
+      if (!entry.approved) continue;
+      for (auto day = std::max(entry.from, from); day <= std::min(entry.to, to); day += std::chrono::days { 1 }) days.emplace_back(day);
+      }
+   std::ranges::sort(days);
+   auto [last, end] = std::ranges::unique(days);
+   days.erase(last, end);
+   return days;
+   }
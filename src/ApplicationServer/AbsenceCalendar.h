@@ -0,0 +1,154 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Calendar of the absences (vacation, sickness, training) with overlap queries for the whole company.
+
+  \details This header declares the class `AbsenceCalendar`. All absences are kept in one array ordered
+           by the first day. The array is an implicit balanced interval tree: the root of a range is its
+           middle entry, and a second array holds the latest last day in the subtree of each entry. A
+           query for the absences overlapping [from, to] skips every subtree which ends before `from` or
+           begins after `to`, so it visits O(log n + k) entries for k results. For the queries of a single
+           employee the entries are kept a second time, ordered by the employee and the first day.
+
+  \details The calendar is published as immutable versions like the `EmployeeVersions`: readers take
+           the current version without a lock, a writer copies the arrays, changes them and publishes
+           the copy. Absences change seldom compared to the queries of the planning views.
+
+  \version 1.0
+  \date    17.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see EmployeeVersions.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "OrganizationC.h"
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// \brief absence of an employee in the closed range of days [from, to]
+struct AbsenceEntry {
+   std::uint64_t              absenceId = 0;      ///< unique id, assigned by the calendar
+   CORBA::Long                personId  = -1;
+   std::chrono::sys_days      from;               ///< first day of the absence
+   std::chrono::sys_days      to;                 ///< last day of the absence
+   Organization::EAbsenceKind kind      = Organization::ABSENCE_VACATION;
+   bool                       approved  = false;  ///< only approved absences reduce the target time
+   };
+
+/**
+  \brief Absences of all employees as immutable versions with an implicit interval tree.
+ */
+class AbsenceCalendar {
+private:
+   using entries_ty = std::vector<AbsenceEntry>;
+
+   /// \brief one published version of the calendar
+   struct Index {
+      entries_ty                         entries;    ///< ordered by the first day, then by the id
+      std::vector<std::chrono::sys_days> max_to;     ///< latest last day in the subtree of the entry
+      entries_ty                         employees;  ///< the same entries ordered by the employee, then like entries
+      };
+
+   std::atomic<std::shared_ptr<Index const>> current_;
+   mutable std::mutex                        writer_;          ///< serializes the writers, never taken by a reader
+   std::uint64_t                             next_id_ = 1;     ///< guarded by writer_
+
+public:
+   AbsenceCalendar() : current_(std::make_shared<Index const>()) { }
+   AbsenceCalendar(AbsenceCalendar const&) = delete;
+   AbsenceCalendar& operator = (AbsenceCalendar const&) = delete;
+
+   /**
+     \brief Adds an absence.
+     \pre from <= to
+     \return id of the new absence
+    */
+   std::uint64_t add(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to,
+                     Organization::EAbsenceKind kind, bool approved);
+
+   /**
+     \brief Adds an absence with an id of \ref reserve_id, e.g. after it was written to the journal.
+     \details An entry without an id gets a new id. When an absence with the id exists already (replay of
+              the journal behind a snapshot), the calendar isn't changed.
+     \pre entry.from <= entry.to
+     \return id of the absence
+    */
+   std::uint64_t add(AbsenceEntry entry);
+
+   /// \brief reserves the id of a new absence, so it can be written to the journal before it is added
+   std::uint64_t reserve_id();
+
+   /**
+     \brief Replaces all absences, e.g. after a load from the database or from a snapshot.
+     \details Entries without an id get a new id. The tree is built once for all entries.
+     \param next_id lowest id for new absences, ids of removed absences aren't used again
+    */
+   void load(entries_ty entries, std::uint64_t next_id = 1);
+
+   /// \brief all absences of the current version, ordered by the first day, e.g. for a snapshot
+   entries_ty entries() const { return current_.load(std::memory_order_acquire)->entries; }
+
+   /// \brief lowest id for new absences, read after \ref entries it is above all ids of the entries
+   std::uint64_t next_id() const;
+
+   /// \brief removes an absence, \return false if there is no absence with the id
+   bool remove(std::uint64_t absenceId);
+
+   /// \brief changes the approval of an absence, \return false if there is no absence with the id
+   bool approve(std::uint64_t absenceId, bool approved);
+
+   /// \brief absence with the id
+   std::optional<AbsenceEntry> find(std::uint64_t absenceId) const;
+
+   /// \brief absences of all employees which overlap the closed range [from, to], ordered by the first day
+   entries_ty overlapping(std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /// \brief absences of an employee which overlap the closed range [from, to], ordered by the first day
+   entries_ty overlapping(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /// \brief days in [from, to] with an approved absence of the employee, ascending and without duplicates
+   std::vector<std::chrono::sys_days> absent_days(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /// \brief number of absences in the current version
+   std::size_t size() const { return current_.load(std::memory_order_acquire)->entries.size(); }
+
+private:
+   /// \brief copies the current version, changes the copy and publishes it
+   template <typename func_ty>
+   auto update(func_ty&& change);
+
+   /// \brief fills max_to for the subtree of the not empty range [first, last) and returns its latest last day
+   static std::chrono::sys_days build_tree(Index& index, std::size_t first, std::size_t last);
+
+   static void rebuild(Index& index);
+
+   /// \brief position of an entry in the array ordered by the employees
+   static entries_ty::iterator employee_position(Index& index, AbsenceEntry const& entry);
+   };
@@ -62,6 +62,10 @@
 #include "OrganizationC.h"
 
 #include "Company_i.h"
+#include "EmployeePOA.h"
+#include "DatabasePool.h"
+#include "EmployeeStatements.h"
+#include "EmployeeLoader.h"
 #include "Corba_Interfaces.h"
 #include "Corba_CombiInterface.h"
 
@@ -71,6 +75,7 @@
 #include <tao/PortableServer/LifespanPolicyA.h>
 
 #include <orbsvcs/CosNamingC.h>
+#include <orbsvcs/CosEventChannelAdminC.h>
 
 #include <QtCore/QCoreApplication>
 #include <QHostInfo>
@@ -78,7 +83,13 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <span>
+#include <algorithm>
 #include <chrono>
+#include <optional>
+#include <filesystem>
 #include <thread>
 #include <atomic>
 #include <format>
@@ -91,6 +102,7 @@
 #endif
 
 using namespace std::string_literals;
+using namespace std::string_view_literals;
 //using namespace std::chrono_literals;
 
 /**
@@ -109,6 +121,7 @@ using concrete_db_server = TMyMSSQL;
 using concrete_framework = TMyQtDb<concrete_db_server>;
 using concrete_db_connection = TMyDatabase<TMyQtDb, concrete_db_server>;
 using concrete_query = TMyQuery<TMyQtDb, concrete_db_server>;
+using db_pool_ty = DatabasePool<concrete_db_connection, concrete_query>;
 
 void Connect(concrete_db_connection& database,
              std::string const& strDatabase, std::string const& strServer, std::string const& strDomain,
@@ -164,6 +177,130 @@ void signal_handler(int sig_num) {
    shutdown_requested = true;
    }
 
+/**
+  \brief Reads the configuration of the employee POA from the command line.
+
+  \details With the option `-EmployeeCache <n>` the employee POA works with a servant locator,
+           which keeps at most `n` `Employee_i` servants in a LRU cache. Without the option one
+           stateless default servant serves all employee references.
+
+  \param argc number of command line arguments
+  \param argv command line arguments
+  \return configuration for the employee POA and the \ref Company_i servant
+ */
+EmployeePOAConfig ReadEmployeePOAConfig(int argc, char* argv[]) {
+   EmployeePOAConfig config;
+   for (int i = 1; i + 1 < argc; ++i) {
+      if (std::string_view { argv[i] } == "-EmployeeCache"sv) {
+         std::string_view value { argv[i + 1] };
+         std::size_t cache_size = 0;
+         if (auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), cache_size);
+                                ec == std::errc{} && ptr == value.data() + value.size() && cache_size > 0) {
+            config.mode       = EEmployeePOAMode::ServantLocator;
+            config.cache_size = cache_size;
+            }
+         else
+            log_error("[ReadEmployeePOAConfig {}] invalid value \"{}\" for -EmployeeCache, default servant used.", ::getTimeStamp(), value);
+         }
+      }
+   return config;
+   }
+
+/**
+  \brief Reads the directory of the booking journal from the command line.
+  \details With the option `-BookingJournal <directory>` every accepted booking is written to the durable
+           journal in the directory, and the bookings of the journal are restored at the startup. The
+           snapshots of the state are written into the same directory.
+  \param argc number of command line arguments
+  \param argv command line arguments
+  \return configuration of the journal, or std::nullopt without the option
+ */
+std::optional<BookingJournal::Config> ReadBookingJournalConfig(int argc, char* argv[]) {
+   for (int i = 1; i + 1 < argc; ++i) {
+      if (std::string_view { argv[i] } == "-BookingJournal"sv) return BookingJournal::Config { .directory = argv[i + 1] };
+      }
+   return std::nullopt;
+   }
+
+/**
+  \brief Reads the time zone of the local days of the worked time from the command line.
+  \details With the option `-TimeZone <name>` the days of the bookings are the days of the IANA time zone,
+           e.g. `-TimeZone Europe/Vienna`, the default is Europe/Berlin. The change of the daylight saving
+           time is taken from the tz database.
+  \param argc number of command line arguments
+  \param argv command line arguments
+  \return rules of the calculation of the worked time
+ */
+WorkTimeEngine::Config ReadWorkTimeConfig(int argc, char* argv[]) {
+   WorkTimeEngine::Config config;
+   for (int i = 1; i + 1 < argc; ++i) {
+      if (std::string_view { argv[i] } == "-TimeZone"sv) config.time_zone = argv[i + 1];
+      }
+   return config;
+   }
+
+/**
+  \brief Reads the export of the timesheets in the command line mode.
+  \details With the option `-ExportTimesheets <file>` the server restores its state, exports the timesheets
+           of all employees for the previous month into the file and exits without registering the
+           company. The format is binary when the file ends with ".bin", CSV otherwise.
+  \param argc number of command line arguments
+  \param argv command line arguments
+  \return configuration of the export, or std::nullopt without the option
+ */
+std::optional<TimesheetExport::Config> ReadTimesheetExportConfig(int argc, char* argv[]) {
+   using namespace std::chrono;
+   for (int i = 1; i + 1 < argc; ++i) {
+      if (std::string_view { argv[i] } == "-ExportTimesheets"sv) {
+         std::filesystem::path file { argv[i + 1] };
+         year_month_day const today { floor<days>(system_clock::now()) };
+         auto const month = year_month { today.year(), today.month() } - months { 1 };
+         return TimesheetExport::Config { .file   = file,
+                                          .format = file.extension() == ".bin" ? TimesheetExport::EFormat::Binary : TimesheetExport::EFormat::Csv,
+                                          .from   = sys_days { month / 1 }, .to = sys_days { month / last } };
+         }
+      }
+   return std::nullopt;
+   }
+
+/// \brief dispatch of the requests by the ORB of the server
+struct ORBDispatchConfig {
+   EORBDispatch profile = EORBDispatch::ThreadPool;
+   std::size_t  threads = 0;   ///< threads calling orb->run(), 0 = hardware concurrency
+   };
+
+/**
+  \brief Reads the dispatch of the requests from the command line.
+  \details With the option `-DispatchThreads <n>` the requests are dispatched by `n` threads, the default is
+           one thread per core. With `-DispatchProfile connection` each client connection gets an own thread
+           (thread-per-connection strategy of TAO), with `-DispatchProfile pool` (default) the threads of the
+           server share the connections (thread pool reactor).
+  \param argc number of command line arguments
+  \param argv command line arguments
+  \return profile and number of the dispatch threads
+ */
+ORBDispatchConfig ReadORBDispatchConfig(int argc, char* argv[]) {
+   ORBDispatchConfig config;
+   for (int i = 1; i + 1 < argc; ++i) {
+      std::string_view value { argv[i + 1] };
+      if (std::string_view { argv[i] } == "-DispatchThreads"sv) {
+         std::size_t threads = 0;
+         if (auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), threads);
+                                ec == std::errc{} && ptr == value.data() + value.size() && threads > 0)
+            config.threads = threads;
+         else
+            log_error("[ReadORBDispatchConfig {}] invalid value \"{}\" for -DispatchThreads, one thread per core used.", ::getTimeStamp(), value);
+         }
+      else if (std::string_view { argv[i] } == "-DispatchProfile"sv) {
+         if (value == "pool"sv) config.profile = EORBDispatch::ThreadPool;
+         else if (value == "connection"sv) config.profile = EORBDispatch::ThreadPerConnection;
+         else
+            log_error("[ReadORBDispatchConfig {}] invalid value \"{}\" for -DispatchProfile, thread pool used.", ::getTimeStamp(), value);
+         }
+      }
+   return config;
+   }
+
 static_assert(CORBASkeleton<Company_i>, "Company_i erfüllt nicht das CORBASkeleton-Concept");
 
 int main(int argc, char *argv[]) {
@@ -194,17 +331,18 @@ int main(int argc, char *argv[]) {
    std::println("Host: {}", hostname);
    std::println("Domäne: {}", localDomain);
 
-   concrete_db_connection database;
-   Connect(database, "Test_Personen"s, "DESKTOP-UR8733U"s, localDomain, ""s);
-
-   auto query = database.CreateQuery("SELECT ID, Name, Firstname, BirthName, FormOfAddress, "s +
-      "FamilyStatus, FamilyStatusSince, Birthday, Notes, FullName "s +
-      "FROM Person "s
-      "WHERE Name = :keyName AND Firstname = :keyFirstname"s);
+   // the idle connections are checked every minute, a broken connection is reopened
+   db_pool_ty database_pool({ .size = 4, .health_check_interval = std::chrono::minutes { 1 } }, [&localDomain](concrete_db_connection& database) {
+                                 Connect(database, "Test_Personen"s, "DESKTOP-UR8733U"s, localDomain, ""s);
+                                 });
 
-   if (query.Execute({ { "keyName", "Braun", true },   {"keyFirstname", "Isabelle", true } }); !query.IsEof()) {
-      std::println("{}: {}", query.Get <int>("ID").value_or(0), query.Get<std::string>("FullName").value_or(""));
-      }
+   {
+      auto connection = database_pool.acquire();
+      auto& query = connection.statement(PersonByName.name, PersonByName.sql);
+      if (query.Execute({ { "keyName", "Braun", true },   {"keyFirstname", "Isabelle", true } }); !query.IsEof()) {
+         std::println("{}: {}", query.Get <int>("ID").value_or(0), query.Get<std::string>("FullName").value_or(""));
+         }
+   }
 
 
    {
@@ -236,29 +374,80 @@ int main(int argc, char *argv[]) {
    
    try {
       //CORBAServer<Company_i> server(strAppl, argc, argv, std::chrono::milliseconds(500));
-      CORBAClientServer<Skel<Company_i>> server("CORBA Factories"s, argc, argv);
+      // the requests are dispatched by several threads, Company_i and its employees are thread safe
+      auto dispatch_config = ReadORBDispatchConfig(argc, argv);
+      ORBArguments orb_args(argc, argv, dispatch_config.profile);
+      CORBAClientServer<Skel<Company_i>> server("CORBA Factories"s, orb_args.argc(), orb_args.argv());
  
-      auto CreateTransient = [](PortableServer::POA_ptr poa) {
-         CORBA::PolicyList pol_list;
-         pol_list.length(2);
-         pol_list[0] = poa->create_lifespan_policy(PortableServer::TRANSIENT);
-         pol_list[1] = poa->create_servant_retention_policy(PortableServer::ServantRetentionPolicyValue::RETAIN);
-         return pol_list;
-         };
-
-      auto empl_pol = CreateTransient(server.root_poa());
+      // employee references are created with the person id as ObjectId and served by one default servant,
+      // or with -EmployeeCache <n> by a servant locator with a bounded cache of servants
+      auto empl_config = ReadEmployeePOAConfig(argc, argv);
+      auto empl_pol = CreateEmployeePolicies(server.root_poa(), empl_config.mode);
       PortableServer::POA_var employee_poa = server.root_poa()->create_POA("EmployeePOA", server.poa_manager(), empl_pol);
       for (uint32_t i = 0; i < empl_pol.length(); ++i) empl_pol[i]->destroy();
 
+      // the local days of the worked time are the days of the time zone of -TimeZone <name> (Europe/Berlin)
+      auto company = new Company_i(server.orb(), server.servant_poa(), employee_poa.in(), empl_config, ReadWorkTimeConfig(argc, argv));
+
+      // with -BookingJournal <directory> the bookings are durable, the newest snapshot in the directory and
+      // the journal behind it are restored at the start (before the database, which stays the master of the employees)
+      if (auto journal_config = ReadBookingJournalConfig(argc, argv); journal_config) {
+         auto const start = std::chrono::steady_clock::now();
+         SnapshotManager::Config snapshot_config { .directory = journal_config->directory };
+         auto stats = company->openBookingJournal(std::move(*journal_config), std::move(snapshot_config));
+         std::println(std::cout, "[{} {}] {} bookings replayed from the journal, state restored in {}.", strAppl, ::getTimeStamp(), stats.records,
+                      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+         }
+      // with -EmployeesFromDatabase the test data is replaced by the employees of the database
+      if (std::ranges::any_of(std::span(argv, argc), [](char* arg) { return std::string_view { arg } == "-EmployeesFromDatabase"sv; })) {
+         EmployeeStore store;
+         auto stats = LoadEmployees(database_pool, store, { .partitions = 4, .rowset_size = 10'000 });
+         std::println(std::cout, "[{} {}] {} employees loaded, {:.0f} rows/s.", strAppl, ::getTimeStamp(), stats.rows, stats.rows_per_second());
+         company->replaceEmployees(std::move(store));
+         }
+      // with -EmployeeReadThrough single employees are read from the database through a cache
+      if (std::ranges::any_of(std::span(argv, argc), [](char* arg) { return std::string_view { arg } == "-EmployeeReadThrough"sv; })) {
+         company->setEmployeeRepository([&database_pool](CORBA::Long personId) { return FetchEmployee(database_pool, personId); },
+                                        { .shards = 16, .capacity = 10'000, .ttl = std::chrono::minutes { 5 }, .negative_ttl = std::chrono::seconds { 30 } });
+         }
+      // with -PresenceEvents the changes of the presence are pushed to the event service (-ORBInitRef EventService=...)
+      if (std::ranges::any_of(std::span(argv, argc), [](char* arg) { return std::string_view { arg } == "-PresenceEvents"sv; })) {
+         CORBA::Object_var object = server.orb()->resolve_initial_references("EventService");
+         CosEventChannelAdmin::EventChannel_var channel = CosEventChannelAdmin::EventChannel::_narrow(object.in());
+         if (CORBA::is_nil(channel.in())) throw std::runtime_error("EventService isn't an event channel.");
+         company->connectPresenceEvents(channel.in());
+         std::println(std::cout, "[{} {}] presence events connected to the event service.", strAppl, ::getTimeStamp());
+         }
+      // with -ExportDirectory <directory> the files of startTimesheetExport are written into the directory
+      for (int i = 1; i + 1 < argc; ++i) {
+         if (std::string_view { argv[i] } == "-ExportDirectory"sv) company->setExportDirectory(argv[i + 1]);
+         }
+      // with -ExportTimesheets <file> the server only exports the previous month and exits
+      if (auto export_config = ReadTimesheetExportConfig(argc, argv); export_config) {
+         PortableServer::ServantBase_var owner = company;   // not registered, released at the end of the block
+         company->startExport(*export_config);
+         for (auto progress = company->timesheetExport().progress(); progress.running; progress = company->timesheetExport().progress()) {
+            std::println(std::cout, "[{} {}] export: {} of {} employees, {} bytes.", strAppl, ::getTimeStamp(), progress.done, progress.employees, progress.bytes);
+            std::this_thread::sleep_for(std::chrono::seconds { 1 });
+            }
+         auto const progress = company->timesheetExport().progress();
+         if (!progress.finished) {
+            log_error("[{} {}] export of the timesheets failed: {}", strAppl, ::getTimeStamp(), progress.error);
+            return 1;
+            }
+         std::println(std::cout, "[{} {}] timesheets of {} employees exported to {} in {}.", strAppl, ::getTimeStamp(), progress.done,
+                      progress.file.string(), progress.elapsed);
+         return 0;
+         }
       server.register_servant<0>(strName, [poa = std::move(employee_poa)]() mutable {
                                          if(!CORBA::is_nil(poa.in())) {
                                             poa->destroy(true, true);
                                             log_trace<2>("[independent Lambda Fuction {}] Employee POA destroyed.", ::getTimeStamp());
                                             }
                                          }, 
-                             new Company_i(server.servant_poa(), employee_poa.in()));
+                             company);
 
-      server.run(shutdown_requested);
+      server.run(shutdown_requested, dispatch_config.threads);
       }
    catch (CORBA::Exception const& ex) {
       log_error("[{} {}] CORBA Exception caught: {}", strAppl, ::getTimeStamp(), toString(ex));
@@ -0,0 +1,445 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the durable journal of the time bookings
+
+  \details The segment files are mapped with `ACE_Mem_Map`, which is available on all platforms of
+           the TAO server. The writers copy their records into the mapping under a short lock and
+           wait for the flusher, the flusher syncs the written pages outside of the lock.
+
+  \version 1.0
+  \date    08.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BookingJournal.h"
+#include "DurableFiles.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <ace/OS_NS_sys_mman.h>
+#include <ace/OS_NS_unistd.h>
+
+#include <algorithm>
+#include <ranges>
+#include <bit>
+#include <utility>
+#include <stdexcept>
+#include <format>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+
+namespace {
+
+   constexpr char JournalMagic[8] = { 'W', 'T', 'R', 'J', 'R', 'N', 'L', '1' };
+
+   std::uint32_t checksum(JournalRecord const& record) { return crc32(&record, offsetof(JournalRecord, checksum)); }
+
+   constexpr std::uint8_t AbsenceApprovedFlag = 0x80;
+   std::uint32_t checksum(JournalHeader const& header) { return crc32(&header, offsetof(JournalHeader, checksum)); }
+
+   std::string segment_name(std::uint64_t first_sequence) {
+      return std::format("bookings_{:020}.wtj", first_sequence);
+      }
+
+   /// segment files of the directory with the first sequence from the name, ordered by the sequence
+   std::vector<std::pair<std::uint64_t, std::filesystem::path>> list_segments(std::filesystem::path const& directory) {
+      std::vector<std::pair<std::uint64_t, std::filesystem::path>> segments;
+      for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+         auto const name = entry.path().filename().string();
+         if (!entry.is_regular_file() || !name.starts_with("bookings_") || entry.path().extension() != ".wtj") continue;
+         auto const digits = std::string_view { name }.substr(9, 20);
+         std::uint64_t first_sequence = 0;
+         if (auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), first_sequence); ec == std::errc { })
+            segments.emplace_back(first_sequence, entry.path());
+         }
+      std::ranges::sort(segments);
+      return segments;
+      }
+
+   TimeBookingEvent decode(JournalRecord const& record) {
+      return { .personId   = record.personId,
+               .timepoint  = booking_time_ty { std::chrono::milliseconds { record.timepoint } },
+               .kind       = static_cast<Organization::EBookingKind>(record.kind),
+               .terminalId = record.terminalId };
+      }
+
+   JournalRecord encode_absence(AbsenceChange const& change) {
+      auto const& entry = change.entry;
+      JournalAbsenceRecord const record { .sequence  = 0,
+                                          .absenceId = entry.absenceId,
+                                          .personId  = entry.personId,
+                                          .from      = static_cast<std::int32_t>(entry.from.time_since_epoch().count()),
+                                          .length    = static_cast<std::uint16_t>(std::clamp<std::int64_t>((entry.to - entry.from).count(), 0,
+                                                                                                          BookingJournal::MaxAbsenceDays - 1)),
+                                          .type      = static_cast<std::uint8_t>(change.type),
+                                          .flags     = static_cast<std::uint8_t>((static_cast<std::uint8_t>(entry.kind) & ~AbsenceApprovedFlag) |
+                                                                                 (entry.approved ? AbsenceApprovedFlag : 0)),
+                                          .checksum  = 0 };
+      return std::bit_cast<JournalRecord>(record);
+      }
+
+   AbsenceChange decode_absence(JournalRecord const& slot) {
+      auto const record = std::bit_cast<JournalAbsenceRecord>(slot);
+      std::chrono::sys_days const from { std::chrono::days { record.from } };
+      return { .type  = static_cast<EJournalRecord>(record.type),
+               .entry = { .absenceId = record.absenceId, .personId = record.personId, .from = from,
+                          .to = from + std::chrono::days { record.length },
+                          .kind = static_cast<Organization::EAbsenceKind>(record.flags & ~AbsenceApprovedFlag),
+                          .approved = (record.flags & AbsenceApprovedFlag) != 0 } };
+      }
+
+   }
+
+BookingJournal::BookingJournal(Config config) : config_(std::move(config)) {
+   config_.segment_records = std::max<std::uint32_t>(config_.segment_records, 2);
+   config_.replay_block    = std::max<std::size_t>(config_.replay_block, 1);
+   }
+
+BookingJournal::~BookingJournal() {
+      {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+      }
+   written_cv_.notify_one();
+   if (flusher_.joinable()) flusher_.join();
+   log_trace<2>("[BookingJournal {}] journal closed, {} records durable with {} group commits.", ::getTimeStamp(),
+                durable_sequence_, group_commits_);
+   }
+
+BookingJournal::RecoveryStatistics BookingJournal::open(consumer_ty const& consumer, std::uint64_t after_sequence, absences_ty const& absences) {
+   auto const start = std::chrono::steady_clock::now();
+   RecoveryStatistics stats;
+
+   std::filesystem::create_directories(config_.directory);
+   auto const files = list_segments(config_.directory);
+   if (!files.empty() && files.front().first > after_sequence + 1)
+      throw std::runtime_error(std::format("[BookingJournal {}] journal starts with {}, bookings after {} are missing.", ::getTimeStamp(),
+                                           files.front().first, after_sequence));
+   next_sequence_ = files.empty() ? after_sequence + 1 : files.front().first;
+
+   std::vector<TimeBookingEvent> block;
+   block.reserve(config_.replay_block);
+
+   for (std::size_t file = 0; file < files.size(); ++file) {
+      bool const last = file + 1 == files.size();
+      // segments which are completely contained in the snapshot are skipped without reading them
+      if (!last && files[file + 1].first <= after_sequence + 1) {
+         next_sequence_ = files[file + 1].first;
+         continue;
+         }
+
+      auto segment = std::make_shared<Segment>();
+      segment->path = files[file].second;
+      if (segment->map.map(ACE_TEXT_CHAR_TO_TCHAR(segment->path.string().c_str()), static_cast<size_t>(-1), O_RDWR,
+                           ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_SHARED) == -1)
+         throw std::runtime_error(std::format("[BookingJournal {}] segment {} can't be opened.", ::getTimeStamp(), segment->path.string()));
+
+      JournalHeader header;
+      if (segment->map.size() < sizeof(JournalHeader))
+         throw std::runtime_error(std::format("[BookingJournal {}] segment {} is too small.", ::getTimeStamp(), segment->path.string()));
+      std::memcpy(&header, segment->map.addr(), sizeof(JournalHeader));
+      if (std::memcmp(header.magic, JournalMagic, sizeof(JournalMagic)) != 0 || header.checksum != checksum(header) ||
+          header.record_size != sizeof(JournalRecord) || segment->map.size() < std::size_t { header.capacity } * sizeof(JournalRecord))
+         throw std::runtime_error(std::format("[BookingJournal {}] segment {} has an invalid header.", ::getTimeStamp(), segment->path.string()));
+      if (header.first_sequence != next_sequence_)
+         throw std::runtime_error(std::format("[BookingJournal {}] segment {} starts with {}, expected {}.", ::getTimeStamp(),
+                                              segment->path.string(), header.first_sequence, next_sequence_));
+      segment->first_sequence = header.first_sequence;
+      segment->capacity       = header.capacity;
+
+      // sequential scan of the mapping behind the snapshot, a record is valid with the expected sequence and checksum
+      auto* slots = segment->slots();
+      std::size_t slot = 1;
+      if (after_sequence >= next_sequence_) {
+         slot = std::min<std::size_t>(after_sequence + 1 - next_sequence_ + 1, segment->capacity);
+         next_sequence_ += slot - 1;
+         }
+      std::size_t const first_slot = slot;
+      for (; slot < segment->capacity; ++slot) {
+         auto const& record = slots[slot];
+         if (record.sequence != next_sequence_ || record.checksum != checksum(record)) break;
+         ++next_sequence_;
+         if (static_cast<EJournalRecord>(record.type) != EJournalRecord::Booking) {
+            // the calendar and the booking log are independent, a change is applied without the block of the bookings
+            if (absences) absences(decode_absence(record));
+            ++stats.absences;
+            continue;
+            }
+         block.emplace_back(decode(record));
+         if (block.size() == config_.replay_block) {
+            consumer(block);
+            block.clear();
+            }
+         }
+      stats.records += slot - first_slot;
+      ++stats.segments;
+
+      if (slot < segment->capacity && !last)
+         throw std::runtime_error(std::format("[BookingJournal {}] damaged record {} in segment {}.", ::getTimeStamp(),
+                                              next_sequence_, segment->path.string()));
+      if (last) {
+         // clear the remainder behind the last valid record, so no stale record becomes valid later
+         static constexpr JournalRecord empty { };
+         std::size_t cleared = 0;
+         for (std::size_t rest = slot; rest < segment->capacity; ++rest) {
+            if (std::memcmp(&slots[rest], &empty, sizeof(JournalRecord)) != 0) {
+               slots[rest] = empty;
+               ++cleared;
+               }
+            }
+         if (cleared > 0) {
+            stats.torn_tail = true;
+            segment->map.sync();
+            log_error("[BookingJournal {}] {} damaged records cleared at the end of segment {}.", ::getTimeStamp(),
+                      cleared, segment->path.string());
+            }
+         segment->synced_slots = slot;
+         current_    = segment;
+         used_slots_ = slot;
+         }
+      }
+   if (!block.empty()) consumer(block);
+
+   if (!current_) {
+      current_    = create_segment(next_sequence_);
+      used_slots_ = 1;
+      }
+   written_sequence_ = durable_sequence_ = next_sequence_ - 1;
+   flusher_ = std::thread(&BookingJournal::flush_loop, this);
+
+   stats.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+   log_trace<2>("[BookingJournal {}] {} bookings and {} changes of absences of {} segments replayed in {}.", ::getTimeStamp(),
+                stats.records - stats.absences, stats.absences, stats.segments, stats.duration);
+   return stats;
+   }
+
+std::shared_ptr<BookingJournal::Segment> BookingJournal::create_segment(std::uint64_t first_sequence) {
+   auto segment = std::make_shared<Segment>();
+   segment->path           = config_.directory / segment_name(first_sequence);
+   segment->first_sequence = first_sequence;
+   segment->capacity       = config_.segment_records;
+
+   // the mapping extends the new file to the full size, the unused slots are zero
+   std::size_t const bytes = std::size_t { segment->capacity } * sizeof(JournalRecord);
+   if (segment->map.map(ACE_TEXT_CHAR_TO_TCHAR(segment->path.string().c_str()), bytes, O_RDWR | O_CREAT,
+                        ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_SHARED) == -1)
+      throw std::runtime_error(std::format("[BookingJournal {}] segment {} can't be created.", ::getTimeStamp(), segment->path.string()));
+
+   JournalHeader header { };
+   std::memcpy(header.magic, JournalMagic, sizeof(JournalMagic));
+   header.first_sequence = first_sequence;
+   header.capacity       = segment->capacity;
+   header.record_size    = sizeof(JournalRecord);
+   header.checksum       = checksum(header);
+   std::memcpy(segment->map.addr(), &header, sizeof(JournalHeader));
+   if (segment->map.sync(sizeof(JournalHeader)) == -1 || ACE_OS::fsync(segment->map.handle()) == -1 || !SyncDirectory(config_.directory))
+      throw std::runtime_error(std::format("[BookingJournal {}] segment {} can't be synced.", ::getTimeStamp(), segment->path.string()));
+   segment->synced_slots = 1;
+
+   log_trace<4>("[BookingJournal {}] segment {} created.", ::getTimeStamp(), segment->path.string());
+   return segment;
+   }
+
+void BookingJournal::write_locked(TimeBookingEvent const& event) {
+   write_locked(JournalRecord { .sequence   = 0,
+                                .timepoint  = event.timepoint.time_since_epoch().count(),
+                                .personId   = event.personId,
+                                .terminalId = event.terminalId,
+                                .kind       = static_cast<std::uint16_t>(event.kind),
+                                .type       = static_cast<std::uint8_t>(EJournalRecord::Booking),
+                                .reserved   = 0,
+                                .checksum   = 0 });
+   }
+
+void BookingJournal::write_locked(JournalRecord record) {
+   if (used_slots_ == current_->capacity) {
+      std::shared_ptr<Segment> next;
+      try {
+         next = create_segment(next_sequence_);
+         }
+      catch (std::exception const& ex) {
+         // like a failed sync, no further booking is confirmed and the waiting appends are released
+         failed_ = true;
+         log_error("[BookingJournal {}] rotation of the journal failed, no further bookings are confirmed: {}", ::getTimeStamp(), ex.what());
+         durable_cv_.notify_all();
+         throw;
+         }
+      rotated_.emplace_back(std::exchange(current_, std::move(next)));
+      used_slots_ = 1;
+      ++rotations_;
+      }
+
+   record.sequence = next_sequence_;
+   record.checksum = checksum(record);
+   current_->slots()[used_slots_++] = record;
+   written_sequence_ = next_sequence_++;
+   }
+
+void BookingJournal::wait_durable(std::unique_lock<std::mutex>& lock, std::uint64_t sequence) {
+   written_cv_.notify_one();
+   durable_cv_.wait(lock, [this, sequence] { return durable_sequence_ >= sequence || failed_; });
+   if (durable_sequence_ < sequence)
+      throw std::runtime_error(std::format("[BookingJournal {}] booking {} couldn't be synced.", ::getTimeStamp(), sequence));
+   }
+
+std::uint64_t BookingJournal::append(TimeBookingEvent const& event) {
+   std::unique_lock lock(mutex_);
+   if (!flusher_.joinable() || failed_)
+      throw std::runtime_error(std::format("[BookingJournal {}] journal isn't available.", ::getTimeStamp()));
+   write_locked(event);
+   auto const sequence = written_sequence_;
+   wait_durable(lock, sequence);
+   return sequence;
+   }
+
+std::uint64_t BookingJournal::append(std::span<TimeBookingEvent const> events) {
+   if (events.empty()) return 0;
+   std::unique_lock lock(mutex_);
+   if (!flusher_.joinable() || failed_)
+      throw std::runtime_error(std::format("[BookingJournal {}] journal isn't available.", ::getTimeStamp()));
+   for (auto const& event : events) write_locked(event);
+   auto const sequence = written_sequence_;
+   wait_durable(lock, sequence);
+   return sequence;
+   }
+
+std::uint64_t BookingJournal::append(AbsenceChange const& change) {
+   return append(std::span(&change, 1));
+   }
+
+std::uint64_t BookingJournal::append(std::span<AbsenceChange const> changes) {
+   if (changes.empty()) return 0;
+   std::unique_lock lock(mutex_);
+   if (!flusher_.joinable() || failed_)
+      throw std::runtime_error(std::format("[BookingJournal {}] journal isn't available.", ::getTimeStamp()));
+   for (auto const& change : changes) write_locked(encode_absence(change));
+   auto const sequence = written_sequence_;
+   wait_durable(lock, sequence);
+   return sequence;
+   }
+
+bool BookingJournal::sync_segment(Segment& segment, std::size_t used_slots) {
+   if (used_slots <= segment.synced_slots) return true;
+   // msync needs an address at a page boundary
+   std::size_t const page = static_cast<std::size_t>(ACE_OS::getpagesize());
+   std::size_t const from = segment.synced_slots * sizeof(JournalRecord) / page * page;
+   std::size_t const to   = used_slots * sizeof(JournalRecord);
+   if (ACE_OS::msync(static_cast<char*>(segment.map.addr()) + from, to - from, MS_SYNC) == -1) return false;
+   segment.synced_slots = used_slots;
+   return true;
+   }
+
+void BookingJournal::flush_loop() {
+   std::unique_lock lock(mutex_);
+   while (true) {
+      written_cv_.wait(lock, [this] { return stop_ || written_sequence_ > durable_sequence_; });
+      if (written_sequence_ == durable_sequence_) break;   // stop_ without outstanding records
+
+      if (config_.commit_window.count() > 0 && !stop_) {
+         lock.unlock();
+         std::this_thread::sleep_for(config_.commit_window);
+         lock.lock();
+         }
+
+      // all records written until now are synced with one group commit
+      auto const target  = written_sequence_;
+      auto const rotated = std::exchange(rotated_, { });
+      auto const current = current_;
+      auto const used    = used_slots_;
+      lock.unlock();
+
+      bool synced = std::ranges::all_of(rotated, [](auto const& segment) { return sync_segment(*segment, segment->capacity); });
+      synced = synced && sync_segment(*current, used);
+
+      lock.lock();
+      if (!synced) {
+         failed_ = true;
+         log_error("[BookingJournal {}] sync of the journal failed, no further bookings are confirmed.", ::getTimeStamp());
+         durable_cv_.notify_all();
+         break;
+         }
+      durable_sequence_ = target;
+      ++group_commits_;
+      durable_cv_.notify_all();
+      }
+   }
+
+std::size_t BookingJournal::compact(std::uint64_t covered_sequence) {
+   auto const files = list_segments(config_.directory);
+   std::size_t removed = 0;
+   // the last file is the current segment and is never removed
+   for (std::size_t file = 0; file + 1 < files.size() && files[file + 1].first - 1 <= covered_sequence; ++file) {
+      std::error_code error;
+      if (!std::filesystem::remove(files[file].second, error) || error) {
+         log_error("[BookingJournal {}] segment {} can't be removed: {}", ::getTimeStamp(), files[file].second.string(), error.message());
+         break;
+         }
+      ++removed;
+      }
+   if (removed > 0)
+      log_trace<4>("[BookingJournal {}] {} segments up to booking {} removed.", ::getTimeStamp(), removed, covered_sequence);
+   return removed;
+   }
+
+BookingJournal::Statistics BookingJournal::statistics() {
+   std::lock_guard lock(mutex_);
+   return { .written = written_sequence_, .durable = durable_sequence_, .group_commits = group_commits_, .rotations = rotations_ };
+   }
+
+bool BookingJournal::healthy() {
+   std::lock_guard lock(mutex_);
+   return !failed_;
+   }
+
+void AbsenceRecovery::restore(std::vector<AbsenceEntry> entries, std::uint64_t next_id) {
+   entries_.clear();
+   for (auto& entry : entries) entries_.emplace(entry.absenceId, std::move(entry));
+   next_id_ = std::max(next_id_, next_id);
+   }
+
+void AbsenceRecovery::apply(AbsenceChange const& change) {
+   switch (change.type) {
+      case EJournalRecord::AbsenceAdded:
+         entries_.try_emplace(change.entry.absenceId, change.entry);
+         next_id_ = std::max(next_id_, change.entry.absenceId + 1);
+         break;
+      case EJournalRecord::AbsenceRemoved:
+         entries_.erase(change.entry.absenceId);
+         break;
+      case EJournalRecord::AbsenceApproved:
+         if (auto it = entries_.find(change.entry.absenceId); it != entries_.end()) it->second.approved = change.entry.approved;
+         break;
+      default:
+         break;
+      }
+   }
+
+std::vector<AbsenceEntry> AbsenceRecovery::entries() const {
+   std::vector<AbsenceEntry> result;
+   result.reserve(entries_.size());
+   for (auto const& entry : entries_ | std::views::values) result.emplace_back(entry);
+   return result;
+   }
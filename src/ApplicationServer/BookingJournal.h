@@ -0,0 +1,280 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Durable append-only journal of the time bookings in memory-mapped segment files.
+
+  \details This header declares the class `BookingJournal`. Every accepted booking is written as
+           fixed size record with a sequence number and a CRC-32 checksum into a memory-mapped
+           segment file. A booking is confirmed to the terminal only when its record is on the disk.
+           The sync is done by one flusher thread for all records written since the last sync
+           (group commit), so many concurrent bookings share one `msync`.
+
+  \details A full segment is synced and closed, the next records go into a new segment. At startup
+           all segments are read in the order of the sequence numbers and passed in large blocks
+           to a consumer (e.g. \ref BookingLog::restore). A torn record at the end of the last
+           segment, e.g. after a crash, ends the replay and the remainder of the segment is cleared.
+
+  \version 1.0
+  \date    08.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see BookingLog.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "BookingLog.h"
+#include "AbsenceCalendar.h"
+
+#include <ace/Mem_Map.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <span>
+#include <functional>
+#include <filesystem>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+/// \brief content of a journal record, a booking or a change of the absence calendar
+enum class EJournalRecord : std::uint8_t {
+   Booking         = 0,  ///< JournalRecord, also all records of older journals
+   AbsenceAdded    = 1,  ///< JournalAbsenceRecord with the whole absence
+   AbsenceRemoved  = 2,  ///< JournalAbsenceRecord, only the id is used
+   AbsenceApproved = 3   ///< JournalAbsenceRecord, the id and the approval are used
+   };
+
+/// \brief record of one booking in a journal segment, written in the native byte order
+struct JournalRecord {
+   std::uint64_t sequence;     ///< sequence number of the booking, starts with 1 (0 marks an unused slot)
+   std::int64_t  timepoint;    ///< milliseconds since the epoch
+   std::int32_t  personId;     ///< id of the employee
+   std::int32_t  terminalId;   ///< id of the terminal
+   std::uint16_t kind;         ///< Organization::EBookingKind
+   std::uint8_t  type;         ///< EJournalRecord::Booking
+   std::uint8_t  reserved;     ///< always 0
+   std::uint32_t checksum;     ///< CRC-32 of the previous fields
+   };
+static_assert(sizeof(JournalRecord) == 32, "journal records must have a fixed size of 32 bytes");
+
+/// \brief record of a change of the absence calendar, in the same slots and with the same checksum as the bookings
+struct JournalAbsenceRecord {
+   std::uint64_t sequence;     ///< sequence number of the change
+   std::uint64_t absenceId;    ///< id of the absence
+   std::int32_t  personId;     ///< id of the employee
+   std::int32_t  from;         ///< first day of the absence, days since the epoch
+   std::uint16_t length;       ///< last day - first day
+   std::uint8_t  type;         ///< EJournalRecord of the change
+   std::uint8_t  flags;        ///< Organization::EAbsenceKind in the bits 0 - 6, approved in bit 7
+   std::uint32_t checksum;     ///< CRC-32 of the previous fields
+   };
+static_assert(sizeof(JournalAbsenceRecord) == sizeof(JournalRecord) && offsetof(JournalAbsenceRecord, type) == offsetof(JournalRecord, type) &&
+              offsetof(JournalAbsenceRecord, checksum) == offsetof(JournalRecord, checksum), "absence records use the slots of the bookings");
+
+/// \brief change of the absence calendar, written to the journal like a booking
+struct AbsenceChange {
+   EJournalRecord type;    ///< AbsenceAdded, AbsenceRemoved or AbsenceApproved
+   AbsenceEntry   entry;   ///< the absence, for AbsenceRemoved and AbsenceApproved only the id and the approval are used
+   };
+
+/**
+  \brief Collects the absences of a snapshot and the replayed changes of the journal at the start.
+  \details A change of the `AbsenceCalendar` copies its whole version, the collected absences are
+           loaded into the calendar once after the replay instead.
+ */
+class AbsenceRecovery {
+private:
+   std::map<std::uint64_t, AbsenceEntry> entries_;      ///< absence id → absence
+   std::uint64_t                         next_id_ = 1;  ///< lowest id for new absences
+
+public:
+   /// \brief takes the absences and the next absence id of a snapshot
+   void restore(std::vector<AbsenceEntry> entries, std::uint64_t next_id);
+
+   /// \brief applies a replayed change, an addition which exists already is ignored like in the calendar
+   void apply(AbsenceChange const& change);
+
+   /// \brief the collected absences, ordered by the id
+   std::vector<AbsenceEntry> entries() const;
+
+   /// \brief lowest id for new absences, above all replayed ids
+   std::uint64_t next_id() const { return next_id_; }
+   };
+
+/// \brief header in the first slot of a journal segment
+struct JournalHeader {
+   char          magic[8];        ///< "WTRJRNL1"
+   std::uint64_t first_sequence;  ///< sequence number of the first record of the segment
+   std::uint32_t capacity;        ///< number of slots of the segment, including the header
+   std::uint32_t record_size;     ///< sizeof(JournalRecord)
+   std::uint32_t reserved;        ///< always 0
+   std::uint32_t checksum;        ///< CRC-32 of the previous fields
+   };
+static_assert(sizeof(JournalHeader) == sizeof(JournalRecord), "the header uses the first slot of a segment");
+
+/**
+  \brief Journal of the bookings with memory-mapped segments and group commit.
+ */
+class BookingJournal {
+public:
+   /// \brief consumer of the replayed bookings, called with blocks of bookings in the order of the journal
+   using consumer_ty = std::function<void (std::span<TimeBookingEvent const>)>;
+   /// \brief consumer of the replayed changes of the absence calendar, called for each change in the order of the journal
+   using absences_ty = std::function<void (AbsenceChange const&)>;
+
+   /// \brief longest absence in days, limited by the length field of the absence record
+   static constexpr std::int64_t MaxAbsenceDays = std::int64_t { std::numeric_limits<std::uint16_t>::max() } + 1;
+
+   /// \brief configuration of the journal
+   struct Config {
+      std::filesystem::path     directory;                                        ///< directory of the segment files
+      std::uint32_t             segment_records = 1u << 20;                       ///< slots of a segment (32 MiB with the default)
+      std::chrono::microseconds commit_window   = std::chrono::microseconds { 0 }; ///< additional time the flusher collects records before a sync
+      std::size_t               replay_block    = 64 * 1'024;                     ///< bookings passed with one call of the consumer
+      };
+
+   /// \brief result of the replay at startup
+   struct RecoveryStatistics {
+      std::uint64_t             records   = 0;  ///< replayed records, bookings and changes of the absences
+      std::uint64_t             absences  = 0;  ///< replayed changes of the absence calendar
+      std::size_t               segments  = 0;  ///< read segments
+      bool                      torn_tail = false; ///< the last segment ended with a damaged record
+      std::chrono::milliseconds duration  = {}; ///< duration of the replay
+      };
+
+   /// \brief counters of the journal
+   struct Statistics {
+      std::uint64_t written       = 0; ///< highest sequence number written
+      std::uint64_t durable       = 0; ///< highest sequence number on the disk
+      std::uint64_t group_commits = 0; ///< syncs of the flusher
+      std::uint64_t rotations     = 0; ///< segments started since the start
+      };
+
+private:
+   /// \brief memory-mapped segment file
+   struct Segment {
+      ACE_Mem_Map           map;
+      std::filesystem::path path;
+      std::uint64_t         first_sequence = 0;
+      std::uint32_t         capacity       = 0;
+      std::size_t           synced_slots   = 0; ///< slots already synced, only used by the flusher
+
+      JournalRecord* slots() { return static_cast<JournalRecord*>(map.addr()); }
+      };
+
+   Config                                config_;
+   std::mutex                            mutex_;
+   std::condition_variable               written_cv_;  ///< signals the flusher that records wait for the sync
+   std::condition_variable               durable_cv_;  ///< signals the writers that their records are on the disk
+   std::shared_ptr<Segment>              current_;
+   std::vector<std::shared_ptr<Segment>> rotated_;     ///< full segments which still need the final sync
+   std::size_t                           used_slots_       = 0;
+   std::uint64_t                         next_sequence_    = 1;
+   std::uint64_t                         written_sequence_ = 0;
+   std::uint64_t                         durable_sequence_ = 0;
+   std::uint64_t                         group_commits_    = 0;
+   std::uint64_t                         rotations_        = 0;
+   bool                                  stop_             = false;
+   bool                                  failed_           = false; ///< a sync failed, no further bookings are confirmed
+   std::thread                           flusher_;
+
+public:
+   BookingJournal() = delete;
+   BookingJournal(BookingJournal const&) = delete;
+   BookingJournal& operator = (BookingJournal const&) = delete;
+
+   explicit BookingJournal(Config config);
+
+   /// \brief syncs the outstanding records and stops the flusher
+   ~BookingJournal();
+
+   /**
+     \brief Replays the segments of the directory and prepares the journal for new records.
+     \param consumer receives the bookings of the journal in blocks, in the order of the sequence numbers
+     \param after_sequence bookings and changes up to this sequence are already restored (e.g. from a snapshot) and skipped
+     \param absences receives the changes of the absence calendar, without a consumer they are skipped
+     \return counters and duration of the replay
+     \throws std::runtime_error if a segment can't be opened, a segment in the middle of the journal is damaged
+             or the journal doesn't continue after_sequence
+    */
+   RecoveryStatistics open(consumer_ty const& consumer, std::uint64_t after_sequence = 0, absences_ty const& absences = { });
+
+   /**
+     \brief Removes the segment files whose bookings are all contained in a snapshot.
+     \param covered_sequence highest sequence of the bookings in the written snapshot
+     \return number of removed segments
+    */
+   std::size_t compact(std::uint64_t covered_sequence);
+
+   /**
+     \brief Writes a booking and waits until it is on the disk.
+     \return sequence number of the booking
+     \throws std::runtime_error if the journal isn't open, a new segment can't be created or the sync failed
+    */
+   std::uint64_t append(TimeBookingEvent const& event);
+
+   /**
+     \brief Writes several bookings and waits once until all of them are on the disk.
+     \return sequence number of the last booking (0 for an empty span)
+     \throws std::runtime_error if the journal isn't open, a new segment can't be created or the sync failed
+    */
+   std::uint64_t append(std::span<TimeBookingEvent const> events);
+
+   /**
+     \brief Writes a change of the absence calendar and waits until it is on the disk.
+     \pre the absence is at most MaxAbsenceDays long
+     \return sequence number of the change
+     \throws std::runtime_error if the journal isn't open, a new segment can't be created or the sync failed
+    */
+   std::uint64_t append(AbsenceChange const& change);
+
+   /**
+     \brief Writes several changes of the absence calendar and waits once until all of them are on the disk.
+     \return sequence number of the last change (0 for an empty span)
+     \throws std::runtime_error like the other appends
+    */
+   std::uint64_t append(std::span<AbsenceChange const> changes);
+
+   /// \brief current counters of the journal
+   Statistics statistics();
+
+   /// \brief false after a failed sync, the journal confirms no further bookings
+   bool healthy();
+
+private:
+   /// \brief syncs the slots of a segment written since the last sync, called by the flusher
+   static bool sync_segment(Segment& segment, std::size_t used_slots);
+
+   std::shared_ptr<Segment> create_segment(std::uint64_t first_sequence);
+   void write_locked(TimeBookingEvent const& event);
+   /// \brief writes the record with the next sequence number, starts a new segment when the current one is full
+   void write_locked(JournalRecord record);
+   void wait_durable(std::unique_lock<std::mutex>& lock, std::uint64_t sequence);
+   void flush_loop();
+   };
@@ -0,0 +1,196 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the append-only log of the time bookings
+
+  \details A batch of bookings is ordered by the shard of the employee (stable, so that the bookings
+           of an employee keep the order of the request), then the lock of each touched shard is
+           taken once for all its bookings.
+
+  \version 1.0
+  \date    06.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BookingLog.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <iterator>
+
+BookingLog::BookingLog(Config const& config) : config_(config) {
+   config_.shards = std::max<std::size_t>(config_.shards, 1);
+   shards_.reserve(config_.shards);
+   for (std::size_t i = 0; i < config_.shards; ++i) shards_.emplace_back(std::make_unique<Shard>());
+   log_trace<4>("[BookingLog {}] Booking log created with {} shards.", ::getTimeStamp(), config_.shards);
+   }
+
+bool BookingLog::is_valid(TimeBookingEvent const& event, booking_time_ty now) const {
+   if (event.kind < Organization::COME || event.kind > Organization::BREAK_END) return false;
+   return event.timepoint <= now + config_.max_future && event.timepoint >= now - config_.max_past;
+   }
+
+bool BookingLog::is_duplicate(EmployeeLog const& log, TimeBookingEvent const& event) {
+   // a repeated booking of a terminal (lost reply, offline buffer sent again) has the same time point and kind
+   return std::ranges::binary_search(log.recent, duplicate_key(event.timepoint, event.kind));
+   }
+
+Organization::EBookingResult BookingLog::append_locked(Shard& shard, TimeBookingEvent const& event, booking_time_ty oldest) {
+   auto& log = shard.employees[event.personId];
+   // bookings older than the window are rejected by the validation, their keys are no longer needed
+   if (oldest != booking_time_ty::min())
+      log.recent.erase(log.recent.begin(), std::ranges::lower_bound(log.recent, duplicate_key(oldest, Organization::COME)));
+
+   auto const key = duplicate_key(event.timepoint, event.kind);
+   auto const pos = std::ranges::lower_bound(log.recent, key);
+   if (pos != log.recent.end() && *pos == key) {
+      ++duplicates_;
+      return Organization::BOOKING_DUPLICATE;
+      }
+   log.recent.insert(pos, key);
+
+   if (log.segments.empty() || log.segments.back()->size == SegmentSize) {
+      log.segments.emplace_back(std::make_unique<Segment>());
+      ++segments_;
+      }
+   auto& segment = *log.segments.back();
+   segment.events[segment.size++] = event;
+   ++log.count;
+   ++accepted_;
+   return Organization::BOOKING_ACCEPTED;
+   }
+
+Organization::EBookingResult BookingLog::append(TimeBookingEvent const& event, booking_time_ty now) {
+   if (!is_valid(event, now)) [[unlikely]] {
+      ++invalid_;
+      return Organization::BOOKING_INVALID;
+      }
+   Shard& current = shard(event.personId);
+   std::lock_guard lock(current.mutex);
+   return append_locked(current, event, oldest_kept(now));
+   }
+
+Organization::EBookingResult BookingLog::check(TimeBookingEvent const& event, booking_time_ty now) {
+   if (!is_valid(event, now)) [[unlikely]] {
+      ++invalid_;
+      return Organization::BOOKING_INVALID;
+      }
+   Shard& current = shard(event.personId);
+   std::lock_guard lock(current.mutex);
+   if (auto it = current.employees.find(event.personId); it != current.employees.end() && is_duplicate(it->second, event)) {
+      ++duplicates_;
+      return Organization::BOOKING_DUPLICATE;
+      }
+   return Organization::BOOKING_ACCEPTED;
+   }
+
+void BookingLog::append(std::span<TimeBookingEvent const> events, std::span<Organization::EBookingResult> results, booking_time_ty now) {
+   std::vector<std::size_t> order;
+   order.reserve(events.size());
+   for (std::size_t i = 0; i < events.size(); ++i) {
+      if (is_valid(events[i], now)) order.emplace_back(i);
+      else {
+         results[i] = Organization::BOOKING_INVALID;
+         ++invalid_;
+         }
+      }
+
+   append_grouped(events, order, results, oldest_kept(now));
+   }
+
+void BookingLog::restore(std::span<TimeBookingEvent const> events) {
+   std::vector<std::size_t> order(events.size());
+   std::iota(order.begin(), order.end(), std::size_t { 0 });
+   append_grouped(events, order, { }, booking_time_ty::min());
+   log_trace<5>("[BookingLog {}] {} bookings restored.", ::getTimeStamp(), events.size());
+   }
+
+void BookingLog::append_grouped(std::span<TimeBookingEvent const> events, std::vector<std::size_t>& order,
+                                std::span<Organization::EBookingResult> results, booking_time_ty oldest) {
+   auto shard_of = [this, &events](std::size_t i) { return static_cast<std::uint32_t>(events[i].personId) % shards_.size(); };
+   std::ranges::stable_sort(order, {}, shard_of);
+
+   for (auto first = order.begin(); first != order.end(); ) {
+      auto const index = shard_of(*first);
+      auto last = std::find_if(first, order.end(), [&](std::size_t i) { return shard_of(i) != index; });
+      Shard& current = *shards_[index];
+         {
+         std::lock_guard lock(current.mutex);
+         for (auto it = first; it != last; ++it) {
+            auto const result = append_locked(current, events[*it], oldest);
+            if (!results.empty()) results[*it] = result;
+            }
+         }
+      first = last;
+      }
+   }
+
+std::vector<TimeBookingEvent> BookingLog::events(CORBA::Long personId) const {
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   std::vector<TimeBookingEvent> result;
+   if (auto it = current.employees.find(personId); it != current.employees.end()) {
+      result.reserve(it->second.count);
+      for (auto const& segment : it->second.segments)
+         result.insert(result.end(), segment->events.begin(), segment->events.begin() + segment->size);
+      }
+   return result;
+   }
+
+std::vector<TimeBookingEvent> BookingLog::events(CORBA::Long personId, booking_time_ty from, booking_time_ty to) const {
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   std::vector<TimeBookingEvent> result;
+   if (auto it = current.employees.find(personId); it != current.employees.end()) {
+      for (auto const& segment : it->second.segments)
+         std::ranges::copy_if(std::span(segment->events).first(segment->size), std::back_inserter(result),
+                              [from, to](TimeBookingEvent const& event) { return event.timepoint >= from && event.timepoint < to; });
+      }
+   return result;
+   }
+
+std::vector<TimeBookingEvent> BookingLog::snapshot() const {
+   std::vector<TimeBookingEvent> result;
+   result.reserve(accepted_);
+   for (auto const& current : shards_) {
+      std::lock_guard lock(current->mutex);
+      for (auto const& [personId, log] : current->employees)
+         for (auto const& segment : log.segments)
+            result.insert(result.end(), segment->events.begin(), segment->events.begin() + segment->size);
+      }
+   return result;
+   }
+
+std::size_t BookingLog::count(CORBA::Long personId) const {
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   auto it = current.employees.find(personId);
+   return it != current.employees.end() ? it->second.count : 0;
+   }
+
+BookingLog::Statistics BookingLog::statistics() const {
+   return { .accepted = accepted_, .duplicates = duplicates_, .invalid = invalid_, .segments = segments_ };
+   }
@@ -0,0 +1,208 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Append-only in-memory log of the time bookings, segmented for each employee.
+
+  \details This header declares the class `BookingLog`. The bookings of an employee are appended
+           in the order of arrival to a chain of fixed size segments, a segment never moves after
+           it was created. The employees are distributed over independent shards with an own
+           mutex, so bookings of different employees at the shift change don't wait for a global
+           lock. The validation of the time point happens before the lock, the duplicate check and
+           the append inside the lock of the shard of the employee. The duplicate check covers all
+           bookings of an employee in the accepted window of the time points, so a terminal can send
+           its whole offline buffer again after a reconnect.
+
+  \version 1.0
+  \date    06.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "OrganizationC.h"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <span>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// \brief time point of a booking, milliseconds since the epoch like Basics::TimePoint
+using booking_time_ty = std::chrono::sys_time<std::chrono::milliseconds>;
+
+/// \brief one booking in the log
+struct TimeBookingEvent {
+   CORBA::Long                personId   = -1;
+   booking_time_ty            timepoint  = {};
+   Organization::EBookingKind kind       = Organization::COME;
+   CORBA::Long                terminalId = 0;
+   };
+
+/**
+  \brief Sharded append-only log of the time bookings.
+ */
+class BookingLog {
+public:
+   /// \brief number of bookings in one segment of an employee (about a week of bookings)
+   static constexpr std::size_t SegmentSize = 32;
+
+   /// \brief window for the time points accepted by the validation
+   struct Config {
+      std::size_t               shards      = 64;                            ///< number of independent shards
+      std::chrono::milliseconds max_future  = std::chrono::minutes { 5 };    ///< tolerated clock difference of a terminal
+      std::chrono::milliseconds max_past    = std::chrono::days { 31 };      ///< oldest booking accepted (offline buffer of a terminal)
+      };
+
+   /// \brief counters of the log
+   struct Statistics {
+      std::uint64_t accepted   = 0; ///< bookings appended to the log
+      std::uint64_t duplicates = 0; ///< bookings rejected as repetition
+      std::uint64_t invalid    = 0; ///< bookings rejected by the validation
+      std::uint64_t segments   = 0; ///< segments created
+      };
+
+private:
+   /// \brief fixed size block of bookings, filled from the front
+   struct Segment {
+      std::array<TimeBookingEvent, SegmentSize> events;
+      std::size_t                               size = 0;
+      };
+
+   /// \brief chain of segments of one employee
+   struct EmployeeLog {
+      std::vector<std::unique_ptr<Segment>> segments;
+      std::size_t                           count = 0;
+      std::vector<std::int64_t>             recent;  ///< sorted keys (time point, kind) of the bookings in the accepted window
+      };
+
+   struct alignas(64) Shard {
+      std::mutex                                   mutex;
+      std::unordered_map<CORBA::Long, EmployeeLog> employees;
+      };
+
+   Config                              config_;
+   std::vector<std::unique_ptr<Shard>> shards_;
+
+   std::atomic<std::uint64_t>          accepted_   = 0;
+   std::atomic<std::uint64_t>          duplicates_ = 0;
+   std::atomic<std::uint64_t>          invalid_    = 0;
+   std::atomic<std::uint64_t>          segments_   = 0;
+
+public:
+   BookingLog(BookingLog const&) = delete;
+   BookingLog& operator = (BookingLog const&) = delete;
+
+   BookingLog() : BookingLog(Config { }) {}
+   explicit BookingLog(Config const& config);
+
+   /**
+     \brief Validates and appends one booking.
+     \param event booking, the employee must have been checked by the caller
+     \param now current time of the server for the validation
+     \return BOOKING_ACCEPTED, BOOKING_DUPLICATE or BOOKING_INVALID
+    */
+   Organization::EBookingResult append(TimeBookingEvent const& event, booking_time_ty now = now_ms());
+
+   /**
+     \brief Validates and appends several bookings, the lock of each shard is taken once.
+     \param events bookings in any order, the employees must have been checked by the caller
+     \param results receives the result for each booking, in the order of the events (same size as events)
+     \param now current time of the server for the validation
+    */
+   void append(std::span<TimeBookingEvent const> events, std::span<Organization::EBookingResult> results, booking_time_ty now = now_ms());
+
+   /**
+     \brief Checks a booking without appending it, e.g. before it is written to the journal.
+     \details A rejected booking is counted like in append(). The log only grows, so a rejected booking
+              stays rejected, an accepted one can still become a duplicate of a concurrent append.
+     \param event booking, the employee must have been checked by the caller
+     \param now current time of the server, the same time has to be passed to the following append()
+     \return BOOKING_ACCEPTED if the booking would be appended now, BOOKING_DUPLICATE or BOOKING_INVALID
+    */
+   Organization::EBookingResult check(TimeBookingEvent const& event, booking_time_ty now);
+
+   /**
+     \brief Appends bookings replayed from the journal, without the validation of the time point.
+     \details The bookings were accepted before, they are only checked for a repetition against all
+              bookings of the log, so the overlap of a snapshot and the journal is dropped. The keys
+              outside the accepted window are dropped with the next append of the employee.
+    */
+   void restore(std::span<TimeBookingEvent const> events);
+
+   /// \brief copy of the bookings of an employee in the order of arrival
+   std::vector<TimeBookingEvent> events(CORBA::Long personId) const;
+
+   /// \brief copy of the bookings of an employee with a time point in [from, to), in the order of arrival
+   std::vector<TimeBookingEvent> events(CORBA::Long personId, booking_time_ty from, booking_time_ty to) const;
+
+   /**
+     \brief Copies all bookings, e.g. for a snapshot.
+     \details Each shard is locked only while its bookings are copied, so bookings continue during the copy.
+              The bookings of an employee keep the order of arrival.
+    */
+   std::vector<TimeBookingEvent> snapshot() const;
+
+   /// \brief number of bookings of an employee
+   std::size_t count(CORBA::Long personId) const;
+
+   /// \brief current counters of the log
+   Statistics statistics() const;
+
+   static booking_time_ty now_ms() {
+      return std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+      }
+
+private:
+   Shard& shard(CORBA::Long personId) const {
+      return *shards_[static_cast<std::uint32_t>(personId) % shards_.size()];
+      }
+
+   bool is_valid(TimeBookingEvent const& event, booking_time_ty now) const;
+
+   /// \brief oldest time point which can still be accepted at now, the keys of older bookings are dropped
+   booking_time_ty oldest_kept(booking_time_ty now) const {
+      // the tolerance of the future applies to a clock of the server which is set back, too
+      return now - config_.max_past - config_.max_future;
+      }
+
+   /// \brief key of a booking in EmployeeLog::recent, ordered by the time point
+   static std::int64_t duplicate_key(booking_time_ty timepoint, Organization::EBookingKind kind) {
+      return timepoint.time_since_epoch().count() * 4 + static_cast<std::int64_t>(kind);
+      }
+
+   /// \brief true if the booking repeats a booking of the employee in the accepted window, the lock of the shard must be held
+   static bool is_duplicate(EmployeeLog const& log, TimeBookingEvent const& event);
+
+   /**
+     \brief duplicate check and append, the lock of the shard must be held
+     \param oldest keys of bookings before this time point are dropped, booking_time_ty::min() keeps all (replay)
+    */
+   Organization::EBookingResult append_locked(Shard& shard, TimeBookingEvent const& event, booking_time_ty oldest);
+
+   /// \brief appends the events at the positions of order, grouped by shard, and stores the results
+   void append_grouped(std::span<TimeBookingEvent const> events, std::vector<std::size_t>& order,
+                       std::span<Organization::EBookingResult> results, booking_time_ty oldest);
+   };
@@ -6,14 +6,14 @@
  
   \details This file contains the implementation of the `Company_i` class, which serves as the
            server-side CORBA servant for the `Organization::Company` interface.
-           It manages employee records using an in-memory map of `EmployeeData` and provides access
+           It manages employee records using the columnar in-memory store `EmployeeStore` and provides access
            to individual employee servants via CORBA object references.
  
            For demonstration purposes, this implementation uses test data. A future version
-           will connect to a database backend. The class also demonstrates how to dynamically
-           activate CORBA servants (employees) using the Portable Object Adapter (POA).
+           will connect to a database backend. The class also demonstrates how to serve all
+           employee references with one default servant of the Portable Object Adapter (POA).
  
-  \note   The map with the Long key and the data source (`EmployeeData`) is temporary and
+  \note   The columnar store (`EmployeeStore`) with the test data is temporary and
           simulate a database. This will later be replaced with a system-backed implementation
           (e.g., connected to a database).
 
@@ -41,6 +41,7 @@
  */
 
 #include "Company_i.h"
+#include "EmployeePOA.h"
 #include "Tools.h"
 #include "my_logging.h"
 
@@ -49,50 +50,259 @@
 #include <ranges>
 #include <numeric>
 #include <algorithm>
-
-Company_i::Company_i(PortableServer::POA_ptr company_poa, PortableServer::POA_ptr employee_poa)
-   : employee_poa_(PortableServer::POA::_duplicate(employee_poa)), company_poa_(PortableServer::POA::_duplicate(company_poa)) {
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+
+Company_i::Company_i(CORBA::ORB_ptr orb, PortableServer::POA_ptr company_poa, PortableServer::POA_ptr employee_poa,
+                     EmployeePOAConfig const& config, WorkTimeEngine::Config const& worktime_config)
+   : orb_(CORBA::ORB::_duplicate(orb)), employee_poa_(PortableServer::POA::_duplicate(employee_poa)), 
+     company_poa_(PortableServer::POA::_duplicate(company_poa)), employee_config_(config), worktime_(worktime_config) {
    initializeDatabase();
+   if (!CORBA::is_nil(employee_poa_.in())) install_employee_servant();
+   change_compactor_ = std::jthread([this](std::stop_token token) {
+                                       std::mutex mutex;
+                                       std::condition_variable_any wakeup;
+                                       std::unique_lock lock(mutex);
+                                       while (!wakeup.wait_for(lock, token, CompactionInterval, [&token]() { return token.stop_requested(); }))
+                                          compactEmployeeChanges();
+                                       });
    log_trace<4>("[Company_i {}] Company Servant {} created", ::getTimeStamp(), strCompanyName);
    }
 
 Company_i::~Company_i() {
+   if (auto stat = employeeCacheStatistics(); stat)
+      log_trace<4>("[Company_i {}] Employee cache: {} hits, {} misses, {} evictions, {} stale, {} of {} servants cached.", ::getTimeStamp(),
+                   stat->hits, stat->misses, stat->evictions, stat->stale, stat->size, stat->capacity);
+   if (auto stat = employeeDataCacheStatistics(); stat)
+      log_trace<4>("[Company_i {}] Employee data cache: {} hits, {} negative hits, {} misses, {} invalidations, {} stale loads, average load {}.",
+                   ::getTimeStamp(), stat->hits, stat->negative_hits, stat->misses, stat->invalidations, stat->stale_loads,
+                   stat->average_load_time());
+   if (journal_) {
+      auto journal = journal_->statistics();
+      log_trace<4>("[Company_i {}] Booking journal: {} records durable, {} group commits, {} rotations.", ::getTimeStamp(),
+                   journal.durable, journal.group_commits, journal.rotations);
+      }
+   auto booked = bookings_.statistics();
+   log_trace<4>("[Company_i {}] Time bookings: {} accepted, {} duplicates, {} invalid.", ::getTimeStamp(),
+                booked.accepted, booked.duplicates, booked.invalid);
+   auto keys = request_keys_.statistics();
+   log_trace<4>("[Company_i {}] Request keys: {} checked, {} filtered by Bloom filters, {} retries, {} retries in progress, {} false positives.",
+                ::getTimeStamp(), keys.checks, keys.filtered, keys.duplicates, keys.pending, keys.false_positives);
+   if (presence_events_) {
+      auto events = presence_events_->statistics();
+      log_trace<4>("[Company_i {}] Presence events: {} pushed, {} dropped.", ::getTimeStamp(), events.pushed, events.dropped);
+      }
+   auto worktime = worktime_totals_.statistics();
+   log_trace<4>("[Company_i {}] Worked time aggregates: {} employees built, {} days refreshed, {} queries.", ::getTimeStamp(),
+                worktime.builds, worktime.refreshes, worktime.queries);
    log_trace<4>("[Company_i {}] Company Servant {} destroyed", ::getTimeStamp(), strCompanyName);
    }
 
 
+void Company_i::install_employee_servant() {
+   switch (employee_config_.mode) {
+      case EEmployeePOAMode::DefaultServant:
+         employee_servant_ = new EmployeeDefaultServant_i(orb_.in(), employee_database_);
+         employee_poa_->set_servant(employee_servant_.in());
+         log_trace<4>("[Company_i {}] Default servant for employees installed.", ::getTimeStamp());
+         break;
+      case EEmployeePOAMode::ServantLocator:
+         employee_cache_   = new EmployeeServantLocator(employee_database_, employee_config_.cache_size);
+         employee_locator_ = employee_cache_;
+         employee_poa_->set_servant_manager(employee_locator_.in());
+         log_trace<4>("[Company_i {}] Servant locator for employees installed, cache size {}.", ::getTimeStamp(), employee_config_.cache_size);
+         break;
+      }
+   }
+
+std::optional<EmployeeServantLocator::Statistics> Company_i::employeeCacheStatistics() const {
+   if (employee_cache_ == nullptr) return std::nullopt;
+   return employee_cache_->statistics();
+   }
+
+std::optional<EmployeeCache::Statistics> Company_i::employeeDataCacheStatistics() const {
+   if (!employee_data_cache_) return std::nullopt;
+   return employee_data_cache_->statistics();
+   }
+
+void Company_i::setEmployeeRepository(EmployeeCache::loader_ty loader, EmployeeCache::Config const& config) {
+   employee_data_cache_ = std::make_unique<EmployeeCache>(config, std::move(loader));
+   log_trace<4>("[Company_i {}] Read-through cache for the employee repository installed, {} entries in {} shards.", ::getTimeStamp(),
+                config.capacity, config.shards);
+   }
+
+void Company_i::invalidateEmployee(CORBA::Long personId) {
+   if (employee_data_cache_) employee_data_cache_->invalidate(personId);
+   if (employee_cache_ != nullptr) employee_cache_->evict(personId);
+   log_trace<4>("[Company_i {}] Employee {} invalidated.", ::getTimeStamp(), personId);
+   }
+
+BookingJournal::RecoveryStatistics Company_i::openBookingJournal(BookingJournal::Config config,
+                                                                 std::optional<SnapshotManager::Config> snapshot_config) {
+   auto const start = std::chrono::steady_clock::now();
+   auto restore = [this](std::span<TimeBookingEvent const> events) { bookings_.restore(events); };
+   // the absences of the snapshot and the changes of the journal are collected, the calendar is built once
+   AbsenceRecovery absences;
+   auto restore_absences = [&absences](std::vector<AbsenceEntry> entries, std::uint64_t next_id) { absences.restore(std::move(entries), next_id); };
+   auto replay_absence   = [&absences](AbsenceChange const& change) { absences.apply(change); };
+
+   std::uint64_t after_sequence = 0;
+   if (snapshot_config) {
+      snapshots_ = std::make_unique<SnapshotManager>(std::move(*snapshot_config));
+      EmployeeStore store;
+      auto loaded = snapshots_->load_latest(store, restore, restore_absences);
+      if (loaded.found) {
+         after_sequence = loaded.journal_sequence;
+         if (loaded.employees > 0) replaceEmployees(std::move(store));
+         }
+      }
+
+   journal_ = std::make_unique<BookingJournal>(std::move(config));
+   auto stats = journal_->open(restore, after_sequence, replay_absence);
+   log_trace<2>("[Company_i {}] {} bookings and {} changes of absences restored from the journal in {}{}.", ::getTimeStamp(),
+                stats.records - stats.absences, stats.absences, stats.duration, stats.torn_tail ? ", torn record at the end removed" : "");
+   absences_.load(absences.entries(), absences.next_id());
+
+   if (snapshots_) {
+      snapshots_->start([this]() { return takeSnapshot(); },
+                        [this](std::uint64_t covered) {
+                              if (auto removed = journal_->compact(covered); removed > 0)
+                                 log_trace<4>("[Company_i {}] {} journal segments up to sequence {} removed.", ::getTimeStamp(), removed, covered);
+                              });
+      }
+   // the presence is determined again from the restored bookings
+   presence_.invalidate();
+   log_trace<2>("[Company_i {}] state restored in {}.", ::getTimeStamp(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+   return stats;
+   }
+
+StateSnapshot Company_i::takeSnapshot() {
+   StateSnapshot snapshot;
+      {
+      // every booking and absence in the journal up to the sequence is published when the gate is free
+      std::unique_lock gate(publish_gate_);
+      snapshot.journal_sequence = journal_ ? journal_->statistics().durable : 0;
+      snapshot.absences         = absences_.entries();
+      snapshot.next_absence_id  = absences_.next_id();
+      }
+   snapshot.employees        = employee_database_.current()->columns();
+   snapshot.bookings         = bookings_.snapshot();
+   return snapshot;
+   }
+
+void Company_i::connectPresenceEvents(CosEventChannelAdmin::EventChannel_ptr channel) {
+   presence_events_ = std::make_unique<PresenceEvents>(orb_.in(), company_poa_.in(), channel);
+   }
+
+std::optional<EmployeeData> Company_i::lookupEmployee(CORBA::Long personId) {
+   auto const store = employee_database_.current();
+   std::optional<EmployeeData> seen;
+   if (auto row = store->find(personId); row) seen = store->record(*row);
+   if (!employee_data_cache_) return seen;
+
+   // the repository decides, the store follows it, so all readers of the store see this result
+   auto data = employee_data_cache_->get(personId);
+   if (data != seen) adoptEmployee(personId, seen, data);
+   return data;
+   }
+
+bool Company_i::adoptEmployee(CORBA::Long personId, std::optional<EmployeeData> const& seen, std::optional<EmployeeData> const& data) {
+   bool const changed = employee_database_.update([personId, &seen, &data](EmployeeStore& store) {
+                           std::optional<EmployeeData> current;
+                           if (auto row = store.find(personId); row) current = store.record(*row);
+                           if (current != seen) return false;   // changed meanwhile by a writer
+                           if (data) store.insert(*data);
+                           else store.remove(personId);
+                           return true;
+                           });
+   if (changed && employee_cache_ != nullptr) employee_cache_->evict(personId);
+   log_trace<4>("[Company_i {}] Employee with ID {} {} from the repository.", ::getTimeStamp(), personId,
+                !changed ? "not taken over" : data ? "taken over" : "removed, missing");
+   return changed;
+   }
+
+Organization::Employee_ptr Company_i::createEmployeeReference(CORBA::Long personId) {
+   PortableServer::ObjectId_var oid = toEmployeeObjectId(personId);
+   CORBA::Object_var obj_ref = employee_poa_->create_reference_with_id(oid.in(), EmployeeRepositoryId);
+   return Organization::Employee::_unchecked_narrow(obj_ref.in());
+   }
+
 void Company_i::initializeDatabase() {
    using namespace std::chrono;
    CORBA::Long emp_no = 99;
-   employee_database_[emp_no] = { ++emp_no, "Max",        "Muster",   Organization::MALE,   55'000.00, {2020y, May,       1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Petra",      "Power",    Organization::FEMALE, 62'000.00, {2019y, March,     1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Klaus",      "Klein",    Organization::MALE,   48'000.00, {2022y, November,  1d}, false };
-   employee_database_[emp_no] = { ++emp_no, "Johannes",   "Gerlach",  Organization::MALE,   63'230.00, {2020y, May,       1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Matthias",   "Fehse",    Organization::MALE,   65'500.00, {2020y, December,  1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Gabriele",   "Sommer",   Organization::FEMALE, 70'320.50, {2017y, October,   1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Sandra",     "Mayer",    Organization::FEMALE, 55'100.00, {2020y, February,  1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Vanessa",    "Schmitt",  Organization::FEMALE, 45'500.25, {2020y, April,     1d}, false };
-   employee_database_[emp_no] = { ++emp_no, "Christel",   "Rau",      Organization::FEMALE, 52'300.00, {2020y, September, 1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Torsten",    "Gutmann",  Organization::MALE,   73'500.00, {2016y, March,     1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Stefanie",   "Berger",   Organization::FEMALE, 63'352.25, {2020y, March ,    1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Sarah",      "Mayer",    Organization::FEMALE, 53'250.00, {2020y, August,    1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Harry",      "Deutsch",  Organization::MALE,   61'720.50, {2020y, May,       1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Katharina",  "Keller",   Organization::FEMALE, 71'500.00, {2020y, July,      1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Sophie",     "Hoffmann", Organization::FEMALE, 51'650.25, {2020y, June,      1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Anna",       "Schmidt",  Organization::FEMALE, 63'751.10, {2020y, February,  1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Lea",        "Peters",   Organization::FEMALE, 67'200.00, {2020y, March,     1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Julian",     "Ziegler",  Organization::MALE,   69'756.20, {2020y, September, 1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Finn",       "Noris",    Organization::MALE,   65'100.75, {2020y, October,   1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Maximilian", "Lang",     Organization::MALE,   67'111.20, {2020y, May,       1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Tim - Leon", "Ziegler",  Organization::MALE,   64'900.60, {2020y, January,   1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Julian",     "Gerlach",  Organization::MALE,   54'222.00, {2020y, March,     1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Hans",       "Mayer",    Organization::MALE,   66'360.10, {2020y, February,  1d}, false };
-   employee_database_[emp_no] = { ++emp_no, "Reinhard",   "Schmidt",  Organization::MALE,   61'200.00, {2019y, October,   1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Petra",      "Winther",  Organization::FEMALE, 72'650.00, {2017y, April,     1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Julia",      "Schmidt",  Organization::FEMALE, 68'250.00, {2020y, March,     1d}, true };
-   employee_database_[emp_no] = { ++emp_no, "Mark",       "Krämer",   Organization::MALE,   46'700.20, {2020y, February,  1d}, true };
-
-   log_trace<4>("[Company_i {}] Database initialized with {} employees.", ::getTimeStamp(), employee_database_.size());
+   EmployeeStore store;
+   store.insert({ ++emp_no, "Max",        "Muster",   Organization::MALE,   55'000.00, {2020y, May,       1d}, true });
+   store.insert({ ++emp_no, "Petra",      "Power",    Organization::FEMALE, 62'000.00, {2019y, March,     1d}, true });
+   store.insert({ ++emp_no, "Klaus",      "Klein",    Organization::MALE,   48'000.00, {2022y, November,  1d}, false });
+   store.insert({ ++emp_no, "Johannes",   "Gerlach",  Organization::MALE,   63'230.00, {2020y, May,       1d}, true });
+   store.insert({ ++emp_no, "Matthias",   "Fehse",    Organization::MALE,   65'500.00, {2020y, December,  1d}, true });
+   store.insert({ ++emp_no, "Gabriele",   "Sommer",   Organization::FEMALE, 70'320.50, {2017y, October,   1d}, true });
+   store.insert({ ++emp_no, "Sandra",     "Mayer",    Organization::FEMALE, 55'100.00, {2020y, February,  1d}, true });
+   store.insert({ ++emp_no, "Vanessa",    "Schmitt",  Organization::FEMALE, 45'500.25, {2020y, April,     1d}, false });
+   store.insert({ ++emp_no, "Christel",   "Rau",      Organization::FEMALE, 52'300.00, {2020y, September, 1d}, true });
+   store.insert({ ++emp_no, "Torsten",    "Gutmann",  Organization::MALE,   73'500.00, {2016y, March,     1d}, true });
+   store.insert({ ++emp_no, "Stefanie",   "Berger",   Organization::FEMALE, 63'352.25, {2020y, March ,    1d}, true });
+   store.insert({ ++emp_no, "Sarah",      "Mayer",    Organization::FEMALE, 53'250.00, {2020y, August,    1d}, true });
+   store.insert({ ++emp_no, "Harry",      "Deutsch",  Organization::MALE,   61'720.50, {2020y, May,       1d}, true });
+   store.insert({ ++emp_no, "Katharina",  "Keller",   Organization::FEMALE, 71'500.00, {2020y, July,      1d}, true });
+   store.insert({ ++emp_no, "Sophie",     "Hoffmann", Organization::FEMALE, 51'650.25, {2020y, June,      1d}, true });
+   store.insert({ ++emp_no, "Anna",       "Schmidt",  Organization::FEMALE, 63'751.10, {2020y, February,  1d}, true });
+   store.insert({ ++emp_no, "Lea",        "Peters",   Organization::FEMALE, 67'200.00, {2020y, March,     1d}, true });
+   store.insert({ ++emp_no, "Julian",     "Ziegler",  Organization::MALE,   69'756.20, {2020y, September, 1d}, true });
+   store.insert({ ++emp_no, "Finn",       "Noris",    Organization::MALE,   65'100.75, {2020y, October,   1d}, true });
+   store.insert({ ++emp_no, "Maximilian", "Lang",     Organization::MALE,   67'111.20, {2020y, May,       1d}, true });
+   store.insert({ ++emp_no, "Tim - Leon", "Ziegler",  Organization::MALE,   64'900.60, {2020y, January,   1d}, true });
+   store.insert({ ++emp_no, "Julian",     "Gerlach",  Organization::MALE,   54'222.00, {2020y, March,     1d}, true });
+   store.insert({ ++emp_no, "Hans",       "Mayer",    Organization::MALE,   66'360.10, {2020y, February,  1d}, false });
+   store.insert({ ++emp_no, "Reinhard",   "Schmidt",  Organization::MALE,   61'200.00, {2019y, October,   1d}, true });
+   store.insert({ ++emp_no, "Petra",      "Winther",  Organization::FEMALE, 72'650.00, {2017y, April,     1d}, true });
+   store.insert({ ++emp_no, "Julia",      "Schmidt",  Organization::FEMALE, 68'250.00, {2020y, March,     1d}, true });
+   store.insert({ ++emp_no, "Mark",       "Krämer",   Organization::MALE,   46'700.20, {2020y, February,  1d}, true });
+
+   employee_database_.replace(std::move(store));
+   log_trace<4>("[Company_i {}] Database initialized with {} employees.", ::getTimeStamp(), employee_database_.current()->size());
+   }
+
+void Company_i::replaceEmployees(EmployeeStore&& store) {
+   auto const count = store.size();
+   employee_database_.replace(std::move(store));
+   if (employee_cache_ != nullptr) employee_cache_->clear();
+   if (employee_data_cache_) employee_data_cache_->invalidate_all();
+   log_trace<4>("[Company_i {}] Employees replaced, {} employees in the store.", ::getTimeStamp(), count);
+   }
+
+bool Company_i::storeEmployee(EmployeeData const& data) {
+   bool const inserted = employee_database_.update([&data](EmployeeStore& store) { return store.insert(data); });
+   invalidateEmployee(data.personID);
+   log_trace<4>("[Company_i {}] Employee with ID {} {}, version {} of the store.", ::getTimeStamp(), data.personID,
+                inserted ? "inserted" : "updated", employee_database_.number());
+   return inserted;
+   }
+
+bool Company_i::deactivateEmployee(CORBA::Long personId) {
+   bool const changed = employee_database_.update([personId](EmployeeStore& store) { return store.deactivate(personId); });
+   if (changed) invalidateEmployee(personId);
+   log_trace<4>("[Company_i {}] Employee with ID {} {}.", ::getTimeStamp(), personId, changed ? "deactivated" : "not changed");
+   return changed;
+   }
+
+bool Company_i::removeEmployee(CORBA::Long personId) {
+   bool const removed = employee_database_.update([personId](EmployeeStore& store) { return store.remove(personId); });
+   if (removed) invalidateEmployee(personId);
+   log_trace<4>("[Company_i {}] Employee with ID {} {}, version {} of the store.", ::getTimeStamp(), personId,
+                removed ? "removed" : "not found", employee_database_.number());
+   return removed;
+   }
+
+void Company_i::compactEmployeeChanges() {
+   auto const cutoff = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()) - TombstoneRetention;
+   if (!employee_database_.current()->has_tombstones_before(cutoff)) return;
+   auto const dropped = employee_database_.update([cutoff](EmployeeStore& store) { return store.compact_changes(cutoff); });
+   log_trace<4>("[Company_i {}] {} tombstones of removed employees dropped.", ::getTimeStamp(), dropped);
    }
 
 char* Company_i::nameCompany() {
@@ -111,48 +321,86 @@ Basics::TimePoint Company_i::getTimeStamp() {
 
 Organization::EmployeeSeq* Company_i::getEmployees() {
    std::println(std::cout, "[Company_i {}] getEmployees() called by client.", ::getTimeStamp());
-   auto all_employees_view = employee_database_ | std::views::values;
-   return buildEmploySequenceFromRange(all_employees_view);
+   auto const store = employee_database_.current();
+   return buildEmploySequenceFromRange(store->ids());
    }
 
 Organization::EmployeeSeq* Company_i::getActiveEmployees() {
    log_trace<4>("[Company_i {}] getActiveEmployees() called by client.", ::getTimeStamp());
-   auto active_employees_view = employee_database_ | std::views::values
-                                                   | std::views::filter([](EmployeeData const& e) { return e.isActive; });
+   auto const store = employee_database_.current();
+   auto active_employees_view = store->active_rows()
+                                 | std::views::transform([&store](EmployeeStore::row_ty row) { return store->personId(row); });
    return buildEmploySequenceFromRange(active_employees_view);
    }
 
 
 double Company_i::getSumSalary() {
    log_trace<4>("[Company_i {}] getSumSalary() called by client.", ::getTimeStamp());
+   return employee_database_.current()->aggregates().total().sum();
+   }
+
+namespace {
+
+Organization::SalaryAggregate toSalaryAggregate(SalaryAggregate const& aggregate) {
+   return { .headcount = static_cast<CORBA::ULong>(aggregate.count()), .sumSalary = aggregate.sum(),
+            .minSalary = aggregate.min().value_or(0.0), .maxSalary = aggregate.max().value_or(0.0),
+            .avgSalary = aggregate.average() };
+   }
+
+}
+
+Organization::SalaryStatistics* Company_i::getSalaryStatistics() {
+   log_trace<4>("[Company_i {}] getSalaryStatistics() called by client.", ::getTimeStamp());
+   static constexpr std::array percentiles { 50.0, 90.0, 95.0, 99.0 };
+   static constexpr std::array genders { Organization::MALE, Organization::FEMALE, Organization::OTHER };
+
+   auto const store = employee_database_.current();
+   auto const& aggregates = store->aggregates();
+   Organization::SalaryStatistics_var stats = new Organization::SalaryStatistics;
+   stats->employeeCount    = static_cast<CORBA::ULong>(store->size());
+   stats->total            = toSalaryAggregate(aggregates.total());
+   stats->relativeAccuracy = aggregates.sketch().relative_accuracy();
+
+   stats->byGender.length(genders.size());
+   for (CORBA::ULong i = 0; auto gender : genders) {
+      stats->byGender[i++] = { .gender = gender, .values = toSalaryAggregate(aggregates.by_gender(gender)) };
+      }
+
+   stats->byStartYear.length(static_cast<CORBA::ULong>(aggregates.by_start_year().size()));
+   for (CORBA::ULong i = 0; auto const& [year, aggregate] : aggregates.by_start_year()) {
+      stats->byStartYear[i++] = { .startYear = static_cast<CORBA::Short>(year), .values = toSalaryAggregate(aggregate) };
+      }
+
+   auto buckets = aggregates.sketch().buckets();
+   stats->histogram.length(static_cast<CORBA::ULong>(buckets.size()));
+   for (CORBA::ULong i = 0; auto const& bucket : buckets) {
+      stats->histogram[i++] = { .lowerBound = bucket.lower, .upperBound = bucket.upper, .count = static_cast<CORBA::ULong>(bucket.count) };
+      }
+
+   stats->percentiles.length(aggregates.sketch().count() > 0 ? percentiles.size() : 0);
+   for (CORBA::ULong i = 0; i < stats->percentiles.length(); ++i) {
+      stats->percentiles[i] = { .percentile = percentiles[i], .salary = aggregates.sketch().quantile(percentiles[i] / 100.0).value_or(0.0) };
+      }
 
-   auto active_salaries = employee_database_ | std::views::values 
-                                             | std::views::filter([](EmployeeData const& e) { return e.isActive; })
-                                             | std::views::transform([](EmployeeData const& e) { return e.salary; });
-   return std::accumulate(active_salaries.begin(), active_salaries.end(), 0.0);
+   return stats._retn();
    }
 
 Organization::Employee* Company_i::getEmployee(CORBA::Long personId) {
    log_trace<4>("[Company_i {}] getEmployee() called by client for ID = {}.", ::getTimeStamp(), personId);
 
-   // 1st seek in db
-   if (auto it = employee_database_.find(personId); it != employee_database_.end()) [[likely]] {
+   // 1st seek in db (through the read-through cache, when a repository is set)
+   if (lookupEmployee(personId)) [[likely]] {
       try {
-         Employee_i* employee_servant = new Employee_i(it->second, employee_poa_.in());
-
-         PortableServer::ObjectId_var oid = employee_poa_->activate_object(employee_servant);
-         employee_servant->set_oid(oid);
-
-         CORBA::Object_var obj_ref = employee_poa_->id_to_reference(oid.in());
-         Organization::Employee_var employee_ref = Organization::Employee::_narrow(obj_ref.in());
+         // no servant is activated, the reference is served by the default servant of the employee POA
+         Organization::Employee_var employee_ref = createEmployeeReference(personId);
 
          if(CORBA::is_nil(employee_ref)) {
-            std::println(std::cerr, "[Company_i {}] getEmployee(), CORBA Error while narrowing Reference for ID {}",
+            std::println(std::cerr, "[Company_i {}] getEmployee(), CORBA Error while creating Reference for ID {}",
                                  ::getTimeStamp(), personId);
             return nullptr; // oder eine qualifizierte Fehlerbehandlung ToDo
             }
 
-         log_trace<4>("[Company_i {}] getEmployee() returning Employee* for ID = {}.", ::getTimeStamp(), employee_ref->personId());
+         log_trace<4>("[Company_i {}] getEmployee() returning Employee* for ID = {}.", ::getTimeStamp(), personId);
          // BESITZWECHLER
          return employee_ref._retn();
          }
@@ -180,10 +428,10 @@ Organization::Employee* Company_i::getEmployee(CORBA::Long personId) {
 Organization::EmployeeData* Company_i::getEmployeeData(CORBA::Long personId) {
    log_trace<4>("[Company_i {}] getEmployeeData() called by client for ID = {}.", ::getTimeStamp(), personId);
 
-   // 1st seek employee in company database
-   if(auto it = employee_database_.find(personId); it != employee_database_.end()) [[likely]] {
+   // 1st seek employee in company database (through the read-through cache, when a repository is set)
+   if(auto data = lookupEmployee(personId); data) [[likely]] {
       // 2nd employee found prepare data for transmission
-      Organization::EmployeeData* employee_data = createFrom(it->second);
+      Organization::EmployeeData* employee_data = createFrom(*data);
       log_trace<4>("[Company_i {}] getEmployeeData() returning EmployeeData for ID = {}.", ::getTimeStamp(), employee_data->personId);
       return employee_data;
       }
@@ -196,3 +444,579 @@ Organization::EmployeeData* Company_i::getEmployeeData(CORBA::Long personId) {
      }
 
    }
+
+Organization::EmployeeDataBatch* Company_i::getEmployeeDataBatch(Organization::PersonIdSeq const& personIds) {
+   log_trace<4>("[Company_i {}] getEmployeeDataBatch() called by client for {} IDs.", ::getTimeStamp(), personIds.length());
+
+   std::vector<CORBA::Long> sorted_ids(personIds.get_buffer(), personIds.get_buffer() + personIds.length());
+   std::ranges::sort(sorted_ids);
+   auto [last, end] = std::ranges::unique(sorted_ids);
+   sorted_ids.erase(last, end);
+
+   auto const store = employee_database_.current();
+   auto lookup = store->lookup_sorted(sorted_ids);
+
+   Organization::EmployeeDataBatch_var batch = new Organization::EmployeeDataBatch;
+   batch->found.length(static_cast<CORBA::ULong>(lookup.rows.size()));
+   for (CORBA::ULong i = 0; auto row : lookup.rows) store->copy_to(row, batch->found[i++]);
+   batch->missing.length(static_cast<CORBA::ULong>(lookup.missing.size()));
+   std::ranges::copy(lookup.missing, batch->missing.get_buffer());
+
+   log_trace<4>("[Company_i {}] getEmployeeDataBatch() returning {} employees, {} IDs missing.", ::getTimeStamp(),
+                batch->found.length(), batch->missing.length());
+   return batch._retn();
+   }
+
+Organization::EmployeeDataPage* Company_i::getEmployeesData(CORBA::ULong offset, CORBA::ULong limit) {
+   log_trace<4>("[Company_i {}] getEmployeesData() called by client with offset {} and limit {}.", ::getTimeStamp(), offset, limit);
+
+   auto const store = employee_database_.current();
+   CORBA::ULong const total = static_cast<CORBA::ULong>(store->size());
+   if (limit == 0 || limit > MaxEmployeePageSize) limit = MaxEmployeePageSize;
+   CORBA::ULong const first = std::min(offset, total);
+   CORBA::ULong const count = std::min(limit, total - first);
+
+   Organization::EmployeeDataPage_var page = new Organization::EmployeeDataPage;
+   page->totalCount = total;
+   page->nextOffset = first + count;
+   page->employees.length(count);
+   for (CORBA::ULong i = 0; i < count; ++i) {
+      store->copy_to(first + i, page->employees[i]);
+      }
+
+   log_trace<4>("[Company_i {}] getEmployeesData() returning {} of {} employees.", ::getTimeStamp(), count, total);
+   return page._retn();
+   }
+
+Organization::EmployeeChanges* Company_i::getEmployeesChangedSince(CORBA::ULongLong since, CORBA::Boolean resync, CORBA::ULong limit) {
+   log_trace<4>("[Company_i {}] getEmployeesChangedSince() called by client with version {}{} and limit {}.", ::getTimeStamp(), since,
+                resync ? " (resync)" : "", limit);
+
+   if (limit == 0 || limit > MaxEmployeePageSize) limit = MaxEmployeePageSize;
+   auto const store   = employee_database_.current();
+   auto const changes = store->changes_since(since, resync != 0, limit);
+
+   Organization::EmployeeChanges_var result = new Organization::EmployeeChanges;
+   result->version    = changes.version;
+   result->fullResync = changes.full;
+   result->more       = changes.more;
+   result->changed.length(static_cast<CORBA::ULong>(changes.rows.size()));
+   for (CORBA::ULong i = 0; i < changes.rows.size(); ++i) {
+      store->copy_to(changes.rows[i], result->changed[i]);
+      }
+   result->removed.length(static_cast<CORBA::ULong>(changes.removed.size()));
+   std::ranges::copy(changes.removed, result->removed.get_buffer());
+
+   log_trace<4>("[Company_i {}] getEmployeesChangedSince() returning {} changed and {} removed employees{}, version {}{}.", ::getTimeStamp(),
+                changes.rows.size(), changes.removed.size(), changes.full ? " (full resync)" : "", changes.version,
+                changes.more ? ", more follow" : "");
+   return result._retn();
+   }
+
+Organization::EmployeeIterator_ptr Company_i::getEmployeesIterator() {
+   log_trace<4>("[Company_i {}] getEmployeesIterator() called by client.", ::getTimeStamp());
+   return createEmployeeIterator(false);
+   }
+
+Organization::EmployeeIterator_ptr Company_i::getActiveEmployeesIterator() {
+   log_trace<4>("[Company_i {}] getActiveEmployeesIterator() called by client.", ::getTimeStamp());
+   return createEmployeeIterator(true);
+   }
+
+Organization::EmployeeIterator_ptr Company_i::createEmployeeIterator(bool only_active) {
+   try {
+      EmployeeIterator_i* iterator_servant = new EmployeeIterator_i(employee_database_, only_active, company_poa_.in());
+
+      // the initial reference of the servant is released by destroy() of the client
+      PortableServer::ObjectId_var oid = company_poa_->activate_object(iterator_servant);
+      iterator_servant->set_oid(oid.in());
+
+      CORBA::Object_var obj_ref = company_poa_->id_to_reference(oid.in());
+      return Organization::EmployeeIterator::_narrow(obj_ref.in());
+      }
+   catch (CORBA::Exception const& ex) {
+      log_error("[Company_i {}] createEmployeeIterator(), CORBA Exception: {}", ::getTimeStamp(), toString(ex));
+      throw CORBA::INTERNAL();
+      }
+   }
+
+Organization::EmployeeDataSeq* Company_i::findEmployeesByName(const char* prefix, CORBA::ULong limit) {
+   log_trace<4>("[Company_i {}] findEmployeesByName() called by client with prefix \"{}\" and limit {}.", ::getTimeStamp(), prefix, limit);
+   if (limit == 0 || limit > MaxEmployeePageSize) limit = MaxEmployeePageSize;
+   auto const store = employee_database_.current();
+   return buildEmployeeDataSequence(*store, store->rows_by_name_prefix(prefix, limit));
+   }
+
+Organization::EmployeeDataSeq* Company_i::getEmployeesStartedBetween(Basics::Date const& from, Basics::Date const& to) {
+   log_trace<4>("[Company_i {}] getEmployeesStartedBetween() called by client.", ::getTimeStamp());
+   auto const store = employee_database_.current();
+   return buildEmployeeDataSequence(*store, store->rows_started_between(convert<std::chrono::year_month_day>(from),
+                                                                        convert<std::chrono::year_month_day>(to)));
+   }
+
+Organization::EBookingResult Company_i::bookTimeEvent(CORBA::Long personId, Basics::TimePoint const& timepoint,
+                                                     Organization::EBookingKind kind, CORBA::Long terminalId,
+                                                     CORBA::ULongLong requestKey) {
+   log_trace<4>("[Company_i {}] bookTimeEvent() called by terminal {} for ID = {}.", ::getTimeStamp(), terminalId, personId);
+
+   if (!lookupEmployee(personId)) [[unlikely]] {
+      log_error("[Company_i {}] Employee ID with {} not found. Throwing EmployeeNotFound", ::getTimeStamp(), personId);
+      Organization::EmployeeNotFound ex;
+      ex.requestedId = personId;
+      ex.requestedAt = getTimeStamp();
+      throw ex;
+      }
+
+   // after a failed sync no booking is confirmed, also not as duplicate
+   if (journal_ && !journal_->healthy()) [[unlikely]] throw CORBA::TRANSIENT();
+
+   TimeBookingEvent const event { .personId = personId,
+                                  .timepoint = std::chrono::time_point_cast<std::chrono::milliseconds>(convert<std::chrono::system_clock::time_point>(timepoint)),
+                                  .kind = kind, .terminalId = terminalId };
+   auto const now = BookingLog::now_ms();
+   // a retry of the terminal with the same request key, the key is released with every result except accepted
+   // and with every exception, so only a committed key is a duplicate, a pending one is retried again later
+   IdempotencyWindow::Reservation request;
+   if (requestKey != 0 && !(request = request_keys_.reserve(terminalId, requestKey, now))) {
+      if (request.state() == IdempotencyWindow::EKeyState::Pending) throw CORBA::TRANSIENT();
+      return Organization::BOOKING_DUPLICATE;
+      }
+
+   // with a journal the booking is durable before it is published to the log, the aggregates and the presence,
+   // the gate keeps a snapshot from taking the sequence of the journal before the booking is in the log
+   std::shared_lock<std::shared_mutex> publishing;
+   if (journal_) {
+      publishing = std::shared_lock(publish_gate_);
+      if (auto const checked = bookings_.check(event, now); checked != Organization::BOOKING_ACCEPTED) return checked;
+      try {
+         journal_->append(event);
+         }
+      catch (std::exception const& ex) {
+         log_error("[Company_i {}] bookTimeEvent(), booking for ID {} not written to the journal: {}", ::getTimeStamp(), personId, ex.what());
+         throw CORBA::TRANSIENT();
+         }
+      }
+
+   // a concurrent booking can still make it a duplicate, the replay of the journal drops it in the same way
+   auto const result = bookings_.append(event, now);
+   if (result == Organization::BOOKING_ACCEPTED) {
+      request.commit();
+      worktime_totals_.refresh(personId, event.timepoint);
+      publishPresence(event);
+      }
+   return result;
+   }
+
+Organization::BookingResultSeq* Company_i::bookTimeEvents(Organization::TimeBookingSeq const& bookings) {
+   log_trace<4>("[Company_i {}] bookTimeEvents() called by client with {} bookings.", ::getTimeStamp(), bookings.length());
+
+   if (journal_ && !journal_->healthy()) [[unlikely]] throw CORBA::TRANSIENT();
+
+   auto const now = BookingLog::now_ms();
+   CORBA::ULong const count = bookings.length();
+   std::vector<TimeBookingEvent> events;
+   std::vector<Organization::EBookingResult> results(count, Organization::BOOKING_UNKNOWN_EMPLOYEE);
+   std::vector<CORBA::ULong> positions;
+   std::vector<IdempotencyWindow::Reservation> requests;   // released on return or exception unless the booking was accepted
+   events.reserve(count);
+   positions.reserve(count);
+   requests.reserve(count);
+   std::size_t retries = 0;
+
+   // every employee of the batch is checked once, bookings of unknown employees are not passed to the log
+   std::unordered_map<CORBA::Long, bool> known;
+   for (CORBA::ULong i = 0; i < count; ++i) {
+      auto const& booking = bookings[i];
+      auto [it, inserted] = known.try_emplace(booking.personId, false);
+      if (inserted) it->second = lookupEmployee(booking.personId).has_value();
+      if (!it->second) continue;
+      IdempotencyWindow::Reservation request;
+      if (booking.requestKey != 0 && !(request = request_keys_.reserve(booking.terminalId, booking.requestKey, now))) {
+         // a key pending from another request: nothing of the batch is booked yet, the reservations are released
+         // and the whole batch is retried, a key reserved earlier in this batch is a duplicate within the batch
+         if (request.state() == IdempotencyWindow::EKeyState::Pending &&
+             std::ranges::none_of(positions, [&bookings, &booking](CORBA::ULong j) {
+                                     return bookings[j].terminalId == booking.terminalId && bookings[j].requestKey == booking.requestKey;
+                                     })) throw CORBA::TRANSIENT();
+         results[i] = Organization::BOOKING_DUPLICATE;
+         ++retries;
+         continue;
+         }
+      requests.emplace_back(std::move(request));
+      events.emplace_back(TimeBookingEvent { .personId = booking.personId,
+                                             .timepoint = std::chrono::time_point_cast<std::chrono::milliseconds>(
+                                                             convert<std::chrono::system_clock::time_point>(booking.timepoint)),
+                                             .kind = booking.kind, .terminalId = booking.terminalId });
+      positions.emplace_back(i);
+      }
+
+   std::vector<Organization::EBookingResult> appended(events.size());
+   if (journal_) {
+      // only the checked bookings are written to the journal, and they are appended after the group commit
+      std::shared_lock publishing(publish_gate_);
+      std::vector<TimeBookingEvent> checked;
+      std::vector<std::size_t> checked_index;
+      checked.reserve(events.size());
+      checked_index.reserve(events.size());
+      for (std::size_t i = 0; i < events.size(); ++i) {
+         if (appended[i] = bookings_.check(events[i], now); appended[i] == Organization::BOOKING_ACCEPTED) {
+            checked.emplace_back(events[i]);
+            checked_index.emplace_back(i);
+            }
+         }
+      try {
+         journal_->append(checked);
+         }
+      catch (std::exception const& ex) {
+         log_error("[Company_i {}] bookTimeEvents(), {} bookings not written to the journal: {}", ::getTimeStamp(), checked.size(), ex.what());
+         throw CORBA::TRANSIENT();
+         }
+      std::vector<Organization::EBookingResult> durable(checked.size());
+      bookings_.append(checked, durable, now);
+      for (std::size_t i = 0; i < checked.size(); ++i) appended[checked_index[i]] = durable[i];
+      }
+   else bookings_.append(events, appended, now);
+
+   for (std::size_t i = 0; i < positions.size(); ++i) {
+      results[positions[i]] = appended[i];
+      if (appended[i] == Organization::BOOKING_ACCEPTED) requests[i].commit();
+      }
+   for (std::size_t i = 0; i < events.size(); ++i)
+      if (appended[i] == Organization::BOOKING_ACCEPTED) {
+         worktime_totals_.refresh(events[i].personId, events[i].timepoint);
+         publishPresence(events[i]);
+         }
+
+   Organization::BookingResultSeq_var result = new Organization::BookingResultSeq;
+   result->length(count);
+   std::ranges::copy(results, result->get_buffer());
+   log_trace<4>("[Company_i {}] bookTimeEvents() booked {} of {} bookings, {} retries dropped.", ::getTimeStamp(),
+                std::ranges::count(results, Organization::BOOKING_ACCEPTED), count, retries);
+   return result._retn();
+   }
+
+namespace {
+
+Organization::WorkTimePeriod toWorkTimePeriod(WorkPeriod const& period) {
+   using hours_ty = std::chrono::duration<double, std::ratio<3'600>>;
+   return { .begin          = convert<Basics::Date>(std::chrono::year_month_day { period.begin }),
+            .workedHours    = std::chrono::duration_cast<hours_ty>(period.worked).count(),
+            .breakHours     = std::chrono::duration_cast<hours_ty>(period.breaks).count(),
+            .overtimeHours  = std::chrono::duration_cast<hours_ty>(period.overtime()).count(),
+            .incompleteDays = static_cast<CORBA::ULong>(period.incomplete_days) };
+   }
+
+Organization::WorkTimePeriodSeq toWorkTimePeriods(std::vector<WorkPeriod> const& periods) {
+   Organization::WorkTimePeriodSeq result;
+   result.length(static_cast<CORBA::ULong>(periods.size()));
+   std::ranges::transform(periods, result.get_buffer(), toWorkTimePeriod);
+   return result;
+   }
+
+}
+
+Organization::WorkTimeSummary* Company_i::getWorkTimeSummary(CORBA::Long personId, Basics::Date const& from, Basics::Date const& to) {
+   log_trace<4>("[Company_i {}] getWorkTimeSummary() called by client for ID = {}.", ::getTimeStamp(), personId);
+
+   if (!lookupEmployee(personId)) [[unlikely]] {
+      log_error("[Company_i {}] Employee ID with {} not found. Throwing EmployeeNotFound", ::getTimeStamp(), personId);
+      Organization::EmployeeNotFound ex;
+      ex.requestedId = personId;
+      ex.requestedAt = getTimeStamp();
+      throw ex;
+      }
+
+   std::chrono::sys_days const first { convert<std::chrono::year_month_day>(from) };
+   std::chrono::sys_days const last  { convert<std::chrono::year_month_day>(to) };
+   if (last < first || static_cast<std::size_t>((last - first).count()) >= worktime_.config().max_days) [[unlikely]] {
+      log_error("[Company_i {}] getWorkTimeSummary(), invalid range of {} days.", ::getTimeStamp(), (last - first).count() + 1);
+      throw CORBA::BAD_PARAM();
+      }
+
+   auto summary = worktime_.compute(personId, bookings_.events(personId), first, last);
+   applyAbsences(summary);
+   Organization::WorkTimeSummary_var result = new Organization::WorkTimeSummary;
+   result->personId = personId;
+   result->days.length(static_cast<CORBA::ULong>(summary.days.size()));
+   for (CORBA::ULong i = 0; auto const& day : summary.days) {
+      WorkPeriod period { .begin = day.day };
+      period.add(day);
+      result->days[i++] = toWorkTimePeriod(period);
+      }
+   result->weeks  = toWorkTimePeriods(summary.weeks());
+   result->months = toWorkTimePeriods(summary.months());
+   result->total  = toWorkTimePeriod(summary.total());
+   return result._retn();
+   }
+
+Organization::WorkTimeTotals Company_i::getWorkTimeTotals(CORBA::Long personId, Basics::Date const& day) {
+   log_trace<4>("[Company_i {}] getWorkTimeTotals() called by client for ID = {}.", ::getTimeStamp(), personId);
+
+   if (!lookupEmployee(personId)) [[unlikely]] {
+      log_error("[Company_i {}] Employee ID with {} not found. Throwing EmployeeNotFound", ::getTimeStamp(), personId);
+      Organization::EmployeeNotFound ex;
+      ex.requestedId = personId;
+      ex.requestedAt = getTimeStamp();
+      throw ex;
+      }
+
+   // the aggregates keep the days up to tomorrow, a day behind it would only extend them without bookings
+   auto const requested = convert<std::chrono::year_month_day>(day);
+   if (!requested.ok() || std::chrono::sys_days { requested } > worktime_totals_.latest_day()) [[unlikely]] {
+      log_error("[Company_i {}] getWorkTimeTotals(), invalid day {} for ID = {}.", ::getTimeStamp(), requested, personId);
+      throw CORBA::BAD_PARAM();
+      }
+
+   auto totals = worktime_totals_.totals(personId, std::chrono::sys_days { requested });
+   totals.day.target   -= absentTarget(personId, totals.day.day, totals.day.day);
+   totals.week.target  -= absentTarget(personId, totals.week.begin, totals.day.day);
+   totals.month.target -= absentTarget(personId, totals.month.begin, totals.day.day);
+   WorkPeriod today { .begin = totals.day.day };
+   today.add(totals.day);
+
+   Organization::WorkTimeTotals result;
+   result.personId = personId;
+   result.day      = toWorkTimePeriod(today);
+   result.week     = toWorkTimePeriod(totals.week);
+   result.month    = toWorkTimePeriod(totals.month);
+   return result;
+   }
+
+Organization::WorkTimeViolationSeq* Company_i::checkWorkTimeRules(Basics::Date const& from, Basics::Date const& to) {
+   log_trace<4>("[Company_i {}] checkWorkTimeRules() called by client.", ::getTimeStamp());
+
+   std::chrono::sys_days const first { convert<std::chrono::year_month_day>(from) };
+   std::chrono::sys_days const last  { convert<std::chrono::year_month_day>(to) };
+   if (last < first || static_cast<std::size_t>((last - first).count()) >= worktime_.config().max_days) [[unlikely]] {
+      log_error("[Company_i {}] checkWorkTimeRules(), invalid range of {} days.", ::getTimeStamp(), (last - first).count() + 1);
+      throw CORBA::BAD_PARAM();
+      }
+
+   auto const start = std::chrono::steady_clock::now();
+   auto const store = employee_database_.current();
+   auto const violations = worktime_rules_.check_all(bookings_, store->ids(), first, last);
+   log_trace<2>("[Company_i {}] rules of the working time for {} employees checked in {}, {} violations.", ::getTimeStamp(),
+                store->ids().size(), std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start),
+                violations.size());
+
+   using hours_ty = std::chrono::duration<double, std::ratio<3'600>>;
+   Organization::WorkTimeViolationSeq_var result = new Organization::WorkTimeViolationSeq;
+   result->length(static_cast<CORBA::ULong>(violations.size()));
+   std::ranges::transform(violations, result->get_buffer(), [](WorkTimeViolation const& violation) {
+                             return Organization::WorkTimeViolation { .personId   = violation.personId,
+                                                                      .day        = convert<Basics::Date>(std::chrono::year_month_day { violation.day }),
+                                                                      .rule       = violation.rule,
+                                                                      .valueHours = std::chrono::duration_cast<hours_ty>(violation.value).count(),
+                                                                      .limitHours = std::chrono::duration_cast<hours_ty>(violation.limit).count() };
+                             });
+   return result._retn();
+   }
+
+void Company_i::publishPresence(TimeBookingEvent const& event) {
+   if (auto update = presence_.apply(event); update) {
+      log_trace<4>("[Company_i {}] Employee {} {}, {} employees present.", ::getTimeStamp(), update->personId,
+                   update->present ? "came" : "left", update->count);
+      if (presence_events_) presence_events_->publish(*update);
+      }
+   }
+
+Organization::PersonIdSeq* Company_i::getPresentEmployees() {
+   log_trace<4>("[Company_i {}] getPresentEmployees() called by client.", ::getTimeStamp());
+   auto const present = presence_.present();
+   Organization::PersonIdSeq_var result = new Organization::PersonIdSeq;
+   result->length(static_cast<CORBA::ULong>(present.size()));
+   std::ranges::copy(present, result->get_buffer());
+   return result._retn();
+   }
+
+CORBA::ULong Company_i::getPresenceCount() {
+   log_trace<4>("[Company_i {}] getPresenceCount() called by client.", ::getTimeStamp());
+   return static_cast<CORBA::ULong>(presence_.count());
+   }
+
+void Company_i::applyAbsences(WorkTimeSummary& summary) const {
+   if (summary.days.empty()) return;
+   auto const days = absences_.absent_days(summary.personId, summary.days.front().day, summary.days.back().day);
+   for (auto const day : days) summary.days[static_cast<std::size_t>((day - summary.days.front().day).count())].target = { };
+   }
+
+std::chrono::milliseconds Company_i::absentTarget(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to) const {
+   std::chrono::milliseconds target { };
+   for (auto const day : absences_.absent_days(personId, from, to)) target += worktime_.target(day);
+   return target;
+   }
+
+namespace {
+
+Organization::AbsenceSeq* toAbsenceSeq(std::vector<AbsenceEntry> const& entries) {
+   Organization::AbsenceSeq_var result = new Organization::AbsenceSeq;
+   result->length(static_cast<CORBA::ULong>(entries.size()));
+   std::ranges::transform(entries, result->get_buffer(), [](AbsenceEntry const& entry) {
+                             return Organization::Absence { .absenceId = entry.absenceId, .personId = entry.personId,
+                                                            .from      = convert<Basics::Date>(std::chrono::year_month_day { entry.from }),
+                                                            .to        = convert<Basics::Date>(std::chrono::year_month_day { entry.to }),
+                                                            .kind      = entry.kind, .approved = entry.approved };
+                             });
+   return result._retn();
+   }
+
+}
+
+CORBA::ULongLong Company_i::addAbsence(CORBA::Long personId, Basics::Date const& from, Basics::Date const& to,
+                                       Organization::EAbsenceKind kind, CORBA::Boolean approved) {
+   log_trace<4>("[Company_i {}] addAbsence() called by client for ID = {}.", ::getTimeStamp(), personId);
+
+   if (!lookupEmployee(personId)) [[unlikely]] {
+      log_error("[Company_i {}] Employee ID with {} not found. Throwing EmployeeNotFound", ::getTimeStamp(), personId);
+      Organization::EmployeeNotFound ex;
+      ex.requestedId = personId;
+      ex.requestedAt = getTimeStamp();
+      throw ex;
+      }
+
+   std::chrono::sys_days const first { convert<std::chrono::year_month_day>(from) };
+   std::chrono::sys_days const last  { convert<std::chrono::year_month_day>(to) };
+   if (last < first || (last - first).count() >= BookingJournal::MaxAbsenceDays) [[unlikely]] {
+      log_error("[Company_i {}] addAbsence(), last day before the first day or range too long.", ::getTimeStamp());
+      throw CORBA::BAD_PARAM();
+      }
+
+   AbsenceEntry const entry { .absenceId = absences_.reserve_id(), .personId = personId, .from = first, .to = last,
+                              .kind = kind, .approved = approved != 0 };
+   std::shared_lock<std::shared_mutex> publishing;
+   if (journal_) {
+      publishing = std::shared_lock(publish_gate_);
+      writeAbsenceChange({ .type = EJournalRecord::AbsenceAdded, .entry = entry });
+      }
+   // the aggregates hold the worked time only, the target time of the absences is applied when they are read
+   return absences_.add(entry);
+   }
+
+CORBA::Boolean Company_i::removeAbsence(CORBA::ULongLong absenceId) {
+   log_trace<4>("[Company_i {}] removeAbsence() called by client for absence {}.", ::getTimeStamp(), absenceId);
+   auto const entry = absences_.find(absenceId);
+   if (!entry) return false;
+   std::shared_lock<std::shared_mutex> publishing;
+   if (journal_) {
+      publishing = std::shared_lock(publish_gate_);
+      writeAbsenceChange({ .type = EJournalRecord::AbsenceRemoved, .entry = *entry });
+      }
+   return absences_.remove(absenceId);
+   }
+
+CORBA::Boolean Company_i::approveAbsence(CORBA::ULongLong absenceId, CORBA::Boolean approved) {
+   log_trace<4>("[Company_i {}] approveAbsence() called by client for absence {}.", ::getTimeStamp(), absenceId);
+   auto entry = absences_.find(absenceId);
+   if (!entry) return false;
+   entry->approved = approved != 0;
+   std::shared_lock<std::shared_mutex> publishing;
+   if (journal_) {
+      publishing = std::shared_lock(publish_gate_);
+      writeAbsenceChange({ .type = EJournalRecord::AbsenceApproved, .entry = *entry });
+      }
+   return absences_.approve(absenceId, approved);
+   }
+
+void Company_i::writeAbsenceChange(AbsenceChange const& change) {
+   // after a failed sync no change is confirmed
+   if (!journal_->healthy()) [[unlikely]] throw CORBA::TRANSIENT();
+   try {
+      journal_->append(change);
+      }
+   catch (std::exception const& ex) {
+      log_error("[Company_i {}] change of absence {} not written to the journal: {}", ::getTimeStamp(), change.entry.absenceId, ex.what());
+      throw CORBA::TRANSIENT();
+      }
+   }
+
+Organization::AbsenceSeq* Company_i::getAbsencesBetween(Basics::Date const& from, Basics::Date const& to) {
+   log_trace<4>("[Company_i {}] getAbsencesBetween() called by client.", ::getTimeStamp());
+
+   std::chrono::sys_days const first { convert<std::chrono::year_month_day>(from) };
+   std::chrono::sys_days const last  { convert<std::chrono::year_month_day>(to) };
+   if (last < first) [[unlikely]] {
+      log_error("[Company_i {}] getAbsencesBetween(), last day before the first day.", ::getTimeStamp());
+      throw CORBA::BAD_PARAM();
+      }
+   return toAbsenceSeq(absences_.overlapping(first, last));
+   }
+
+Organization::AbsenceSeq* Company_i::getEmployeeAbsences(CORBA::Long personId, Basics::Date const& from, Basics::Date const& to) {
+   log_trace<4>("[Company_i {}] getEmployeeAbsences() called by client for ID = {}.", ::getTimeStamp(), personId);
+
+   if (!lookupEmployee(personId)) [[unlikely]] {
+      log_error("[Company_i {}] Employee ID with {} not found. Throwing EmployeeNotFound", ::getTimeStamp(), personId);
+      Organization::EmployeeNotFound ex;
+      ex.requestedId = personId;
+      ex.requestedAt = getTimeStamp();
+      throw ex;
+      }
+
+   std::chrono::sys_days const first { convert<std::chrono::year_month_day>(from) };
+   std::chrono::sys_days const last  { convert<std::chrono::year_month_day>(to) };
+   if (last < first) [[unlikely]] {
+      log_error("[Company_i {}] getEmployeeAbsences(), last day before the first day.", ::getTimeStamp());
+      throw CORBA::BAD_PARAM();
+      }
+   return toAbsenceSeq(absences_.overlapping(personId, first, last));
+   }
+
+std::vector<WorkTimeSummary> Company_i::workTimeForCompany(std::chrono::sys_days from, std::chrono::sys_days to) const {
+   auto const start = std::chrono::steady_clock::now();
+   auto const store = employee_database_.current();
+   auto results = worktime_.compute_all(bookings_, store->ids(), from, to);
+   for (auto& summary : results) applyAbsences(summary);
+   log_trace<2>("[Company_i {}] worked time of {} employees for {} days calculated in {}.", ::getTimeStamp(), results.size(),
+                (to - from).count() + 1, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+   return results;
+   }
+
+bool Company_i::startExport(TimesheetExport::Config config) {
+   auto const store = employee_database_.current();
+   return export_.start(std::move(config), store->ids());
+   }
+
+CORBA::Boolean Company_i::startTimesheetExport(Basics::Date const& from, Basics::Date const& to,
+                                               Organization::EExportFormat format, char const* fileName) {
+   log_trace<4>("[Company_i {}] startTimesheetExport() called by client for file {}.", ::getTimeStamp(), fileName);
+
+   std::chrono::sys_days const first { convert<std::chrono::year_month_day>(from) };
+   std::chrono::sys_days const last  { convert<std::chrono::year_month_day>(to) };
+   // the binary format counts the days of an employee with uint16, a longer range would be truncated
+   if (last < first || (last - first).count() >= TimesheetExport::MaxDays) [[unlikely]] {
+      log_error("[Company_i {}] startTimesheetExport(), invalid range of {} days.", ::getTimeStamp(), (last - first).count() + 1);
+      throw CORBA::BAD_PARAM();
+      }
+
+   // a client may only name a file in the export directory
+   std::filesystem::path const name { fileName };
+   if (name.empty() || name != name.filename() || name == "." || name == "..") [[unlikely]] {
+      log_error("[Company_i {}] startTimesheetExport(), \"{}\" isn't a plain file name.", ::getTimeStamp(), fileName);
+      throw CORBA::BAD_PARAM();
+      }
+
+   return startExport({ .file   = export_directory_ / name,
+                        .format = format == Organization::EXPORT_BINARY ? TimesheetExport::EFormat::Binary : TimesheetExport::EFormat::Csv,
+                        .from   = first, .to = last });
+   }
+
+Organization::ExportProgress* Company_i::getExportProgress() {
+   log_trace<4>("[Company_i {}] getExportProgress() called by client.", ::getTimeStamp());
+   auto const progress = export_.progress();
+   Organization::ExportProgress_var result = new Organization::ExportProgress;
+   result->running   = progress.running;
+   result->finished  = progress.finished;
+   result->employees = static_cast<CORBA::ULong>(progress.employees);
+   result->done      = static_cast<CORBA::ULong>(progress.done);
+   result->bytes     = progress.bytes;
+   result->fileName  = CORBA::string_dup(progress.file.filename().string().c_str());
+   result->error     = CORBA::string_dup(progress.error.c_str());
+   return result._retn();
+   }
+
+Organization::EmployeeDataSeq* Company_i::buildEmployeeDataSequence(EmployeeStore const& store, std::vector<EmployeeStore::row_ty> const& rows) const {
+   log_trace<4>("[Company_i {}] Returning data of {} employees.", ::getTimeStamp(), rows.size());
+   return build_sequence<Organization::EmployeeDataSeq>(rows, [&store](Organization::EmployeeData& target, EmployeeStore::row_ty row) {
+                                                                   store.copy_to(row, target);
+                                                                   });
+   }
@@ -7,8 +7,8 @@
  
   \details This file declares the `Company_i` class, which implements the CORBA interface `Organization::Company`.
            It provides functionality to access company data and manage employee objects.
-           Employees are represented using the placeholder type `EmployeeData` and stored in an in-memory map.
-           Each employee object is instantiated as a separate CORBA servant via the `Employee_i` implementation.
+           Employees are represented using the placeholder type `EmployeeData` and stored in the columnar `EmployeeStore`.
+           All employee references are served by one stateless default servant (`EmployeeDefaultServant_i`).
  
   \version 1.0
   \date    16.05.2025
@@ -39,28 +39,59 @@
 
 #include "Tools.h"
 
-#include "Employee_i.h"
+#include "EmployeeStore.h"
+#include "EmployeeVersions.h"
+#include "EmployeeDefaultServant_i.h"
+#include "EmployeeServantLocator.h"
+#include "EmployeeIterator_i.h"
+#include "EmployeePOA.h"
+#include "EmployeeCache.h"
+#include "BookingLog.h"
+#include "IdempotencyWindow.h"
+#include "BookingJournal.h"
+#include "StateSnapshot.h"
+#include "WorkTimeEngine.h"
+#include "WorkTimeAggregates.h"
+#include "WorkTimeRules.h"
+#include "PresenceBoard.h"
+#include "PresenceEvents.h"
+#include "AbsenceCalendar.h"
+#include "TimesheetExport.h"
+
+#include "CorbaSequenceBuilder.h"
 
 #include <iostream>
 #include <string>
-#include <map>
 #include <chrono>
+#include <optional>
+#include <memory>
+#include <thread>
+#include <shared_mutex>
+#include <filesystem>
 #include <format>
 #include <print>
 
 using namespace std::string_literals;
 
-/// In-memory representation of employee data using a map indexed by employee ID.
-using employee_test_data_ty = std::map<CORBA::Long, EmployeeData>;
-
 /**
   \brief CORBA servant implementation for Organization::Company.
  
   \details This class implements the Organization::Company CORBA interface. It provides methods
            for accessing company information and managing employee records. It also creates
-           and activates CORBA servants for each employee.
+           the references for the employees, which are served by a single default servant or
+           by a servant locator with a bounded cache (see \ref EmployeePOAConfig).
+
+  \details The operations are called concurrently by the dispatch threads of the \ref CORBAServer. The
+           employees are read from immutable versions, the bookings, presence, absences and caches are
+           guarded by their own shards and mutexes. The only lock over several parts is the
+           `publish_gate_`: the bookings and the changes of absences hold it shared from the journal
+           write to the publish, \ref takeSnapshot holds it exclusive while it copies the state. The
+           iterators of \ref getEmployeesIterator are own servants and guard their cursor with an own mutex,
+           the servants of the employees hold no mutable state. The setters of the optional parts
+           (journal, repository, events, export directory) are called before the servant is registered,
+           they aren't synchronized with the operations.
   
-   \note   The map with the Long key and the data source (`EmployeeData`) is temporary and 
+   \note   The columnar store with the data source (`EmployeeData`) is temporary and 
            simulate a database. This will later be replaced with a system-backed implementation 
            (e.g., connected to a database).
  */
@@ -68,19 +99,54 @@ class Company_i : public virtual POA_Organization::Company {
 private:
    const std::string strCompanyName = "Pfefferminza AG"s; ///< name of company for corba interface / implmentation.
 
-   employee_test_data_ty employee_database_;  ///< In-memory employee data (as fast start for tests, later access to database.
+   EmployeeVersions employee_database_;       ///< In-memory columnar employee data as immutable versions, read without locks (as fast start for tests, later access to database.
 
-   PortableServer::POA_var employee_poa_;     ///< POA responsible for Employee servants
+   CORBA::ORB_var          orb_;              ///< ORB of the server, used to resolve the POACurrent
+   PortableServer::POA_var employee_poa_;     ///< POA responsible for Employee references (default servant)
    PortableServer::POA_var company_poa_;      ///< POA responsible for Company servant
 
+   EmployeePOAConfig               employee_config_;     ///< request processing mode of the employee POA
+   PortableServer::ServantBase_var employee_servant_;    ///< default servant for all employee references (DefaultServant mode)
+   PortableServer::ServantLocator_var employee_locator_; ///< servant manager of the employee POA (ServantLocator mode)
+   EmployeeServantLocator*         employee_cache_ = nullptr; ///< typed view of employee_locator_ to read the cache statistics
+   std::unique_ptr<EmployeeCache>  employee_data_cache_;      ///< read-through cache in front of the employee repository (optional)
+
+   BookingLog                      bookings_;                 ///< append-only log of the time bookings, sharded by employee
+   IdempotencyWindow               request_keys_;             ///< request keys of the terminals in the last minutes, drops the retries
+   std::unique_ptr<BookingJournal> journal_;                  ///< durable journal of the accepted bookings (optional)
+   std::shared_mutex               publish_gate_;             ///< shared from the journal write to the publish of a booking, exclusive for the snapshot sequence
+   std::unique_ptr<SnapshotManager> snapshots_;               ///< periodic snapshots, destroyed before the journal (optional)
+   WorkTimeEngine                  worktime_;                 ///< calculation of the worked time from the bookings
+   WorkTimeAggregates              worktime_totals_ { bookings_, worktime_ }; ///< worked time per day, updated with each booking
+   WorkTimeRules                   worktime_rules_ { worktime_ };             ///< rules of the working time (Arbeitszeitgesetz)
+   PresenceBoard                   presence_ { employee_database_, bookings_ }; ///< present employees, updated with COME and GO
+   std::unique_ptr<PresenceEvents> presence_events_;          ///< delta events of the presence to an event channel (optional)
+   AbsenceCalendar                 absences_;                 ///< vacation, sickness and other absences, reduce the target time
+   std::filesystem::path           export_directory_ { "." }; ///< directory of the files of the timesheet export
+   std::jthread                    change_compactor_;         ///< drops the old tombstones of the employee store, see \ref compactEmployeeChanges
+   TimesheetExport                 export_ { worktime_, bookings_, [this](WorkTimeSummary& summary) { applyAbsences(summary); } }; ///< last member, a running export is cancelled first
+
 public:
+   /// maximal number of employees in one page of \ref getEmployeesData and \ref getEmployeesChangedSince
+   static constexpr CORBA::ULong MaxEmployeePageSize = 1'000;
+
+   /// time for which removed employees are delivered by \ref getEmployeesChangedSince
+   static constexpr std::chrono::hours TombstoneRetention { 24 };
+   /// time between two runs of the compaction of the tombstones
+   static constexpr std::chrono::minutes CompactionInterval { 60 };
 
    /**
      \brief Constructor for the Company_i class.
+     \param orb ORB of the server, used by the default servant for the employees.
      \param company_poa POA used to activate the company servant.
-     \param employee_poa POA used to activate employee servants.
+     \param employee_poa POA created with the policies of \ref CreateEmployeePolicies for the employee
+            references (can be nil, then it must be set later with \ref set_employee_poa).
+     \param config mode of the employee POA, must fit to the policies used to create the POA.
+     \param worktime_config rules of the calculation of the worked time, e.g. the time zone of the local days.
+     \throws std::runtime_error if the time zone of worktime_config is unknown
     */
-   Company_i(PortableServer::POA_ptr company_poa, PortableServer::POA_ptr employee_poa);
+   Company_i(CORBA::ORB_ptr orb, PortableServer::POA_ptr company_poa, PortableServer::POA_ptr employee_poa,
+             EmployeePOAConfig const& config = {}, WorkTimeEngine::Config const& worktime_config = {});
 
    /**
      \brief Destructor for the Company_i servant.
@@ -97,8 +163,8 @@ public:
    
      \details This method sets the `employee_poa_` member to the given `PortableServer::POA_ptr`.
               It is expected to be called only once during the initialization phase after the
-              `Company_i` object has been created. The provided POA will later be used to activate
-              transient employee servants (e.g., for `getEmployee()` responses).
+              `Company_i` object has been created. The default servant or the servant locator for the
+              employees is installed at the POA, which is used to create the employee references (e.g., for `getEmployee()` responses).
  
      \param employee_poa Pointer to the POA that will manage employee servant instances.
  
@@ -111,9 +177,107 @@ public:
       if (!CORBA::is_nil(employee_poa_.in()))
          throw std::logic_error(std::format("[{} {}] Employee POA has already been set.", "Company_i::set_employee_poa", ::getTimeStamp()));
       employee_poa_ = PortableServer::POA::_duplicate(employee_poa);
+      install_employee_servant();
       }
 
 
+   /**
+     \brief Replaces the employees of the company, e.g. with the result of the bulk loader.
+     \details The store is published as new version, running requests finish with the previous one.
+     \param store store with the loaded employees
+    */
+   void replaceEmployees(EmployeeStore&& store);
+
+   /**
+     \brief Inserts a new employee or replaces the data of an existing one.
+     \details The change is made in a copy of the current version of the store, which is published
+              afterwards. Readers are never blocked by the write.
+     \param data complete record of the employee
+     \return true if the employee was new
+    */
+   bool storeEmployee(EmployeeData const& data);
+
+   /**
+     \brief Sets an employee to inactive, see \ref storeEmployee for the publication.
+     \param personId id of the employee
+     \return true if the employee was active before
+    */
+   bool deactivateEmployee(CORBA::Long personId);
+
+   /**
+     \brief Removes an employee from the store, the tombstone is delivered by \ref getEmployeesChangedSince.
+     \param personId id of the employee
+     \return true if the employee was removed
+    */
+   bool removeEmployee(CORBA::Long personId);
+
+   /**
+     \brief Places a read-through cache in front of the employee repository.
+     \details After this call every lookup of an employee (`getEmployee()`, `getEmployeeData()`,
+              the bookings, summaries, absences and totals) reads it with the loader (e.g.
+              `FetchEmployee()` with the database pool) through the cache. The store stays the only
+              source of all readers: a record which differs from the store is taken over into the
+              store, an employee missing in the repository is removed from it.
+              Called during the startup before the servant is registered.
+     \param loader function which reads an employee from the repository
+     \param config size, number of shards and lifetimes of the cache
+    */
+   void setEmployeeRepository(EmployeeCache::loader_ty loader, EmployeeCache::Config const& config = {});
+
+   /**
+     \brief Invalidation hook for all operations which change an employee.
+     \details Removes the employee from the read-through cache and the servant from the servant locator,
+              so that the next request reads the changed data.
+     \param personId id of the changed employee
+    */
+   void invalidateEmployee(CORBA::Long personId);
+
+   /**
+     \brief Opens the durable journal of the bookings and restores the booking log from it.
+     \details Called during the startup before the servant is registered. After this call a booking is
+              confirmed only when it is written to the journal.
+     \details With snapshots configured the newest snapshot is loaded first, its employees replace the
+              employee store and only the bookings of the journal behind it are replayed. Then the
+              snapshots are written periodically and the covered segments of the journal are removed.
+     \param config directory and segment size of the journal
+     \param snapshot_config configuration of the snapshots, std::nullopt to work only with the journal
+     \return counters and duration of the replay
+     \throws std::runtime_error if the journal can't be opened or is damaged
+    */
+   BookingJournal::RecoveryStatistics openBookingJournal(BookingJournal::Config config,
+                                                         std::optional<SnapshotManager::Config> snapshot_config = std::nullopt);
+
+   /**
+     \brief Copies the current state for a snapshot, called by the background thread of the snapshot manager.
+     \details The durable sequence of the journal is read before the bookings are copied, while no booking is between
+              the journal and the booking log, see \ref StateSnapshot.
+    */
+   StateSnapshot takeSnapshot();
+
+   /**
+     \brief Connects the presence board to an event channel, each change is pushed as Organization::PresenceChange.
+     \details Called during the startup, the supplier is activated in the company POA.
+     \param channel event channel of the event service
+     \throws CORBA::Exception if the channel can't be reached
+    */
+   void connectPresenceEvents(CosEventChannelAdmin::EventChannel_ptr channel);
+
+   /**
+     \brief Sets the directory for the files of \ref startTimesheetExport, called during the startup.
+    */
+   void setExportDirectory(std::filesystem::path directory) { export_directory_ = std::move(directory); }
+
+   /**
+     \brief Starts the export of the timesheets of all employees of the current store, see \ref TimesheetExport.
+     \param config file, format and range of the export, the file isn't checked
+     \return false if an export is already running
+     \throws std::invalid_argument if the range is longer than TimesheetExport::MaxDays
+    */
+   bool startExport(TimesheetExport::Config config);
+
+   /// \brief export job of the timesheets, e.g. to wait for the end in the command line mode
+   TimesheetExport& timesheetExport() { return export_; }
+
    /**
      \brief Returns the name of the company.
      \return CORBA string representing the company name.
@@ -154,53 +318,314 @@ public:
     */
    virtual Organization::EmployeeData* getEmployeeData(CORBA::Long personId);
 
+   /**
+     \brief Returns the raw data of several employees with one call.
+     \details The ids are sorted and deduplicated, then the store is searched with one merged
+              pass and the reply sequence is allocated once with the number of hits.
+     \param personIds The ids of the requested employees.
+     \return A pointer to an Organization::EmployeeDataBatch with the found records and the missing ids.
+    */
+   virtual Organization::EmployeeDataBatch* getEmployeeDataBatch(Organization::PersonIdSeq const& personIds) override;
+
+   /**
+     \brief Returns a page with the raw data of the employees, ordered by the person id.
+     \details The sequence is allocated once with the size of the page and filled directly
+              from the columns of the store.
+     \param offset position of the first employee in the page.
+     \param limit maximal number of employees, limited to \ref MaxEmployeePageSize (0 means maximum).
+     \return A pointer to an Organization::EmployeeDataPage structure.
+    */
+   virtual Organization::EmployeeDataPage* getEmployeesData(CORBA::ULong offset, CORBA::ULong limit) override;
+
+   /**
+     \brief Returns a page of the employees changed or removed since a version, read from the index of the versions of the store.
+     \details A full resync walks all employees in the order of their versions, see \ref EmployeeStore::changes_since.
+     \param since version of the last call of the client, 0 for the first call
+     \param resync true for the following pages of a full resync
+     \param limit maximal number of changed and removed employees, limited to \ref MaxEmployeePageSize (0 means maximum).
+     \return A pointer to an Organization::EmployeeChanges structure with the version for the next call.
+    */
+   virtual Organization::EmployeeChanges* getEmployeesChangedSince(CORBA::ULongLong since, CORBA::Boolean resync, CORBA::ULong limit) override;
+
+   /**
+     \brief Returns a new iterator over the data of all employees.
+     \return CORBA reference to an EmployeeIterator, the client must call destroy().
+    */
+   virtual Organization::EmployeeIterator_ptr getEmployeesIterator() override;
+
+   /**
+     \brief Returns a new iterator over the data of the active employees.
+     \return CORBA reference to an EmployeeIterator, the client must call destroy().
+    */
+   virtual Organization::EmployeeIterator_ptr getActiveEmployeesIterator() override;
+
+   /**
+     \brief Returns the data of the employees whose last name starts with the prefix.
+     \details Uses the sorted name index of the store, O(log n + k).
+     \param prefix beginning of the last name.
+     \param limit maximal number of employees, limited to \ref MaxEmployeePageSize (0 means maximum).
+     \return A pointer to an Organization::EmployeeDataSeq.
+    */
+   virtual Organization::EmployeeDataSeq* findEmployeesByName(const char* prefix, CORBA::ULong limit) override;
+
+   /**
+     \brief Returns the data of the employees who started between the two dates (both included).
+     \details Uses the ordered start date index of the store, O(log n + k).
+     \return A pointer to an Organization::EmployeeDataSeq.
+    */
+   virtual Organization::EmployeeDataSeq* getEmployeesStartedBetween(Basics::Date const& from, Basics::Date const& to) override;
+
+   /**
+     \brief Books a time event of an employee in the booking log.
+     \details The employee is checked without a global lock, the append takes only the lock of the shard of the employee.
+              With a journal the checked booking is written to the journal first, only after the group commit
+              which wrote it to the disk it is appended to the log, the worked time aggregates and the presence.
+              A booking which wasn't written is therefore never visible, the request key is released again.
+     \details A request key known from the last minutes is answered as duplicate before the booking log is touched,
+              see \ref IdempotencyWindow. The key is reserved with an IdempotencyWindow::Reservation which is committed
+              only for an accepted booking, every other result and every exception releases the key again. Only a
+              committed key is a duplicate, a key whose first request is still in progress is answered with
+              CORBA::TRANSIENT, because that request can still fail.
+     \return result of the booking
+     \throws Organization::EmployeeNotFound
+     \throws CORBA::TRANSIENT if the journal can't write bookings anymore or the request key is still in progress
+    */
+   virtual Organization::EBookingResult bookTimeEvent(CORBA::Long personId, Basics::TimePoint const& timepoint,
+                                                      Organization::EBookingKind kind, CORBA::Long terminalId,
+                                                      CORBA::ULongLong requestKey) override;
+
+   /**
+     \brief Books several time events, each touched shard of the booking log is locked once.
+     \details With a journal all checked bookings of the batch are written with one group commit before they
+              are appended to the log, like in \ref bookTimeEvent. The request keys of the bookings which weren't
+              accepted are released again, also when the journal write fails.
+     \return A pointer to an Organization::BookingResultSeq with the result of each booking.
+     \throws CORBA::TRANSIENT if the journal can't write bookings anymore or a request key of the batch is still in
+             progress, nothing of the batch is booked then
+    */
+   virtual Organization::BookingResultSeq* bookTimeEvents(Organization::TimeBookingSeq const& bookings) override;
+
+   /**
+     \brief Calculates the worked time of an employee from the booking log, see \ref WorkTimeEngine.
+     \return A pointer to an Organization::WorkTimeSummary with the days, weeks and months of the range.
+     \throws Organization::EmployeeNotFound
+     \throws CORBA::BAD_PARAM if to is before from or the range is longer than WorkTimeEngine::Config::max_days
+    */
+   virtual Organization::WorkTimeSummary* getWorkTimeSummary(CORBA::Long personId, Basics::Date const& from, Basics::Date const& to) override;
+
+   /**
+     \brief Returns the worked time of an employee up to a day from the incremental aggregates, see \ref WorkTimeAggregates.
+     \return An Organization::WorkTimeTotals with the day, the week and the month, a fixed length structure returned by value.
+     \throws Organization::EmployeeNotFound
+     \throws CORBA::BAD_PARAM if the day isn't a valid date or is later than tomorrow
+    */
+   virtual Organization::WorkTimeTotals getWorkTimeTotals(CORBA::Long personId, Basics::Date const& day) override;
+
+   /**
+     \brief Checks the rules of the working time for all employees in parallel, see \ref WorkTimeRules.
+     \return A pointer to an Organization::WorkTimeViolationSeq, ordered by the employees and the days.
+     \throws CORBA::BAD_PARAM if to is before from or the range is longer than WorkTimeEngine::Config::max_days
+    */
+   virtual Organization::WorkTimeViolationSeq* checkWorkTimeRules(Basics::Date const& from, Basics::Date const& to) override;
+
+   /**
+     \brief Returns the present employees from the presence board, see \ref PresenceBoard.
+     \return A pointer to an Organization::PersonIdSeq with the ids in ascending order.
+    */
+   virtual Organization::PersonIdSeq* getPresentEmployees() override;
+
+   /**
+     \brief Returns the number of present employees, read from a counter of the presence board.
+    */
+   virtual CORBA::ULong getPresenceCount() override;
+
+   /**
+     \brief Adds an absence to the absence calendar, see \ref AbsenceCalendar.
+     \details With a journal the absence is written to the journal before it is added to the calendar,
+              like the changes of removeAbsence and approveAbsence.
+     \return id of the new absence
+     \throws Organization::EmployeeNotFound
+     \throws CORBA::BAD_PARAM if to is before from or the absence is longer than BookingJournal::MaxAbsenceDays
+     \throws CORBA::TRANSIENT if the absence couldn't be written to the journal
+    */
+   virtual CORBA::ULongLong addAbsence(CORBA::Long personId, Basics::Date const& from, Basics::Date const& to,
+                                       Organization::EAbsenceKind kind, CORBA::Boolean approved) override;
+
+   /// \brief Removes an absence, \return false if there is no absence with the id \throws CORBA::TRANSIENT like addAbsence
+   virtual CORBA::Boolean removeAbsence(CORBA::ULongLong absenceId) override;
+
+   /// \brief Approves an absence or withdraws the approval, \return false if there is no absence with the id \throws CORBA::TRANSIENT like addAbsence
+   virtual CORBA::Boolean approveAbsence(CORBA::ULongLong absenceId, CORBA::Boolean approved) override;
+
+   /**
+     \brief Returns the absences of all employees overlapping the range, read from the interval tree of the calendar.
+     \return A pointer to an Organization::AbsenceSeq ordered by the first day.
+     \throws CORBA::BAD_PARAM if to is before from
+    */
+   virtual Organization::AbsenceSeq* getAbsencesBetween(Basics::Date const& from, Basics::Date const& to) override;
+
+   /**
+     \brief Returns the absences of an employee overlapping the range.
+     \return A pointer to an Organization::AbsenceSeq ordered by the first day.
+     \throws Organization::EmployeeNotFound
+     \throws CORBA::BAD_PARAM if to is before from
+    */
+   virtual Organization::AbsenceSeq* getEmployeeAbsences(CORBA::Long personId, Basics::Date const& from, Basics::Date const& to) override;
+
+   /**
+     \brief Starts the export of the timesheets into a file of the export directory, see \ref TimesheetExport.
+     \return false if an export is already running
+     \throws CORBA::BAD_PARAM if to is before from, the range is longer than TimesheetExport::MaxDays or the file name isn't a plain file name
+    */
+   virtual CORBA::Boolean startTimesheetExport(Basics::Date const& from, Basics::Date const& to,
+                                               Organization::EExportFormat format, char const* fileName) override;
+
+   /**
+     \brief Returns the progress of the current or the last export of the timesheets.
+     \return A pointer to an Organization::ExportProgress structure.
+    */
+   virtual Organization::ExportProgress* getExportProgress() override;
+
+   /**
+     \brief Calculates the worked time of all employees in parallel, e.g. for the month-end run.
+     \param from first day of the range
+     \param to last day of the range
+     \return worked time of each employee of the store, in the order of the person ids
+    */
+   std::vector<WorkTimeSummary> workTimeForCompany(std::chrono::sys_days from, std::chrono::sys_days to) const;
+
    /**
      \brief Calculates the total salary of all active employees.
      \return Sum of all active employee salaries.
     */
    virtual double                  getSumSalary() override;
 
+   /**
+     \brief Returns the salary statistics from the running aggregates of the employee store.
+     \return A pointer to an Organization::SalaryStatistics structure.
+    */
+   virtual Organization::SalaryStatistics* getSalaryStatistics() override;
+
+   /**
+     \brief Returns the counters of the servant cache of the employee POA.
+     \return statistics of the cache, or std::nullopt when the POA works with a default servant.
+    */
+   std::optional<EmployeeServantLocator::Statistics> employeeCacheStatistics() const;
+
+   /**
+     \brief Returns the counters of the read-through cache in front of the employee repository.
+     \return statistics of the cache, or std::nullopt when no repository was set.
+    */
+   std::optional<EmployeeCache::Statistics> employeeDataCacheStatistics() const;
+
+   /// \brief log of the time bookings, read by the evaluation of the work time
+   BookingLog const& bookings() const { return bookings_; }
+
 private:
    /**
      \brief Initializes the in-memory employee database with test data.
    */
    void initializeDatabase();
 
+   /**
+     \brief Installs the default servant or the servant locator for the employee references at the employee POA.
+     \pre The employee POA was created with the policies of \ref CreateEmployeePolicies for the configured mode.
+    */
+   void install_employee_servant();
+
+   /**
+     \brief Reads an employee through the read-through cache, or from the store when no repository was set.
+     \details With a repository the store is aligned to the result with \ref adoptEmployee, so the
+              servants and all other operations, which read the store, see the same employee.
+     \return record of the employee, std::nullopt if the employee doesn't exist
+    */
+   std::optional<EmployeeData> lookupEmployee(CORBA::Long personId);
+
+   /**
+     \brief Takes the record of the repository over into the store.
+     \details The change is made only when the employee in the store is still the one seen by the
+              lookup, a concurrent write with \ref storeEmployee isn't overwritten with older data.
+     \param personId id of the employee
+     \param seen record of the store when the lookup started, std::nullopt if it wasn't in the store
+     \param data record of the repository, std::nullopt removes the employee from the store
+     \return true if the store was changed
+    */
+   bool adoptEmployee(CORBA::Long personId, std::optional<EmployeeData> const& seen, std::optional<EmployeeData> const& data);
+
+   /**
+     \brief Creates an employee reference without activating a servant.
+     \details The person id is encoded in the ObjectId, the request is later dispatched
+              to the default servant or the servant locator of the employee POA.
+     \param personId The unique ID of the employee.
+     \return new CORBA Employee object reference, the caller takes the ownership
+    */
+   Organization::Employee_ptr createEmployeeReference(CORBA::Long personId);
+
+   /**
+     \brief Creates and activates an EmployeeIterator_i servant at the company POA.
+     \param only_active true if the iterator should skip the inactive employees
+     \return new CORBA reference to the iterator, the caller takes the ownership
+    */
+   Organization::EmployeeIterator_ptr createEmployeeIterator(bool only_active);
+
+   /**
+     \brief Drops the tombstones older than \ref TombstoneRetention, called by the background thread.
+     \details The store is only copied when there is a tombstone to drop.
+    */
+   void compactEmployeeChanges();
+
+   /// \brief applies an accepted booking to the presence board and queues a change for the event channel
+   void publishPresence(TimeBookingEvent const& event);
+
+   /// \brief sets the target time of the days with an approved absence to zero
+   void applyAbsences(WorkTimeSummary& summary) const;
+
+   /**
+     \brief Writes a change of the absence calendar to the journal before it is applied.
+     \pre the caller holds publish_gate_ shared, so a snapshot doesn't cover the change before it is applied
+     \throws CORBA::TRANSIENT if the journal isn't healthy or the write failed
+    */
+   void writeAbsenceChange(AbsenceChange const& change);
+
+   /// \brief target time of the days with an approved absence of an employee in the range [from, to]
+   std::chrono::milliseconds absentTarget(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /**
+     \brief Builds a CORBA sequence with the data of the employees in the given rows.
+     \param store version of the employee store which determined the rows
+     \param rows rows of the employee store
+     \return CORBA sequence of EmployeeData, the caller takes the ownership
+    */
+   Organization::EmployeeDataSeq* buildEmployeeDataSequence(EmployeeStore const& store, std::vector<EmployeeStore::row_ty> const& rows) const;
+
    /**
      \brief Builds a CORBA sequence of Employee object references from a range.
-     \tparam range_ty A range of EmployeeData elements.
+     \details The sequence is allocated once for sized ranges and grows geometrically otherwise
+              (see \ref CorbaSequenceBuilder).
+     \tparam range_ty A range of person ids (CORBA::Long).
      \param range Input range from which to build the sequence.
      \return CORBA sequence of Employee object references.
     */
    template <std::ranges::input_range range_ty>
    Organization::EmployeeSeq* buildEmploySequenceFromRange(range_ty &&range) {
-      Organization::EmployeeSeq_var employees_seq = new Organization::EmployeeSeq;
-      CORBA::Long current_index = 0;
+      CorbaSequenceBuilder<Organization::EmployeeSeq> employees_seq;
+      if constexpr (std::ranges::sized_range<range_ty>)
+         employees_seq.reserve(static_cast<CORBA::ULong>(std::ranges::size(range)));
 
-      for(auto const& data : range) {
+      for(CORBA::Long personId : range) {
          try {
-            Employee_i* employee_servant = new Employee_i(data, employee_poa_.in());
-            PortableServer::ObjectId_var oid = employee_poa_->activate_object(employee_servant);
-            CORBA::Object_var obj_ref = employee_poa_->id_to_reference(oid.in());
-            Organization::Employee_var employee_ref = Organization::Employee::_narrow(obj_ref.in());
-
-            if(CORBA::is_nil(employee_ref)) {
-               std::println(std::cerr, "Company_i {}] error while narrowing employee for id {}", ::getTimeStamp(), employee_servant->personId());
-               continue;
-               }
-            employee_servant->set_oid(oid);
-            employees_seq->length(current_index + 1);
-            (*employees_seq)[current_index++] = employee_ref._retn();
+            Organization::Employee_var employee_ref = createEmployeeReference(personId);
+            employees_seq.push_back(employee_ref._retn());
             }
          catch(CORBA::Exception const& ex) {
-            std::println(std::cerr, "[Company_i {}] Corba Exception for Employee {}: {}", ::getTimeStamp(), data.personID, toString(ex));
+            std::println(std::cerr, "[Company_i {}] Corba Exception for Employee {}: {}", ::getTimeStamp(), personId, toString(ex));
             }
          catch(std::exception const& ex) {
-            std::println(std::cerr, "[Company_i {}] C++ Exception for Employee {}: {}", ::getTimeStamp(), data.personID, ex.what());
+            std::println(std::cerr, "[Company_i {}] C++ Exception for Employee {}: {}", ::getTimeStamp(), personId, ex.what());
             }
          }
-      std::println(std::cout, "[Company_i {}] Returnning {} employees references.", ::getTimeStamp(), employees_seq->length());
-      return employees_seq._retn();
+      std::println(std::cout, "[Company_i {}] Returnning {} employees references.", ::getTimeStamp(), employees_seq.size());
+      return employees_seq.release();
       }
 
 };
@@ -0,0 +1,351 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Thread safe pool of database connections with a statement cache for each connection.
+
+  \details This header declares the class template `DatabasePool`. The pool opens a fixed number
+           of connections of the adecc Database layer (`TMyDatabase<framework, server>`) and lends
+           them to the request threads with a RAII `Lease`. Each connection keeps the queries it
+           created, so a statement is prepared once per connection and executed again with new
+           parameters by the following requests.
+
+  \details The pool depends only on the connection and the query type. With the same Qt SQL
+           abstraction it can be used with the MS SQL server of the production or with a local
+           SQLite database as stand-in, only the open function passed to the pool differs.
+
+  \version 1.0
+  \date    30.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see EmployeeStatements.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stop_token>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <format>
+#include <cstdint>
+
+using namespace std::string_literals;
+
+/**
+  \brief Pool of database connections with prepared statement cache.
+
+  \tparam connection_ty type of the connection, e.g. `TMyDatabase<TMyQtDb, TMyMSSQL>`
+  \tparam query_ty type of the query created with `connection_ty::CreateQuery()`
+
+  \details The connections are opened in the constructor with the open function, the same
+           function reopens a connection which failed the health check. A thread which
+           doesn't get a connection within the timeout receives a `std::runtime_error`.
+           With a `health_check_interval` a background thread checks the idle connections
+           periodically and logs the metrics of the pool. The check takes one connection at a
+           time out of the pool, so the other connections stay available for the requests. A
+           connection whose reopen failed is marked as broken, the next `acquire()` or health
+           check which takes it tries to open it again before it is used.
+
+  \note A leased connection is used by one thread at the same time only, the statements of a
+        connection need no further synchronisation.
+ */
+template <typename connection_ty, typename query_ty>
+class DatabasePool {
+public:
+   /// \brief function which opens (or reopens) a connection in place, e.g. `Connect()` of the AppServer
+   using open_func_ty = std::function<void (connection_ty&)>;
+
+   /// \brief configuration of the pool
+   struct Config {
+      std::size_t               size             = 4;                          ///< number of connections
+      std::chrono::milliseconds acquire_timeout  = std::chrono::seconds { 5 }; ///< maximal waiting time for a connection
+      std::string               health_check_sql = "SELECT 1"s;                ///< statement used by the health check
+      std::chrono::milliseconds health_check_interval = { };                   ///< period of the background health check, 0 = no check
+      };
+
+   /// \brief counters of the pool
+   struct Metrics {
+      std::uint64_t acquired            = 0; ///< successful calls of acquire()
+      std::uint64_t timeouts            = 0; ///< calls of acquire() which ran into the timeout
+      std::uint64_t waits               = 0; ///< calls of acquire() which had to wait for a connection
+      std::uint64_t statements_prepared = 0; ///< statements created with CreateQuery
+      std::uint64_t statements_reused   = 0; ///< executions with an already prepared statement
+      std::uint64_t health_failures     = 0; ///< connections which failed the health check
+      std::uint64_t reconnects          = 0; ///< successful reopens after a failure
+      std::size_t   size                = 0; ///< number of connections
+      std::size_t   idle                = 0; ///< connections currently in the pool
+      std::size_t   broken              = 0; ///< connections whose reopen failed, reopened before the next use
+      };
+
+private:
+   /// \brief connection with its cache of prepared statements
+   struct Slot {
+      connection_ty                              connection;
+      std::unordered_map<std::string, query_ty>  statements; ///< name → prepared query
+      bool                                       broken = false; ///< reopen failed, changed only by the thread which took the slot
+      };
+
+   Config                             config_;
+   open_func_ty                       open_;
+   std::vector<std::unique_ptr<Slot>> slots_;       ///< all connections, owned by the pool
+   std::vector<Slot*>                 idle_;        ///< connections which can be leased
+   mutable std::mutex                 mutex_;       ///< protects idle_
+   std::condition_variable            available_;   ///< signaled when a connection is returned
+
+   std::atomic<std::uint64_t>         acquired_            = 0;
+   std::atomic<std::uint64_t>         timeouts_            = 0;
+   std::atomic<std::uint64_t>         waits_               = 0;
+   std::atomic<std::uint64_t>         statements_prepared_ = 0;
+   std::atomic<std::uint64_t>         statements_reused_   = 0;
+   std::atomic<std::uint64_t>         health_failures_     = 0;
+   std::atomic<std::uint64_t>         reconnects_          = 0;
+   std::atomic<std::size_t>           broken_              = 0;
+   std::jthread                       health_checker_;   ///< periodic health check, last member, stopped first
+
+public:
+   /**
+     \brief RAII lease of a connection, the connection returns into the pool with the destructor.
+    */
+   class Lease {
+      friend class DatabasePool;
+   private:
+      DatabasePool* pool_ = nullptr;
+      Slot*         slot_ = nullptr;
+
+      Lease(DatabasePool* pool, Slot* slot) : pool_(pool), slot_(slot) {}
+
+   public:
+      Lease(Lease const&) = delete;
+      Lease& operator = (Lease const&) = delete;
+      Lease(Lease&& other) noexcept : pool_(std::exchange(other.pool_, nullptr)), slot_(std::exchange(other.slot_, nullptr)) {}
+      Lease& operator = (Lease&& other) noexcept {
+         if (this != &other) {
+            release();
+            pool_ = std::exchange(other.pool_, nullptr);
+            slot_ = std::exchange(other.slot_, nullptr);
+            }
+         return *this;
+         }
+      ~Lease() { release(); }
+
+      /// \brief the leased connection
+      connection_ty& connection() { return slot_->connection; }
+
+      /**
+        \brief Returns the prepared statement with the name, the statement is created at the first use.
+        \param name key of the statement in the cache of the connection
+        \param sql text of the statement, only used when the statement isn't in the cache yet
+        \return query which can be executed with new parameters
+       */
+      query_ty& statement(std::string const& name, std::string const& sql) {
+         if (auto it = slot_->statements.find(name); it != slot_->statements.end()) {
+            ++pool_->statements_reused_;
+            return it->second;
+            }
+         ++pool_->statements_prepared_;
+         return slot_->statements.emplace(name, slot_->connection.CreateQuery(sql)).first->second;
+         }
+
+   private:
+      void release() {
+         if (pool_ != nullptr && slot_ != nullptr) pool_->give_back(slot_);
+         pool_ = nullptr;
+         slot_ = nullptr;
+         }
+      };
+
+   DatabasePool() = delete;
+   DatabasePool(DatabasePool const&) = delete;
+   DatabasePool& operator = (DatabasePool const&) = delete;
+
+   /**
+     \brief Opens all connections of the pool.
+     \param config size, timeout and health check statement
+     \param open function which opens a connection in place
+     \throws std::invalid_argument for a pool size of 0, exceptions of the open function are passed through
+    */
+   DatabasePool(Config config, open_func_ty open) : config_(std::move(config)), open_(std::move(open)) {
+      if (config_.size == 0)
+         throw std::invalid_argument(std::format("[DatabasePool {}] pool size must be greater than 0.", ::getTimeStamp()));
+      slots_.reserve(config_.size);
+      idle_.reserve(config_.size);
+      for (std::size_t i = 0; i < config_.size; ++i) {
+         auto slot = std::make_unique<Slot>();
+         open_(slot->connection);
+         idle_.emplace_back(slot.get());
+         slots_.emplace_back(std::move(slot));
+         }
+      log_trace<2>("[DatabasePool {}] {} database connections opened.", ::getTimeStamp(), slots_.size());
+      if (config_.health_check_interval > std::chrono::milliseconds::zero())
+         health_checker_ = std::jthread([this](std::stop_token token) { run_health_checks(token); });
+      }
+
+   ~DatabasePool() {
+      log_trace<2>("[DatabasePool {}] pool closed, {} connections acquired, {} statements prepared, {} reused.", ::getTimeStamp(),
+                   acquired_.load(), statements_prepared_.load(), statements_reused_.load());
+      }
+
+   /**
+     \brief Leases a connection from the pool.
+     \details A connection marked as broken is reopened first, the lease returns it into the pool
+              when the reopen fails again.
+     \throws std::runtime_error if no connection is returned within the acquire timeout or the
+             reopen of a broken connection fails
+    */
+   Lease acquire() {
+      Slot* slot = nullptr;
+         {
+         std::unique_lock lock(mutex_);
+         if (idle_.empty()) {
+            ++waits_;
+            if (!available_.wait_for(lock, config_.acquire_timeout, [this] { return !idle_.empty(); })) {
+               ++timeouts_;
+               throw std::runtime_error(std::format("[DatabasePool {}] no database connection available within {}.",
+                                                    ::getTimeStamp(), config_.acquire_timeout));
+               }
+            }
+         slot = idle_.back();
+         idle_.pop_back();
+         }
+      Lease lease(this, slot);
+      if (slot->broken && !reopen(*slot))
+         throw std::runtime_error(std::format("[DatabasePool {}] broken database connection couldn't be reopened.", ::getTimeStamp()));
+      ++acquired_;
+      return lease;
+      }
+
+   /**
+     \brief Executes the health check statement on the idle connections, one connection at a time.
+     \details Each connection is taken out of the pool only for its own check, the requests can
+              lease the others meanwhile. Leased connections are skipped, they are checked by the
+              next run. A connection which fails is reopened with the open function, its statement
+              cache is dropped because the prepared statements belong to the old connection. A
+              broken connection isn't executed, only reopened.
+     \return number of connections which failed the check
+    */
+   std::size_t check_health() {
+      std::size_t failures = 0;
+      for (auto const& owned : slots_) {
+         Slot* slot = owned.get();
+         bool taken = false;
+            {
+            std::lock_guard lock(mutex_);
+            if (auto it = std::ranges::find(idle_, slot); it != idle_.end()) {
+               idle_.erase(it);
+               taken = true;
+               }
+            }
+         if (!taken) continue;
+
+         if (slot->broken) {
+            ++failures;
+            reopen(*slot);
+            }
+         else {
+            try {
+               auto query = slot->connection.CreateQuery(config_.health_check_sql);
+               query.Execute({ });
+               }
+            catch (std::exception const& ex) {
+               ++failures;
+               ++health_failures_;
+               log_error("[DatabasePool {}] health check failed: {}", ::getTimeStamp(), ex.what());
+               reopen(*slot);
+               }
+            }
+         give_back(slot);
+         }
+      return failures;
+      }
+
+   /// \brief number of connections of the pool, the maximal number of parallel leases
+   std::size_t size() const { return slots_.size(); }
+
+   /// \brief current counters of the pool
+   Metrics metrics() const {
+      std::lock_guard lock(mutex_);
+      return { .acquired = acquired_, .timeouts = timeouts_, .waits = waits_,
+               .statements_prepared = statements_prepared_, .statements_reused = statements_reused_,
+               .health_failures = health_failures_, .reconnects = reconnects_,
+               .size = slots_.size(), .idle = idle_.size(), .broken = broken_ };
+      }
+
+private:
+   /// \brief loop of the background thread, checks the idle connections in the interval of the configuration
+   void run_health_checks(std::stop_token token) {
+      std::mutex mutex;
+      std::condition_variable_any wakeup;
+      std::unique_lock lock(mutex);
+      while (!wakeup.wait_for(lock, token, config_.health_check_interval, [&token]() { return token.stop_requested(); })) {
+         auto const failures = check_health();
+         auto const current  = metrics();
+         log_trace<4>("[DatabasePool {}] health check: {} failures, {} of {} connections idle, {} broken, {} acquired, {} waits, "
+                      "{} timeouts, {} statements prepared, {} reused, {} reconnects.", ::getTimeStamp(), failures, current.idle,
+                      current.size, current.broken, current.acquired, current.waits, current.timeouts, current.statements_prepared,
+                      current.statements_reused, current.reconnects);
+         }
+      }
+
+   /**
+     \brief Opens the connection of a slot again, called only by the thread which took the slot.
+     \details The statement cache is dropped, the prepared statements belong to the old connection.
+              A failed reopen marks the slot as broken, so the next user tries it again.
+     \return true if the connection is open again
+    */
+   bool reopen(Slot& slot) {
+      slot.statements.clear();
+      try {
+         slot.connection = connection_ty { };
+         open_(slot.connection);
+         ++reconnects_;
+         if (std::exchange(slot.broken, false)) --broken_;
+         return true;
+         }
+      catch (std::exception const& ex) {
+         log_error("[DatabasePool {}] reconnect failed: {}", ::getTimeStamp(), ex.what());
+         if (!std::exchange(slot.broken, true)) ++broken_;
+         return false;
+         }
+      }
+
+   void give_back(Slot* slot) {
+         {
+         std::lock_guard lock(mutex_);
+         idle_.emplace_back(slot);
+         }
+      available_.notify_one();
+      }
+   };
@@ -0,0 +1,90 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Helpers for the durable files of the server, the booking journal and the snapshots.
+
+  \details `crc32()` is the standard CRC-32 (polynomial 0xEDB88320, as used by zip and Ethernet)
+           with a table which is calculated at compile time. The function can continue a checksum,
+           so a large payload can be checked in several parts.
+
+  \details `SyncDirectory()` makes a new or renamed file in a directory durable. POSIX systems need
+           a sync of the directory for this, on Windows the function does nothing.
+
+  \version 1.0
+  \date    11.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see BookingJournal.h
+  \see StateSnapshot.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include <ace/OS_NS_fcntl.h>
+#include <ace/OS_NS_unistd.h>
+
+#include <array>
+#include <filesystem>
+#include <cstddef>
+#include <cstdint>
+
+namespace crc32_detail {
+   inline constexpr auto table = [] {
+      std::array<std::uint32_t, 256> values {};
+      for (std::uint32_t i = 0; i < values.size(); ++i) {
+         std::uint32_t value = i;
+         for (int bit = 0; bit < 8; ++bit) value = (value & 1u) ? 0xEDB8'8320u ^ (value >> 1) : value >> 1;
+         values[i] = value;
+         }
+      return values;
+      }();
+   }
+
+/**
+  \brief Calculates the CRC-32 of a memory block.
+  \param data begin of the block
+  \param size size of the block in bytes
+  \param crc result of a previous call to continue the checksum over several blocks (0 for the first block)
+  \return checksum of all blocks up to this one
+ */
+inline std::uint32_t crc32(void const* data, std::size_t size, std::uint32_t crc = 0) {
+   auto const* bytes = static_cast<unsigned char const*>(data);
+   crc ^= 0xFFFF'FFFFu;
+   for (std::size_t i = 0; i < size; ++i) crc = crc32_detail::table[(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8);
+   return crc ^ 0xFFFF'FFFFu;
+   }
+
+/**
+  \brief Syncs the entries of a directory, e.g. after a file was created or renamed.
+  \return false if the directory can't be opened or synced
+ */
+inline bool SyncDirectory(std::filesystem::path const& directory) {
+#ifdef _WIN32
+   return true;
+#else
+   ACE_HANDLE handle = ACE_OS::open(directory.string().c_str(), O_RDONLY);
+   if (handle == ACE_INVALID_HANDLE) return false;
+   bool const synced = ACE_OS::fsync(handle) == 0;
+   ACE_OS::close(handle);
+   return synced;
+#endif
+   }
@@ -0,0 +1,133 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the sharded read-through cache for employee records
+
+  \details Every shard combines a LRU list with a hash map of the positions. Expired entries are
+           removed when they are requested, the capacity of a shard is enforced after each load.
+
+  \version 1.0
+  \date    04.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "EmployeeCache.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <algorithm>
+
+EmployeeCache::EmployeeCache(Config const& config, loader_ty loader) : config_(config), loader_(std::move(loader)) {
+   config_.shards   = std::max<std::size_t>(config_.shards, 1);
+   shard_capacity_  = std::max<std::size_t>(config_.capacity / config_.shards, 1);
+   shards_.reserve(config_.shards);
+   for (std::size_t i = 0; i < config_.shards; ++i) shards_.emplace_back(std::make_unique<Shard>());
+   log_trace<4>("[EmployeeCache {}] Cache created with {} shards of {} entries.", ::getTimeStamp(), config_.shards, shard_capacity_);
+   }
+
+EmployeeCache::~EmployeeCache() {
+   auto stat = statistics();
+   log_trace<4>("[EmployeeCache {}] Cache destroyed, hits: {}, negative hits: {}, misses: {}, average load: {}.", ::getTimeStamp(),
+                stat.hits, stat.negative_hits, stat.misses, stat.average_load_time());
+   }
+
+std::optional<EmployeeData> EmployeeCache::get(CORBA::Long personId) {
+   Shard& current = shard(personId);
+   auto const now = clock_ty::now();
+   std::uint64_t generation = 0;
+      {
+      std::lock_guard lock(current.mutex);
+      if (auto it = current.map.find(personId); it != current.map.end()) {
+         if (it->second->expires > now) [[likely]] {
+            current.lru.splice(current.lru.begin(), current.lru, it->second);
+            ++(it->second->data ? hits_ : negative_hits_);
+            return it->second->data;
+            }
+         current.lru.erase(it->second);
+         current.map.erase(it);
+         ++expirations_;
+         }
+      generation = current.generation;
+      }
+
+   ++misses_;
+   auto const start = clock_ty::now();
+   auto data = loader_(personId);
+   auto const loaded = clock_ty::now();
+   load_time_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(loaded - start).count();
+   log_trace<5>("[EmployeeCache {}] Employee {} loaded ({}).", ::getTimeStamp(), personId, data ? "found" : "not found");
+
+      {
+      std::lock_guard lock(current.mutex);
+      if (current.generation != generation) {
+         // a write invalidated the shard while the employee was loaded, the result may be older than the write
+         ++stale_loads_;
+         return data;
+         }
+      if (auto it = current.map.find(personId); it != current.map.end()) {
+         current.lru.erase(it->second);
+         current.map.erase(it);
+         }
+      current.lru.emplace_front(Entry { personId, data, loaded + (data ? config_.ttl : config_.negative_ttl) });
+      current.map.emplace(personId, current.lru.begin());
+      while (current.lru.size() > shard_capacity_) {
+         current.map.erase(current.lru.back().personId);
+         current.lru.pop_back();
+         ++evictions_;
+         }
+      }
+   return data;
+   }
+
+void EmployeeCache::invalidate(CORBA::Long personId) {
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   ++current.generation;
+   if (auto it = current.map.find(personId); it != current.map.end()) {
+      current.lru.erase(it->second);
+      current.map.erase(it);
+      ++invalidations_;
+      }
+   }
+
+void EmployeeCache::invalidate_all() {
+   for (auto& current : shards_) {
+      std::lock_guard lock(current->mutex);
+      invalidations_ += current->lru.size();
+      ++current->generation;
+      current->lru.clear();
+      current->map.clear();
+      }
+   log_trace<4>("[EmployeeCache {}] All entries invalidated.", ::getTimeStamp());
+   }
+
+EmployeeCache::Statistics EmployeeCache::statistics() const {
+   std::size_t size = 0;
+   for (auto const& current : shards_) {
+      std::lock_guard lock(current->mutex);
+      size += current->lru.size();
+      }
+   return { .hits = hits_, .negative_hits = negative_hits_, .misses = misses_, .expirations = expirations_,
+            .evictions = evictions_, .invalidations = invalidations_, .stale_loads = stale_loads_,
+            .load_time = std::chrono::nanoseconds { load_time_ns_.load() }, .size = size };
+   }
@@ -0,0 +1,160 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Sharded read-through cache for employee records in front of the employee repository.
+
+  \details This header declares the class `EmployeeCache`. A request for an employee is served
+           from the cache when the entry is younger than the time to live, otherwise the record
+           is read with the loader function (e.g. a query of the database) and stored in the cache.
+           An unknown person id is cached as negative entry too, so that repeated requests for a
+           wrong id (e.g. an unknown RFID card) don't reach the database each time.
+
+  \details The keys are distributed over several shards, each with an own mutex and LRU list,
+           so that parallel requests for different employees rarely wait for each other. Write
+           operations call \ref EmployeeCache::invalidate for the changed employee.
+
+  \version 1.0
+  \date    04.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see EmployeeLoader.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "EmployeeData.h"
+
+#include <list>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <optional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+  \brief Read-through cache with TTL, LRU bound, negative entries and invalidation.
+
+  \note The loader is called without a lock of the shard. When two threads miss the same id at the
+        same time, both load it and the later result is stored. Each shard counts its invalidations
+        in a generation, a result whose load overlapped an invalidation of the shard is returned to
+        the caller but not stored, so an invalidation can't be overwritten with the old data.
+ */
+class EmployeeCache {
+public:
+   using clock_ty  = std::chrono::steady_clock;
+   /// \brief reads an employee from the repository, std::nullopt if the id doesn't exist
+   using loader_ty = std::function<std::optional<EmployeeData> (CORBA::Long)>;
+
+   /// \brief configuration of the cache
+   struct Config {
+      std::size_t               shards          = 16;                          ///< number of independent shards
+      std::size_t               capacity        = 10'000;                      ///< maximal number of entries over all shards
+      std::chrono::milliseconds ttl             = std::chrono::minutes { 5 };  ///< lifetime of a found employee
+      std::chrono::milliseconds negative_ttl    = std::chrono::seconds { 30 }; ///< lifetime of a negative entry
+      };
+
+   /// \brief counters of the cache
+   struct Statistics {
+      std::uint64_t hits          = 0; ///< requests served with a found employee
+      std::uint64_t negative_hits = 0; ///< requests served with a cached "not found"
+      std::uint64_t misses        = 0; ///< requests which called the loader
+      std::uint64_t expirations   = 0; ///< entries removed because of the TTL
+      std::uint64_t evictions     = 0; ///< entries removed because of the capacity
+      std::uint64_t invalidations = 0; ///< entries removed by invalidate()
+      std::uint64_t stale_loads   = 0; ///< loaded results not stored because of an invalidation during the load
+      std::chrono::nanoseconds load_time = {}; ///< summarized time of all loader calls
+      std::size_t   size          = 0; ///< current number of entries
+
+      /// \brief average duration of a loader call
+      std::chrono::nanoseconds average_load_time() const {
+         return misses > 0 ? load_time / static_cast<std::int64_t>(misses) : std::chrono::nanoseconds { 0 };
+         }
+      };
+
+private:
+   struct Entry {
+      CORBA::Long                 personId;
+      std::optional<EmployeeData> data;     ///< std::nullopt for a negative entry
+      clock_ty::time_point        expires;
+      };
+
+   using lru_list_ty = std::list<Entry>;
+
+   struct Shard {
+      std::mutex                                            mutex;
+      lru_list_ty                                           lru;   ///< most recently used at the front
+      std::unordered_map<CORBA::Long, lru_list_ty::iterator> map;
+      std::uint64_t                                         generation = 0; ///< incremented by each invalidation of the shard
+      };
+
+   Config                               config_;
+   loader_ty                            loader_;
+   std::size_t                          shard_capacity_;
+   std::vector<std::unique_ptr<Shard>>  shards_;
+
+   std::atomic<std::uint64_t>           hits_          = 0;
+   std::atomic<std::uint64_t>           negative_hits_ = 0;
+   std::atomic<std::uint64_t>           misses_        = 0;
+   std::atomic<std::uint64_t>           expirations_   = 0;
+   std::atomic<std::uint64_t>           evictions_     = 0;
+   std::atomic<std::uint64_t>           invalidations_ = 0;
+   std::atomic<std::uint64_t>           stale_loads_   = 0;
+   std::atomic<std::int64_t>            load_time_ns_  = 0;
+
+public:
+   EmployeeCache() = delete;
+   EmployeeCache(EmployeeCache const&) = delete;
+   EmployeeCache& operator = (EmployeeCache const&) = delete;
+
+   /**
+     \brief Constructs the cache.
+     \param config size, number of shards and lifetimes
+     \param loader function which reads an employee from the repository
+    */
+   EmployeeCache(Config const& config, loader_ty loader);
+   ~EmployeeCache();
+
+   /**
+     \brief Returns the employee from the cache or reads it with the loader.
+     \return record of the employee, std::nullopt if the employee doesn't exist
+     \note Exceptions of the loader are passed through, nothing is cached in this case.
+    */
+   std::optional<EmployeeData> get(CORBA::Long personId);
+
+   /// \brief removes the entry of an employee, hook for all write operations
+   void invalidate(CORBA::Long personId);
+
+   /// \brief removes all entries, e.g. after a reload of the repository
+   void invalidate_all();
+
+   /// \brief current counters of the cache
+   Statistics statistics() const;
+
+private:
+   Shard& shard(CORBA::Long personId) {
+      return *shards_[static_cast<std::uint32_t>(personId) % shards_.size()];
+      }
+   };
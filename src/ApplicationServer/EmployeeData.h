@@ -35,6 +35,8 @@
   \note This software is part of the adecc Scholar project – Free educational materials for modern C++.
  */
 
+#pragma once
+
 #include "BasicsC.h"
 #include "OrganizationC.h"
 
@@ -59,6 +61,8 @@ struct PersonData {
    std::string firstname  = ""s;                       ///< First name of the person
    std::string name       = ""s;                       ///< Last name of the person
    Organization::EGender gender = Organization::OTHER; ///< Gender as defined in the IDL enum
+
+   bool operator == (PersonData const&) const = default;
    };
 
 /**
@@ -72,6 +76,8 @@ struct EmployeeData : public PersonData {
    double salary                         = 0.0;          ///< Current salary (in company currency unit)
    std::chrono::year_month_day startDate = { };          ///< Start date in Year-Month-Day format
    CORBA::Boolean isActive               = false;        ///< Employment status (active/inactive)
+
+   bool operator == (EmployeeData const&) const = default;
    };
 
 /**
@@ -0,0 +1,107 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the stateless default servant for Organization::Employee
+
+  \details Every operation determines the ObjectId of the current request with the
+           `PortableServer::Current`, decodes the person id and reads the requested
+           attribute from the `EmployeeStore`.
+
+  \version 1.0
+  \date    18.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "EmployeeDefaultServant_i.h"
+#include "EmployeePOA.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <format>
+#include <stdexcept>
+
+EmployeeDefaultServant_i::EmployeeDefaultServant_i(CORBA::ORB_ptr orb, EmployeeVersions const& store) : store_(store) {
+   CORBA::Object_var obj = orb->resolve_initial_references("POACurrent");
+   current_ = PortableServer::Current::_narrow(obj.in());
+   if (CORBA::is_nil(current_.in()))
+      throw std::runtime_error(std::format("[EmployeeDefaultServant_i {}] Failed to narrow the POACurrent.", ::getTimeStamp()));
+   log_trace<4>("[EmployeeDefaultServant_i {}] Default servant for employees created.", ::getTimeStamp());
+   }
+
+EmployeeDefaultServant_i::~EmployeeDefaultServant_i() {
+   log_trace<4>("[EmployeeDefaultServant_i {}] Default servant for employees destroyed.", ::getTimeStamp());
+   }
+
+EmployeeStore::row_ty EmployeeDefaultServant_i::current_row(EmployeeStore const& store) {
+   PortableServer::ObjectId_var oid = current_->get_object_id();
+   CORBA::Long personId = toPersonId(oid.in());
+   if (auto row = store.find(personId); row) [[likely]] return *row;
+   log_error("[EmployeeDefaultServant_i {}] request for unknown employee with ID {}.", ::getTimeStamp(), personId);
+   throw CORBA::OBJECT_NOT_EXIST();
+   }
+
+CORBA::Long EmployeeDefaultServant_i::personId() {
+   auto const store = store_.current();
+   return store->personId(current_row(*store));
+   }
+
+char* EmployeeDefaultServant_i::firstName() {
+   auto const store = store_.current();
+   return CORBA::string_dup(store->firstname(current_row(*store)).c_str());
+   }
+
+char* EmployeeDefaultServant_i::name() {
+   auto const store = store_.current();
+   return CORBA::string_dup(store->name(current_row(*store)).c_str());
+   }
+
+Organization::EGender EmployeeDefaultServant_i::gender() {
+   auto const store = store_.current();
+   return store->gender(current_row(*store));
+   }
+
+char* EmployeeDefaultServant_i::getFullName() {
+   auto const store = store_.current();
+   auto row = current_row(*store);
+   std::string strName = store->firstname(row) + " "s + store->name(row);
+   return CORBA::string_dup(strName.c_str());
+   }
+
+CORBA::Double EmployeeDefaultServant_i::salary() {
+   auto const store = store_.current();
+   return store->salary(current_row(*store));
+   }
+
+Basics::Date EmployeeDefaultServant_i::startDate() {
+   auto const store = store_.current();
+   return convert<Basics::Date>(store->startDate(current_row(*store)));
+   }
+
+CORBA::Boolean EmployeeDefaultServant_i::isActive() {
+   auto const store = store_.current();
+   return store->isActive(current_row(*store));
+   }
+
+void EmployeeDefaultServant_i::destroy() {
+   log_trace<4>("[EmployeeDefaultServant_i {}] destroy() called, nothing to release for a default servant.", ::getTimeStamp());
+   }
@@ -0,0 +1,114 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Stateless default servant for all Organization::Employee references.
+
+  \details This header declares the class `EmployeeDefaultServant_i`. One instance of this
+           class is registered as default servant at the employee POA. The references to
+           the employees are created with `create_reference_with_id()` and carry the person
+           id in the ObjectId. For every request the servant asks the `PortableServer::Current`
+           for the ObjectId of the target and reads the data of the employee from the store.
+
+  \details Compared to the former solution with an own `Employee_i` for every employee and
+           every call, no servant is allocated, no entry in an active object map is created
+           and nothing is leaked when a client forgets to call `destroy()`.
+
+  \version 1.0
+  \date    18.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see EmployeePOA.h
+  \see Employee_i.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "OrganizationS.h" // Skeleton Header
+#include "EmployeeVersions.h"
+
+#include <tao/ORB_Core.h>
+#include <tao/PortableServer/PortableServer.h>
+#include <tao/PortableServer/PS_CurrentC.h>
+
+/**
+  \brief Default servant implementing `Organization::Employee` for all employees of a company.
+
+  \details The servant holds no data of an employee. Each attribute resolves the person id of
+           the current request and reads the value from the current version of the `EmployeeStore`
+           of the company.
+
+  \note When the employee was removed from the store meanwhile, the servant raises
+        `CORBA::OBJECT_NOT_EXIST`, like a POA does for a deactivated object.
+ */
+class EmployeeDefaultServant_i : public virtual PortableServer::RefCountServantBase,
+                                 public virtual POA_Organization::Employee {
+private:
+   PortableServer::Current_var current_; ///< POA Current to determine the target of a request
+   EmployeeVersions const&     store_;   ///< versions of the store of the company with the employee data
+
+public:
+   EmployeeDefaultServant_i() = delete;
+
+   /**
+     \brief Constructs the default servant.
+     \param orb ORB used to resolve the initial reference "POACurrent"
+     \param store versions of the store with the employee records, must outlive the servant
+     \throws std::runtime_error if the POACurrent can't be resolved
+    */
+   EmployeeDefaultServant_i(CORBA::ORB_ptr orb, EmployeeVersions const& store);
+   virtual ~EmployeeDefaultServant_i();
+
+   /**
+      \name IDL Attribute Methods of Organization::Person
+    */
+    /// \{
+   virtual CORBA::Long           personId() override;
+   virtual char*                 firstName() override;
+   virtual char*                 name() override;
+   virtual Organization::EGender gender() override;
+   virtual char*                 getFullName() override;
+   /// \}
+
+   /**
+      \name IDL Attribute Methods of Organization::Employee
+    */
+    /// \{
+   virtual CORBA::Double         salary() override;
+   virtual Basics::Date          startDate() override;
+   virtual CORBA::Boolean        isActive() override;
+   /// \}
+
+   /**
+     \brief Implementation of Basics::DestroyableInterface::destroy()
+     \details There is nothing to destroy for a reference of a default servant, the
+              method exists for the compatibility with the existing clients.
+    */
+   virtual void destroy() override;
+
+private:
+   /**
+     \brief Determines the row of the employee which is the target of the current request.
+     \param store version of the store used for the whole request
+     \throws CORBA::OBJECT_NOT_EXIST if the employee doesn't exist in the store
+    */
+   EmployeeStore::row_ty current_row(EmployeeStore const& store);
+   };
@@ -0,0 +1,78 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the servant for Organization::EmployeeIterator
+
+  \details Each call of `next_n()` seeks the row of the cursor with a binary search over the
+           id column, copies the next employees directly into the out sequence and moves the
+           cursor to the person id behind the last transferred employee.
+
+  \version 1.0
+  \date    23.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "EmployeeIterator_i.h"
+
+#include "Tools.h"
+#include "CorbaSequenceBuilder.h"
+#include "my_logging.h"
+
+#include <algorithm>
+#include <limits>
+
+EmployeeIterator_i::EmployeeIterator_i(EmployeeVersions const& store, bool only_active, PortableServer::POA_ptr poa) :
+                                 DestroyableInterface_i(poa), store_(store), only_active_(only_active),
+                                 next_id_(std::numeric_limits<CORBA::Long>::min()) {
+   log_trace<4>("[EmployeeIterator_i {}] Iterator created (only active: {}).", ::getTimeStamp(), only_active_);
+   }
+
+EmployeeIterator_i::~EmployeeIterator_i() {
+   log_trace<4>("[EmployeeIterator_i {}] Iterator destroyed.", ::getTimeStamp());
+   }
+
+CORBA::Boolean EmployeeIterator_i::next_n(CORBA::ULong how_many, Organization::EmployeeDataSeq_out employees) {
+   how_many = std::clamp<CORBA::ULong>(how_many, 1, MaxChunkSize);
+
+   CorbaSequenceBuilder<Organization::EmployeeDataSeq> chunk;
+   std::lock_guard lock(mutex_);
+   if (next_id_) {
+      // each chunk reads the version current at its call
+      auto const store = store_.current();
+      EmployeeStore::row_ty row  = store->lower_bound(*next_id_);
+      EmployeeStore::row_ty const last = static_cast<EmployeeStore::row_ty>(store->size());
+      chunk.reserve(std::min<CORBA::ULong>(how_many, last - row));
+
+      for (; row < last && chunk.size() < how_many; ++row) {
+         if (only_active_ && !store->isActive(row)) continue;
+         store->copy_to(row, chunk.next());
+         }
+
+      if (row < last) next_id_ = store->personId(row);
+      else            next_id_.reset();
+      }
+
+   log_trace<5>("[EmployeeIterator_i {}] next_n() returns {} employees.", ::getTimeStamp(), chunk.size());
+   CORBA::Boolean const has_data = chunk.size() > 0;
+   employees = chunk.release();
+   return has_data;
+   }
@@ -0,0 +1,93 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Servant for the IDL interface Organization::EmployeeIterator.
+
+  \details This header declares the class `EmployeeIterator_i`. An instance is created by
+           `Company_i::getEmployeesIterator()` or `Company_i::getActiveEmployeesIterator()`
+           and activated at the POA of the company. The servant keeps a cursor into the
+           `EmployeeStore` and transfers the employees chunk by chunk with `next_n()`.
+
+  \details The cursor is the person id of the next employee, not the row. The rows of the
+           store are sorted by the person id, so the cursor remains correct when employees
+           are inserted between two calls.
+
+  \version 1.0
+  \date    23.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see Company_i.h
+  \see DestroyableInterface_i
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "OrganizationS.h" // Skeleton Header
+#include "Basics_i.h"
+#include "EmployeeVersions.h"
+
+#include <tao/ORB_Core.h>
+#include <tao/PortableServer/PortableServer.h>
+
+#include <optional>
+#include <mutex>
+
+/**
+  \brief Servant implementing `Organization::EmployeeIterator` with a cursor into the employee store.
+
+  \details The lifetime is controlled by the client with `destroy()` (see `DestroyableInterface_i`).
+           The size of a chunk is limited by \ref MaxChunkSize, independent of the request of the client.
+           The cursor is guarded by a mutex, calls of next_n() for the same iterator from several
+           dispatch threads return consecutive chunks without gaps or duplicates.
+ */
+class EmployeeIterator_i : public virtual DestroyableInterface_i,
+                           public virtual POA_Organization::EmployeeIterator {
+public:
+   /// maximal number of employees transferred with one call of next_n()
+   static constexpr CORBA::ULong MaxChunkSize = 1'000;
+
+private:
+   EmployeeVersions const&    store_;       ///< versions of the store of the company with the employee data
+   bool                       only_active_; ///< true when only active employees are returned
+   std::optional<CORBA::Long> next_id_;     ///< person id where the next chunk starts, empty when exhausted
+   std::mutex                 mutex_;       ///< guards next_id_ for the whole call of next_n()
+
+public:
+   EmployeeIterator_i() = delete;
+
+   /**
+     \brief Constructs an iterator positioned in front of the first employee.
+     \param store versions of the store with the employee records, must outlive the iterator
+     \param only_active true to skip the inactive employees
+     \param poa POA which activates the servant, used by destroy()
+    */
+   EmployeeIterator_i(EmployeeVersions const& store, bool only_active, PortableServer::POA_ptr poa);
+   virtual ~EmployeeIterator_i();
+
+   /**
+     \brief Implementation of Organization::EmployeeIterator::next_n()
+     \param how_many requested number of employees, limited to [1, MaxChunkSize]
+     \param employees out parameter with the data of the chunk
+     \return true if at least one employee was returned
+    */
+   virtual CORBA::Boolean next_n(CORBA::ULong how_many, Organization::EmployeeDataSeq_out employees) override;
+   };
@@ -0,0 +1,190 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Parallel bulk loader which fills the employee store from the database at startup.
+
+  \details The key space of the person ids is split into contiguous partitions. Each partition is
+           loaded by an own task with an own connection of the `DatabasePool`, in rowsets of a
+           fixed id width. The rows are decoded directly into the columns of an `EmployeeBatch`,
+           and the batches are appended to the `EmployeeStore` in the order of the partitions,
+           so the store moves the columns as a block and needs no reordering.
+
+  \version 1.0
+  \date    01.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see DatabasePool.h
+  \see EmployeeStatements.h
+  \see EmployeeStore.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "EmployeeStore.h"
+#include "EmployeeStatements.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <vector>
+#include <optional>
+#include <future>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+/// \brief configuration of the bulk load
+struct EmployeeLoadConfig {
+   std::size_t partitions  = 4;       ///< number of parallel tasks, limited to the size of the pool
+   CORBA::Long rowset_size = 10'000;  ///< width of the id range fetched with one statement execution
+   };
+
+/// \brief result of the bulk load
+struct EmployeeLoadStatistics {
+   std::size_t               rows       = 0;  ///< employees appended to the store
+   std::size_t               partitions = 0;  ///< partitions loaded in parallel
+   std::size_t               rowsets    = 0;  ///< executed range statements
+   std::chrono::milliseconds duration   = {}; ///< duration of the complete load
+
+   double rows_per_second() const {
+      return duration.count() > 0 ? rows * 1'000.0 / duration.count() : static_cast<double>(rows);
+      }
+   };
+
+/**
+  \brief Decodes the current row of the range statement into the columns of the batch.
+  \details The values are read with the typed getters of the query and written at the end of the
+           columns, no EmployeeData record is built for a row.
+ */
+template <typename query_ty>
+void DecodeEmployeeRow(query_ty& query, EmployeeBatch& batch) {
+   batch.ids.emplace_back(query.template Get<int>("ID").value_or(0));
+   batch.firstnames.emplace_back(query.template Get<std::string>("Firstname").value_or(""s));
+   batch.names.emplace_back(query.template Get<std::string>("Name").value_or(""s));
+   batch.genders.emplace_back(static_cast<Organization::EGender>(std::clamp(query.template Get<int>("Gender").value_or(2), 0, 2)));
+   batch.salaries.emplace_back(query.template Get<double>("Salary").value_or(0.0));
+   batch.start_dates.emplace_back(query.template Get<std::chrono::year_month_day>("StartDate").value_or(std::chrono::year_month_day { }));
+   batch.active.emplace_back(query.template Get<bool>("IsActive").value_or(false));
+   }
+
+/**
+  \brief Reads one employee from the database, used as loader of the `EmployeeCache`.
+  \tparam pool_ty instance of `DatabasePool`
+  \return record of the employee, std::nullopt if the person id isn't in the database
+  \throws std::runtime_error if no connection is available, exceptions of the database layer are passed through
+ */
+template <typename pool_ty>
+std::optional<EmployeeData> FetchEmployee(pool_ty& pool, CORBA::Long personId) {
+   auto connection = pool.acquire();
+   auto& query = connection.statement(EmployeeById.name, EmployeeById.sql);
+   if (query.Execute({ { "keyID", static_cast<int>(personId), true } }); query.IsEof()) return std::nullopt;
+   EmployeeData data;
+   data.personID  = query.template Get<int>("ID").value_or(personId);
+   data.firstname = query.template Get<std::string>("Firstname").value_or(""s);
+   data.name      = query.template Get<std::string>("Name").value_or(""s);
+   data.gender    = static_cast<Organization::EGender>(std::clamp(query.template Get<int>("Gender").value_or(2), 0, 2));
+   data.salary    = query.template Get<double>("Salary").value_or(0.0);
+   data.startDate = query.template Get<std::chrono::year_month_day>("StartDate").value_or(std::chrono::year_month_day { });
+   data.isActive  = query.template Get<bool>("IsActive").value_or(false);
+   return data;
+   }
+
+/**
+  \brief Loads all employees of the database into the store.
+
+  \tparam pool_ty instance of `DatabasePool`
+  \param pool connection pool, each partition uses an own connection, so the pool size limits the partitions
+  \param store employee store which receives the data (normally still empty)
+  \param config number of partitions and size of the rowsets
+  \return counters and duration of the load
+  \throws std::runtime_error if no connection is available, exceptions of the database layer are passed through
+ */
+template <typename pool_ty>
+EmployeeLoadStatistics LoadEmployees(pool_ty& pool, EmployeeStore& store, EmployeeLoadConfig const& config = {}) {
+   auto const start = std::chrono::steady_clock::now();
+   EmployeeLoadStatistics stats;
+
+   // 1st determine the key space and the number of rows
+   CORBA::Long  min_id = 0, max_id = -1;
+   std::int64_t row_count = 0;
+      {
+      auto connection = pool.acquire();
+      auto& query = connection.statement(EmployeeKeyRange.name, EmployeeKeyRange.sql);
+      if (query.Execute({ }); !query.IsEof()) {
+         min_id    = query.template Get<int>("MinID").value_or(0);
+         max_id    = query.template Get<int>("MaxID").value_or(-1);
+         row_count = query.template Get<int>("RowCount").value_or(0);
+         }
+      }
+   if (max_id < min_id || row_count <= 0) {
+      log_trace<2>("[LoadEmployees {}] no employees in the database.", ::getTimeStamp());
+      return stats;
+      }
+
+   // 2nd split the key space into partitions and load them in parallel, one connection for each partition.
+   //     More partitions than connections would only wait in acquire() and could run into its timeout.
+   std::int64_t const key_count  = static_cast<std::int64_t>(max_id) - min_id + 1;
+   std::int64_t const partitions = std::clamp<std::int64_t>(static_cast<std::int64_t>(std::min(config.partitions, pool.size())), 1,
+                                                            std::min(key_count, row_count));
+   std::int64_t const width      = (key_count + partitions - 1) / partitions;
+   CORBA::Long  const rowset     = std::max<CORBA::Long>(config.rowset_size, 1);
+
+   // the capacity of a batch is the share of the rows for the width of its key range, with sparse ids
+   // the width of the range is far more than the number of rows
+   auto load_partition = [&pool, rowset, row_count, key_count](CORBA::Long from, CORBA::Long to) {
+      std::pair<EmployeeBatch, std::size_t> result;
+      auto& [batch, rowsets] = result;
+      batch.reserve(static_cast<std::size_t>(row_count * (static_cast<std::int64_t>(to) - from + 1) / key_count + 1));
+      auto connection = pool.acquire();
+      auto& query = connection.statement(EmployeesInRange.name, EmployeesInRange.sql);
+      for (std::int64_t lower = from; lower <= to; lower += rowset) {
+         auto const upper = static_cast<CORBA::Long>(std::min<std::int64_t>(lower + rowset - 1, to));
+         ++rowsets;
+         for (query.Execute({ { "keyFrom", static_cast<int>(lower), true }, { "keyTo", static_cast<int>(upper), true } });
+                                                                                   !query.IsEof(); query.Next()) {
+            DecodeEmployeeRow(query, batch);
+            }
+         }
+      return result;
+      };
+
+   std::vector<std::future<std::pair<EmployeeBatch, std::size_t>>> tasks;
+   tasks.reserve(static_cast<std::size_t>(partitions));
+   for (std::int64_t part = 0; part < partitions; ++part) {
+      auto const from = static_cast<CORBA::Long>(min_id + part * width);
+      auto const to   = static_cast<CORBA::Long>(std::min<std::int64_t>(min_id + (part + 1) * width - 1, max_id));
+      tasks.emplace_back(std::async(std::launch::async, load_partition, from, to));
+      }
+
+   // 3rd append the batches in the order of the keys, the store moves the columns as block
+   for (auto& task : tasks) {
+      auto [batch, rowsets] = task.get();
+      stats.rows    += store.append(std::move(batch));
+      stats.rowsets += rowsets;
+      }
+
+   stats.partitions = static_cast<std::size_t>(partitions);
+   stats.duration   = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+   log_trace<2>("[LoadEmployees {}] {} employees loaded in {} with {} partitions and {} rowsets ({:.0f} rows/s).", ::getTimeStamp(),
+                stats.rows, stats.duration, stats.partitions, stats.rowsets, stats.rows_per_second());
+   return stats;
+   }
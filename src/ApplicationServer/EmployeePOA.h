@@ -0,0 +1,117 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Helpers for the POA which is responsible for the Organization::Employee references.
+
+  \details The employee references aren't bound to an own servant per call anymore. The
+           ObjectId of each reference encodes the person id of the employee as decimal
+           string, so that a servant can find the record for each request. This file
+           contains the conversions between person id and ObjectId, the configuration and
+           the policies for the employee POA.
+
+  \details Two modes are supported for the employee POA:
+           - `EEmployeePOAMode::DefaultServant`: one stateless default servant serves all
+             employee references (USE_DEFAULT_SERVANT).
+           - `EEmployeePOAMode::ServantLocator`: a servant locator incarnates `Employee_i`
+             servants on demand and keeps them in a LRU cache with a fixed capacity
+             (USE_SERVANT_MANAGER).
+
+  \version 1.0
+  \date    18.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "OrganizationC.h"
+
+#include <tao/PortableServer/PortableServer.h>
+#include <tao/PortableServer/LifespanPolicyC.h>
+#include <tao/PortableServer/IdAssignmentPolicyC.h>
+#include <tao/PortableServer/IdUniquenessPolicyC.h>
+#include <tao/PortableServer/ServantRetentionPolicyC.h>
+#include <tao/PortableServer/RequestProcessingPolicyC.h>
+
+#include <string>
+#include <charconv>
+#include <cstddef>
+
+/// \brief Mode for the request processing of the employee POA
+enum class EEmployeePOAMode {
+   DefaultServant, ///< one stateless default servant for all employees
+   ServantLocator  ///< servant locator with a bounded LRU cache of Employee_i servants
+   };
+
+/// \brief Configuration of the employee POA
+struct EmployeePOAConfig {
+   EEmployeePOAMode mode       = EEmployeePOAMode::DefaultServant; ///< request processing of the POA
+   std::size_t      cache_size = 1'000;                            ///< maximal number of cached servants (ServantLocator only)
+   };
+
+/// repository id of the interface Organization::Employee, used to create references without servant
+inline constexpr const char* EmployeeRepositoryId = "IDL:Organization/Employee:1.0";
+
+/**
+  \brief Creates the ObjectId for the employee with the given person id.
+  \param personId id of the employee
+  \return new allocated ObjectId, the caller takes the ownership (use PortableServer::ObjectId_var)
+ */
+inline PortableServer::ObjectId* toEmployeeObjectId(CORBA::Long personId) {
+   return PortableServer::string_to_ObjectId(std::to_string(personId).c_str());
+   }
+
+/**
+  \brief Extracts the person id from the ObjectId of an employee reference.
+  \param oid ObjectId created with \ref toEmployeeObjectId
+  \return person id encoded in the ObjectId
+  \throws CORBA::OBJECT_NOT_EXIST if the ObjectId doesn't contain a valid person id
+ */
+inline CORBA::Long toPersonId(PortableServer::ObjectId const& oid) {
+   CORBA::String_var strOid = PortableServer::ObjectId_to_string(oid);
+   std::string_view value { strOid.in() };
+   CORBA::Long personId = 0;
+   if (auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), personId);
+                          ec != std::errc{} || ptr != value.data() + value.size()) [[unlikely]]
+      throw CORBA::OBJECT_NOT_EXIST();
+   return personId;
+   }
+
+/**
+  \brief Creates the policies for the employee POA.
+  \details TRANSIENT references with user defined ids (the person id) and no active object map
+           (NON_RETAIN). The requests are dispatched to the one default servant or to the
+           servant locator, depending on the mode.
+  \param poa POA used as factory for the policies (normally the root POA)
+  \param mode request processing mode of the employee POA
+  \return list of policies, the caller must destroy the policies after the POA is created
+ */
+inline CORBA::PolicyList CreateEmployeePolicies(PortableServer::POA_ptr poa, EEmployeePOAMode mode = EEmployeePOAMode::DefaultServant) {
+   CORBA::PolicyList pol_list;
+   pol_list.length(5);
+   pol_list[0] = poa->create_lifespan_policy(PortableServer::TRANSIENT);
+   pol_list[1] = poa->create_id_assignment_policy(PortableServer::USER_ID);
+   pol_list[2] = poa->create_id_uniqueness_policy(PortableServer::MULTIPLE_ID);
+   pol_list[3] = poa->create_servant_retention_policy(PortableServer::NON_RETAIN);
+   pol_list[4] = poa->create_request_processing_policy(mode == EEmployeePOAMode::DefaultServant ? PortableServer::USE_DEFAULT_SERVANT
+                                                                                                 : PortableServer::USE_SERVANT_MANAGER);
+   return pol_list;
+   }
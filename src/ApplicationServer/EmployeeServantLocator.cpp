@@ -0,0 +1,133 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the servant locator with LRU cache for Organization::Employee
+
+  \details The cache is a combination of a list (order of the last use) and a hash map
+           (person id → list position). A hit moves the entry to the front of the list,
+           a miss incarnates a new `Employee_i` and removes the last entries when the
+           capacity is exceeded.
+
+  \version 1.0
+  \date    21.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "EmployeeServantLocator.h"
+#include "EmployeePOA.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <algorithm>
+
+EmployeeServantLocator::EmployeeServantLocator(EmployeeVersions const& store, std::size_t capacity)
+                : store_(store), capacity_(std::max<std::size_t>(capacity, 1)) {
+   cache_.reserve(capacity_);
+   log_trace<4>("[EmployeeServantLocator {}] Servant locator created with a capacity of {} servants.", ::getTimeStamp(), capacity_);
+   }
+
+EmployeeServantLocator::~EmployeeServantLocator() {
+   auto stat = statistics();
+   log_trace<4>("[EmployeeServantLocator {}] Servant locator destroyed, hits: {}, misses: {}, evictions: {}.",
+                ::getTimeStamp(), stat.hits, stat.misses, stat.evictions);
+   }
+
+PortableServer::Servant EmployeeServantLocator::preinvoke(PortableServer::ObjectId const& oid, PortableServer::POA_ptr adapter,
+                                                          const char* , PortableServer::ServantLocator::Cookie& the_cookie) {
+   CORBA::Long personId = toPersonId(oid);
+   the_cookie = nullptr;
+
+   // one version of the store for the request, a cached servant of an older row version isn't used
+   auto const store = store_.current();
+   auto const row   = store->find(personId);
+
+   // servants released outside of the lock, the destructor of Employee_i logs
+   lru_list_ty evicted;
+   PortableServer::Servant servant = nullptr;
+      {
+      std::lock_guard lock(mutex_);
+      if (auto it = cache_.find(personId); it != cache_.end()) [[likely]] {
+         if (row && it->second->version == store->rowVersion(*row)) [[likely]] {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            ++hits_;
+            servant = it->second->servant.in();
+            }
+         else {
+            evicted.splice(evicted.end(), lru_, it->second);
+            cache_.erase(it);
+            ++stale_;
+            }
+         }
+      if (servant == nullptr) {
+         if (!row) [[unlikely]] {
+            log_error("[EmployeeServantLocator {}] request for unknown employee with ID {}.", ::getTimeStamp(), personId);
+            throw CORBA::OBJECT_NOT_EXIST();
+            }
+         ++misses_;
+         lru_.emplace_front(CacheEntry { personId, new Employee_i(store->record(*row), adapter), store->rowVersion(*row) });
+         cache_.emplace(personId, lru_.begin());
+         servant = lru_.front().servant.in();
+
+         while (lru_.size() > capacity_) {
+            cache_.erase(lru_.back().personId);
+            evicted.splice(evicted.end(), lru_, std::prev(lru_.end()));
+            ++evictions_;
+            }
+         }
+      servant->_add_ref(); // reference for the duration of the request
+      }
+
+   if (!evicted.empty())
+      log_trace<5>("[EmployeeServantLocator {}] {} servant(s) etherealized.", ::getTimeStamp(), evicted.size());
+   return servant;
+   }
+
+void EmployeeServantLocator::postinvoke(PortableServer::ObjectId const& , PortableServer::POA_ptr , const char* ,
+                                        PortableServer::ServantLocator::Cookie , PortableServer::Servant the_servant) {
+   if (the_servant != nullptr) the_servant->_remove_ref();
+   }
+
+void EmployeeServantLocator::evict(CORBA::Long personId) {
+   lru_list_ty evicted;
+      {
+      std::lock_guard lock(mutex_);
+      if (auto it = cache_.find(personId); it != cache_.end()) {
+         evicted.splice(evicted.end(), lru_, it->second);
+         cache_.erase(it);
+         }
+      }
+   }
+
+void EmployeeServantLocator::clear() {
+   lru_list_ty evicted;
+      {
+      std::lock_guard lock(mutex_);
+      evicted.swap(lru_);
+      cache_.clear();
+      }
+   }
+
+EmployeeServantLocator::Statistics EmployeeServantLocator::statistics() const {
+   std::lock_guard lock(mutex_);
+   return { .hits = hits_, .misses = misses_, .evictions = evictions_, .stale = stale_, .size = lru_.size(), .capacity = capacity_ };
+   }
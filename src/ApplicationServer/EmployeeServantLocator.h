@@ -0,0 +1,139 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Servant locator with a bounded LRU cache for the Organization::Employee servants.
+
+  \details This header declares the class `EmployeeServantLocator`. It is installed as servant
+           manager at the employee POA (policies USE_SERVANT_MANAGER and NON_RETAIN). For each
+           request `preinvoke()` decodes the person id from the ObjectId and returns the cached
+           `Employee_i` servant, or incarnates a new one from the `EmployeeStore`.
+
+  \details The number of cached servants is limited. When the cache is full, the least recently
+           used servant is removed and etherealized (the last reference is released). A servant
+           which is executing a request in this moment is protected by the reference counting,
+           it will be deleted after `postinvoke()`. With this the memory of a long running server
+           is bounded, independent of clients which never call `destroy()`.
+
+  \version 1.0
+  \date    21.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see EmployeePOA.h
+  \see EmployeeDefaultServant_i.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "Employee_i.h"
+#include "EmployeeVersions.h"
+
+#include <tao/PortableServer/PortableServer.h>
+#include <tao/PortableServer/ServantLocatorC.h>
+#include <tao/LocalObject.h>
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+/**
+  \brief Servant locator for the employee POA with a LRU cache of incarnated `Employee_i` servants.
+
+  \details The cache holds one reference of each servant. `preinvoke()` adds a reference for the
+           duration of the request, `postinvoke()` releases it again.
+  \details Each servant remembers the version of the row it was built from. A cached servant is used
+           only while the row in the current version of the store has the same version, so a request
+           never sees older data than the store, also between the publication of a write and its
+           call of `evict()`.
+
+  \note The class is thread safe, the cache is protected by a mutex and the counters are atomic.
+ */
+class EmployeeServantLocator : public virtual PortableServer::ServantLocator,
+                               public virtual CORBA::LocalObject {
+public:
+   /// \brief counters of the cache
+   struct Statistics {
+      std::uint64_t hits      = 0; ///< requests served by a cached servant
+      std::uint64_t misses    = 0; ///< requests which needed a new incarnation
+      std::uint64_t evictions = 0; ///< servants removed because of the capacity
+      std::uint64_t stale     = 0; ///< cached servants replaced because the row has a newer version
+      std::size_t   size      = 0; ///< servants currently in the cache
+      std::size_t   capacity  = 0; ///< maximal number of servants in the cache
+      };
+
+private:
+   /// \brief element of the LRU list
+   struct CacheEntry {
+      CORBA::Long                     personId; ///< id of the employee
+      PortableServer::ServantBase_var servant;  ///< reference of the cache to the servant
+      EmployeeStore::version_ty       version;  ///< version of the row the servant was built from
+      };
+
+   using lru_list_ty = std::list<CacheEntry>;
+
+   EmployeeVersions const&                               store_;     ///< versions of the store of the company with the employee data
+   std::size_t                                           capacity_;  ///< maximal number of cached servants
+   mutable std::mutex                                    mutex_;     ///< protects lru_ and cache_
+   lru_list_ty                                           lru_;       ///< servants, most recently used at the front
+   std::unordered_map<CORBA::Long, lru_list_ty::iterator> cache_;    ///< person id → position in lru_
+
+   std::atomic<std::uint64_t>                            hits_      = 0;
+   std::atomic<std::uint64_t>                            misses_    = 0;
+   std::atomic<std::uint64_t>                            evictions_ = 0;
+   std::atomic<std::uint64_t>                            stale_     = 0;
+
+public:
+   EmployeeServantLocator() = delete;
+
+   /**
+     \brief Constructs the servant locator.
+     \param store versions of the store with the employee records, must outlive the locator
+     \param capacity maximal number of servants in the cache (at least 1)
+    */
+   EmployeeServantLocator(EmployeeVersions const& store, std::size_t capacity);
+   virtual ~EmployeeServantLocator();
+
+   /**
+     \brief Locates or incarnates the servant for the target of a request.
+     \throws CORBA::OBJECT_NOT_EXIST if the employee doesn't exist in the store
+    */
+   virtual PortableServer::Servant preinvoke(PortableServer::ObjectId const& oid, PortableServer::POA_ptr adapter,
+                                             const char* operation, PortableServer::ServantLocator::Cookie& the_cookie) override;
+
+   /// \brief Releases the reference of the request to the servant.
+   virtual void postinvoke(PortableServer::ObjectId const& oid, PortableServer::POA_ptr adapter, const char* operation,
+                           PortableServer::ServantLocator::Cookie the_cookie, PortableServer::Servant the_servant) override;
+
+   /**
+     \brief Removes the servant of an employee from the cache.
+     \details Invalidation hook for write operations, the next request incarnates a new servant
+              with the current data of the store.
+    */
+   void evict(CORBA::Long personId);
+
+   /// \brief Removes all servants from the cache.
+   void clear();
+
+   /// \brief Returns the current counters of the cache.
+   Statistics statistics() const;
+   };
@@ -0,0 +1,88 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Named SQL statements for the Person and Employee queries of the application server.
+
+  \details The statements are used with `DatabasePool::Lease::statement()`. The name is the key of
+           the statement cache of a connection, so every statement is prepared once for each
+           connection. The parameters are bound by name (`:keyName`) with each execution.
+
+  \version 1.0
+  \date    30.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see DatabasePool.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include <string>
+
+using namespace std::string_literals;
+
+/// \brief name and text of a SQL statement for the statement cache of the connection pool
+struct NamedStatement {
+   std::string name; ///< key in the statement cache
+   std::string sql;  ///< text of the statement with named parameters
+   };
+
+/// Person with name and first name, parameters :keyName and :keyFirstname
+inline const NamedStatement PersonByName {
+   "PersonByName"s,
+   "SELECT ID, Name, Firstname, BirthName, FormOfAddress, FamilyStatus, FamilyStatusSince, Birthday, Notes, FullName "s
+   "FROM Person "s
+   "WHERE Name = :keyName AND Firstname = :keyFirstname"s
+   };
+
+/// Person with the id, parameter :keyID
+inline const NamedStatement PersonById {
+   "PersonById"s,
+   "SELECT ID, Name, Firstname, BirthName, FormOfAddress, FamilyStatus, FamilyStatusSince, Birthday, Notes, FullName "s
+   "FROM Person "s
+   "WHERE ID = :keyID"s
+   };
+
+/// Smallest and largest person id and number of the employees (columns MinID, MaxID, RowCount)
+inline const NamedStatement EmployeeKeyRange {
+   "EmployeeKeyRange"s,
+   "SELECT MIN(ID) AS MinID, MAX(ID) AS MaxID, COUNT(*) AS RowCount FROM EmployeeView"s
+   };
+
+/**
+  Employees in a closed range of person ids, ordered by the id, parameters :keyFrom and :keyTo.
+  The view `EmployeeView` combines Person and Employee, Gender uses the values of Organization::EGender.
+ */
+inline const NamedStatement EmployeesInRange {
+   "EmployeesInRange"s,
+   "SELECT ID, Firstname, Name, Gender, Salary, StartDate, IsActive "s
+   "FROM EmployeeView "s
+   "WHERE ID BETWEEN :keyFrom AND :keyTo "s
+   "ORDER BY ID"s
+   };
+
+/// Employee with the id from the view `EmployeeView`, parameter :keyID (read-through cache of the Company_i)
+inline const NamedStatement EmployeeById {
+   "EmployeeById"s,
+   "SELECT ID, Firstname, Name, Gender, Salary, StartDate, IsActive "s
+   "FROM EmployeeView "s
+   "WHERE ID = :keyID"s
+   };
@@ -0,0 +1,336 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the columnar employee store (EmployeeStore)
+
+  \details The functions in this file maintain the parallel column vectors and the id
+           index of `EmployeeStore`. The scans for the aggregates use the parallel
+           algorithms of the standard library with the policy `std::execution::unseq`,
+           so that the compiler is allowed to vectorize the reductions.
+
+  \version 1.0
+  \date    14.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "EmployeeStore.h"
+
+#include <algorithm>
+#include <numeric>
+#include <execution>
+#include <functional>
+#include <iterator>
+
+void EmployeeStore::reserve(std::size_t capacity) {
+   ids_.reserve(capacity);
+   salaries_.reserve(capacity);
+   active_.reserve(capacity);
+   firstnames_.reserve(capacity);
+   names_.reserve(capacity);
+   genders_.reserve(capacity);
+   start_dates_.reserve(capacity);
+   versions_.reserve(capacity);
+   index_.reserve(capacity);
+   }
+
+void EmployeeStore::stamp(row_ty row) {
+   if (versions_[row] != 0) change_index_.erase(versions_[row]);
+   versions_[row] = ++version_;
+   change_index_.emplace_hint(change_index_.end(), version_, ids_[row]);
+   }
+
+bool EmployeeStore::insert(EmployeeData const& data) {
+   if (data.isActive) aggregates_.add(data.gender, static_cast<int>(data.startDate.year()), data.salary);
+
+   if (auto row = find(data.personID); row) {
+      if (active_[*row]) aggregates_.remove(genders_[*row], static_cast<int>(start_dates_[*row].year()), salaries_[*row]);
+      if (names_[*row] != data.name) {
+         erase_from_index(name_index_, names_[*row], data.personID);
+         name_index_.emplace(data.name, data.personID);
+         }
+      if (start_dates_[*row] != data.startDate) {
+         erase_from_index(start_index_, start_dates_[*row], data.personID);
+         start_index_.emplace(data.startDate, data.personID);
+         }
+      salaries_[*row]    = data.salary;
+      active_[*row]      = data.isActive;
+      firstnames_[*row]  = data.firstname;
+      names_[*row]       = data.name;
+      genders_[*row]     = data.gender;
+      start_dates_[*row] = data.startDate;
+      stamp(*row);
+      return false;
+      }
+
+   name_index_.emplace(data.name, data.personID);
+   start_index_.emplace(data.startDate, data.personID);
+   // an employee inserted again replaces its tombstone, the client must not remove the new record
+   if (!tombstones_.empty()) std::erase_if(tombstones_, [&data](Tombstone const& tombstone) { return tombstone.personId == data.personID; });
+
+   if (ids_.empty() || data.personID > ids_.back()) [[likely]] {
+      index_.emplace(data.personID, static_cast<row_ty>(ids_.size()));
+      ids_.emplace_back(data.personID);
+      salaries_.emplace_back(data.salary);
+      active_.emplace_back(data.isActive);
+      firstnames_.emplace_back(data.firstname);
+      names_.emplace_back(data.name);
+      genders_.emplace_back(data.gender);
+      start_dates_.emplace_back(data.startDate);
+      versions_.emplace_back(0);
+      stamp(static_cast<row_ty>(ids_.size() - 1));
+      }
+   else {
+      // rare case, id inside of the existing range, shift the columns to keep the order
+      auto pos = std::ranges::lower_bound(ids_, data.personID) - ids_.begin();
+      ids_.insert(ids_.begin() + pos, data.personID);
+      salaries_.insert(salaries_.begin() + pos, data.salary);
+      active_.insert(active_.begin() + pos, data.isActive);
+      firstnames_.insert(firstnames_.begin() + pos, data.firstname);
+      names_.insert(names_.begin() + pos, data.name);
+      genders_.insert(genders_.begin() + pos, data.gender);
+      start_dates_.insert(start_dates_.begin() + pos, data.startDate);
+      versions_.insert(versions_.begin() + pos, 0);
+      rebuild_index(static_cast<row_ty>(pos));
+      stamp(static_cast<row_ty>(pos));
+      }
+   return true;
+   }
+
+std::size_t EmployeeStore::append(EmployeeBatch&& batch) {
+   std::size_t const count = batch.size();
+   if (count == 0) return 0;
+
+   // strictly ascending ids behind the last id of the store can be moved at the end
+   bool const sorted_tail = std::ranges::adjacent_find(batch.ids, std::greater_equal<>{}) == batch.ids.end()
+                               && (ids_.empty() || batch.ids.front() > ids_.back());
+   if (!sorted_tail) [[unlikely]] {
+      std::size_t inserted = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+         EmployeeData data;
+         data.personID  = batch.ids[i];
+         data.firstname = std::move(batch.firstnames[i]);
+         data.name      = std::move(batch.names[i]);
+         data.gender    = batch.genders[i];
+         data.salary    = batch.salaries[i];
+         data.startDate = batch.start_dates[i];
+         data.isActive  = batch.active[i];
+         inserted += insert(data) ? 1 : 0;
+         }
+      batch = EmployeeBatch { };
+      return inserted;
+      }
+
+   auto const first = static_cast<row_ty>(ids_.size());
+   reserve(ids_.size() + count);
+   auto move_column = [](auto& target, auto& source) {
+      target.insert(target.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+      };
+   move_column(ids_, batch.ids);
+   move_column(salaries_, batch.salaries);
+   move_column(active_, batch.active);
+   move_column(firstnames_, batch.firstnames);
+   move_column(names_, batch.names);
+   move_column(genders_, batch.genders);
+   move_column(start_dates_, batch.start_dates);
+   versions_.resize(ids_.size(), 0);
+
+   for (row_ty row = first; row < ids_.size(); ++row) {
+      index_.emplace(ids_[row], row);
+      stamp(row);
+      name_index_.emplace(names_[row], ids_[row]);
+      start_index_.emplace(start_dates_[row], ids_[row]);
+      if (active_[row]) aggregates_.add(genders_[row], static_cast<int>(start_dates_[row].year()), salaries_[row]);
+      }
+   batch = EmployeeBatch { };
+   return count;
+   }
+
+bool EmployeeStore::deactivate(CORBA::Long personId) {
+   auto row = find(personId);
+   if (!row || !active_[*row]) return false;
+   aggregates_.remove(genders_[*row], static_cast<int>(start_dates_[*row].year()), salaries_[*row]);
+   active_[*row] = false;
+   stamp(*row);
+   return true;
+   }
+
+bool EmployeeStore::remove(CORBA::Long personId, std::chrono::sys_seconds now) {
+   auto row = find(personId);
+   if (!row) return false;
+   if (active_[*row]) aggregates_.remove(genders_[*row], static_cast<int>(start_dates_[*row].year()), salaries_[*row]);
+   erase_from_index(name_index_, names_[*row], personId);
+   erase_from_index(start_index_, start_dates_[*row], personId);
+   change_index_.erase(versions_[*row]);
+
+   auto erase_row = [pos = static_cast<std::ptrdiff_t>(*row)](auto& column) { column.erase(column.begin() + pos); };
+   erase_row(ids_);
+   erase_row(salaries_);
+   erase_row(active_);
+   erase_row(firstnames_);
+   erase_row(names_);
+   erase_row(genders_);
+   erase_row(start_dates_);
+   erase_row(versions_);
+   index_.erase(personId);
+   rebuild_index(*row);
+
+   tombstones_.emplace_back(Tombstone { .personId = personId, .version = ++version_, .removed = now });
+   return true;
+   }
+
+EmployeeStore::ChangeSet EmployeeStore::changes_since(version_ty since, bool resync, std::size_t limit) const {
+   ChangeSet result;
+   // the walk of a full result is continued also behind compacted tombstones, a delta not
+   bool const valid = since > restamped_ && since <= version_ && (resync || since >= compacted_);
+   if (!valid) {
+      result.full = true;
+      since       = 0;
+      }
+   limit = std::max<std::size_t>(limit, 1);
+
+   // rows and tombstones in the order of their versions, a full result has no tombstones
+   auto row  = change_index_.upper_bound(since);
+   auto tomb = result.full ? tombstones_.end() : std::ranges::upper_bound(tombstones_, since, { }, &Tombstone::version);
+   result.version = since;
+   while (result.rows.size() + result.removed.size() < limit) {
+      if (row != change_index_.end() && (tomb == tombstones_.end() || row->first < tomb->version)) {
+         result.rows.emplace_back(index_.at(row->second));
+         result.version = row->first;
+         ++row;
+         }
+      else if (tomb != tombstones_.end()) {
+         result.removed.emplace_back(tomb->personId);
+         result.version = tomb->version;
+         ++tomb;
+         }
+      else break;
+      }
+   result.more = row != change_index_.end() || tomb != tombstones_.end();
+   if (!result.more) result.version = version_;
+   return result;
+   }
+
+void EmployeeStore::restamp(version_ty base) {
+   version_ = std::max(version_, base);
+   change_index_.clear();
+   tombstones_.clear();
+   // a client with an older version gets all rows, the new versions continue the walk of a full result
+   restamped_ = version_;
+   compacted_ = version_;
+   for (row_ty row = 0; row < ids_.size(); ++row) {
+      versions_[row] = ++version_;
+      change_index_.emplace_hint(change_index_.end(), version_, ids_[row]);
+      }
+   }
+
+std::size_t EmployeeStore::compact_changes(std::chrono::sys_seconds cutoff) {
+   auto last = std::ranges::find_if(tombstones_, [cutoff](Tombstone const& tombstone) { return tombstone.removed >= cutoff; });
+   auto const count = static_cast<std::size_t>(last - tombstones_.begin());
+   if (count == 0) return 0;
+   compacted_ = std::prev(last)->version;
+   tombstones_.erase(tombstones_.begin(), last);
+   return count;
+   }
+
+EmployeeBatch EmployeeStore::columns() const {
+   return { .ids = ids_, .salaries = salaries_, .active = active_, .firstnames = firstnames_, .names = names_,
+            .genders = genders_, .start_dates = start_dates_ };
+   }
+
+EmployeeData EmployeeStore::record(row_ty row) const {
+   EmployeeData data;
+   data.personID  = ids_[row];
+   data.firstname = firstnames_[row];
+   data.name      = names_[row];
+   data.gender    = genders_[row];
+   data.salary    = salaries_[row];
+   data.startDate = start_dates_[row];
+   data.isActive  = active_[row];
+   return data;
+   }
+
+void EmployeeStore::copy_to(row_ty row, Organization::EmployeeData& target) const {
+   target.personId  = ids_[row];
+   target.firstName = firstnames_[row].c_str();
+   target.name      = names_[row].c_str();
+   target.gender    = genders_[row];
+   target.salary    = salaries_[row];
+   target.startDate = convert<Basics::Date>(start_dates_[row]);
+   target.isActive  = active_[row];
+   }
+
+double EmployeeStore::sum_active_salaries() const {
+   return std::transform_reduce(std::execution::unseq, salaries_.begin(), salaries_.end(), active_.begin(), 0.0,
+                                std::plus<>{}, [](double salary, CORBA::Boolean active) { return active ? salary : 0.0; });
+   }
+
+std::size_t EmployeeStore::count_active() const {
+   return std::transform_reduce(std::execution::unseq, active_.begin(), active_.end(), std::size_t { 0 },
+                                std::plus<>{}, [](CORBA::Boolean active) { return active ? std::size_t { 1 } : std::size_t { 0 }; });
+   }
+
+std::vector<EmployeeStore::row_ty> EmployeeStore::active_rows() const {
+   std::vector<row_ty> result(active_.size());
+   std::size_t count = 0;
+   for (row_ty row = 0; row < active_.size(); ++row) {
+      result[count] = row;
+      count += active_[row] ? 1 : 0;
+      }
+   result.resize(count);
+   return result;
+   }
+
+EmployeeStore::LookupResult EmployeeStore::lookup_sorted(std::span<CORBA::Long const> sorted_ids) const {
+   LookupResult result;
+   result.rows.reserve(sorted_ids.size());
+   auto pos = ids_.begin();
+   for (CORBA::Long personId : sorted_ids) {
+      pos = std::lower_bound(pos, ids_.end(), personId);
+      if (pos != ids_.end() && *pos == personId) result.rows.emplace_back(static_cast<row_ty>(pos - ids_.begin()));
+      else result.missing.emplace_back(personId);
+      }
+   return result;
+   }
+
+std::vector<EmployeeStore::row_ty> EmployeeStore::rows_by_name_prefix(std::string_view prefix, std::size_t limit) const {
+   std::vector<row_ty> result;
+   for (auto it = name_index_.lower_bound(prefix); it != name_index_.end() && result.size() < limit; ++it) {
+      if (!it->first.starts_with(prefix)) break;
+      result.emplace_back(index_.at(it->second));
+      }
+   return result;
+   }
+
+std::vector<EmployeeStore::row_ty> EmployeeStore::rows_started_between(std::chrono::year_month_day const& from,
+                                                                        std::chrono::year_month_day const& to) const {
+   std::vector<row_ty> result;
+   if (to < from) return result;
+   auto first = start_index_.lower_bound(from);
+   auto last  = start_index_.upper_bound(to);
+   result.reserve(std::distance(first, last));
+   for (auto it = first; it != last; ++it) result.emplace_back(index_.at(it->second));
+   return result;
+   }
+
+void EmployeeStore::rebuild_index(row_ty from) {
+   for (row_ty row = from; row < ids_.size(); ++row) index_.insert_or_assign(ids_[row], row);
+   }
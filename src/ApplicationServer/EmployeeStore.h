@@ -0,0 +1,373 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Columnar in-memory store for the employee records of the application server.
+
+  \details This file declares the class `EmployeeStore`, which replaces the former
+           `std::map<CORBA::Long, EmployeeData>` inside of `Company_i`. The records are
+           held column by column in contiguous vectors (structure of arrays). The hot
+           columns (`personId`, `salary`, `isActive`) are used by the aggregate functions
+           and the filters, so that these scans run over dense memory and can be vectorized
+           by the compiler instead of chasing the nodes of a red-black tree.
+
+  \details The rows are kept in ascending order of the person id. Appending an id greater
+           than all existing ids (the normal case for new employees and for ordered loads)
+           is amortized O(1). Inserting an id in the middle shifts the columns and is
+           therefore O(n), this is acceptable as rare case. The unordered id→row index
+           allows O(1) access to a single employee.
+
+  \version 1.0
+  \date    14.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "EmployeeData.h"
+#include "SalaryAggregates.h"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <optional>
+#include <ranges>
+#include <algorithm>
+#include <unordered_map>
+#include <map>
+#include <string_view>
+#include <span>
+#include <functional>
+#include <limits>
+#include <cstdint>
+
+/**
+  \brief Columns of a block of employees, filled by a loader and appended with \ref EmployeeStore::append.
+  \details The layout is the same as in the store, so the columns are moved into the store
+           without a conversion into EmployeeData records.
+ */
+struct EmployeeBatch {
+   std::vector<CORBA::Long>                  ids;          ///< person ids in ascending order
+   std::vector<double>                       salaries;     ///< current salary
+   std::vector<CORBA::Boolean>               active;       ///< employment status
+   std::vector<std::string>                  firstnames;   ///< first names of the persons
+   std::vector<std::string>                  names;        ///< last names of the persons
+   std::vector<Organization::EGender>        genders;      ///< gender as defined in the IDL enum
+   std::vector<std::chrono::year_month_day>  start_dates;  ///< start of employment
+
+   std::size_t size() const { return ids.size(); }
+
+   void reserve(std::size_t capacity) {
+      ids.reserve(capacity);   salaries.reserve(capacity); active.reserve(capacity);
+      firstnames.reserve(capacity); names.reserve(capacity); genders.reserve(capacity);
+      start_dates.reserve(capacity);
+      }
+   };
+
+/**
+  \brief Columnar (structure of arrays) container for employee records.
+
+  \details Every attribute of `EmployeeData` is stored in an own vector, all vectors have
+           the same length and the position in the vectors is the row of the employee.
+           The class offers access to single rows, materializes complete `EmployeeData`
+           records on demand and provides the scans for the aggregates used by `Company_i`.
+
+  \note The class isn't thread safe, synchronisation is the task of the owner.
+ */
+class EmployeeStore {
+public:
+   using row_ty     = std::uint32_t; ///< type for the position of an employee in the columns
+   using version_ty = std::uint64_t; ///< version of a change, increased with each change of the store
+
+   /// \brief removed employee, kept for the delta queries of the clients until the compaction
+   struct Tombstone {
+      CORBA::Long              personId = 0;
+      version_ty               version  = 0;     ///< version of the removal
+      std::chrono::sys_seconds removed  = { };   ///< time of the removal, decides the compaction
+      };
+
+   /// \brief result of \ref changes_since
+   struct ChangeSet {
+      version_ty               version = 0;      ///< version of the last delivered change or of the store, the client passes it with the next query
+      bool                     full    = false;  ///< no delta possible, the rows are walked from the first version, the client replaces its list
+      bool                     more    = false;  ///< the limit was reached, further changes follow after version
+      std::vector<row_ty>      rows;             ///< changed rows, ordered by the version of the change
+      std::vector<CORBA::Long> removed;          ///< removed employees, ordered by the version of the removal
+      };
+
+private:
+   // hot columns, used by scans and aggregates
+   std::vector<CORBA::Long>                  ids_;         ///< person ids in ascending order
+   std::vector<double>                       salaries_;    ///< current salary
+   std::vector<CORBA::Boolean>               active_;      ///< employment status (as byte, not as std::vector<bool>)
+
+   // cold columns, only used when a record is materialized
+   std::vector<std::string>                  firstnames_;  ///< first names of the persons
+   std::vector<std::string>                  names_;       ///< last names of the persons
+   std::vector<Organization::EGender>        genders_;     ///< gender as defined in the IDL enum
+   std::vector<std::chrono::year_month_day>  start_dates_; ///< start of employment
+
+   std::unordered_map<CORBA::Long, row_ty>   index_;       ///< person id → row
+
+   // secondary indexes, the values are person ids so the indexes survive shifts of the rows
+   std::multimap<std::string, CORBA::Long, std::less<>>  name_index_;  ///< last name → person id, for prefix search
+   std::multimap<std::chrono::year_month_day, CORBA::Long> start_index_; ///< start date → person id, for ranges
+
+   // versions of the changes for the delta queries, the index has one entry for each row
+   std::vector<version_ty>                   versions_;      ///< version of the last change of the row
+   std::map<version_ty, CORBA::Long>         change_index_;  ///< version → person id, for the changes since a version
+   std::vector<Tombstone>                    tombstones_;    ///< removed employees, ascending versions
+   version_ty                                version_   = 0; ///< version of the last change
+   version_ty                                compacted_ = 0; ///< removals up to this version are no longer known
+   version_ty                                restamped_ = 0; ///< versions up to this version were given before the last restamp
+
+   SalaryAggregates                          aggregates_;  ///< running aggregates of the active employees
+
+public:
+   EmployeeStore() = default;
+   EmployeeStore(EmployeeStore const&) = default;
+   EmployeeStore(EmployeeStore&&) noexcept = default;
+   EmployeeStore& operator = (EmployeeStore const&) = default;
+   EmployeeStore& operator = (EmployeeStore&&) noexcept = default;
+   ~EmployeeStore() = default;
+
+   /// \brief number of employees in the store
+   std::size_t size() const { return ids_.size(); }
+
+   /// \brief true when the store contains no employee
+   bool empty() const { return ids_.empty(); }
+
+   /// \brief reserves capacity in all columns and in the index
+   void reserve(std::size_t capacity);
+
+   /**
+     \brief Inserts a new employee or replaces the data of an existing one.
+     \param data complete record of the employee
+     \return true if the employee was new, false if an existing row was overwritten
+    */
+   bool insert(EmployeeData const& data);
+
+   /**
+     \brief Sets an employee to inactive and removes the salary from the aggregates.
+     \param personId id of the employee
+     \return true if the employee was active before, false if unknown or already inactive
+    */
+   bool deactivate(CORBA::Long personId);
+
+   /**
+     \brief Removes an employee from the store and leaves a tombstone for the delta queries.
+     \param personId id of the employee
+     \param now time of the removal, the tombstone is dropped by \ref compact_changes after the retention
+     \return true if the employee was removed, false if unknown
+    */
+   bool remove(CORBA::Long personId, std::chrono::sys_seconds now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+
+   /**
+     \brief Appends a block of employees with a bulk move of the columns.
+     \details When the ids of the batch are ascending and greater than the last id of the store,
+              the columns are moved at the end of the store and only the indexes and aggregates
+              are updated for each row. Otherwise every row is inserted with \ref insert.
+     \param batch columns of the employees, empty after the call
+     \return number of new employees
+    */
+   std::size_t append(EmployeeBatch&& batch);
+
+   /**
+     \brief Copies the columns of the store, e.g. for a snapshot.
+     \return batch with all employees in the order of the rows (ascending ids)
+    */
+   EmployeeBatch columns() const;
+
+   /**
+     \brief Seeks the row of an employee.
+     \param personId id of the employee
+     \return row of the employee or std::nullopt if the id isn't in the store
+    */
+   std::optional<row_ty> find(CORBA::Long personId) const {
+      if (auto it = index_.find(personId); it != index_.end()) [[likely]] return it->second;
+      else return std::nullopt;
+      }
+
+   /**
+     \brief First row with a person id not less than the given id.
+     \details The rows are ordered by the person id, a cursor which remembers the next person id
+              stays valid when rows are inserted or removed in front of it.
+     \return row in the range [0, size()]
+    */
+   row_ty lower_bound(CORBA::Long personId) const {
+      return static_cast<row_ty>(std::ranges::lower_bound(ids_, personId) - ids_.begin());
+      }
+
+   /// \brief result of \ref lookup_sorted
+   struct LookupResult {
+      std::vector<row_ty>      rows;    ///< rows of the found employees, ascending
+      std::vector<CORBA::Long> missing; ///< requested ids which aren't in the store, ascending
+      };
+
+   /**
+     \brief Seeks many employees with one merged pass over the sorted id column.
+     \details The search for the next id starts at the position of the previous hit, so the
+              id column is traversed once from the front to the back.
+     \param sorted_ids requested ids in ascending order without duplicates
+    */
+   LookupResult lookup_sorted(std::span<CORBA::Long const> sorted_ids) const;
+
+   /// \brief true if an employee with this id exists
+   bool contains(CORBA::Long personId) const { return index_.contains(personId); }
+
+   /// \brief version of the last change of the store
+   version_ty version() const { return version_; }
+
+   /**
+     \brief Rows changed and employees removed after a version, found with the index of the versions, O(log n + k).
+     \details The rows and the tombstones are merged in the order of their versions. With the limit the result
+              ends with the version of the last delivered change, the next query continues behind it.
+     \details A delta isn't possible for the version 0, for a version before the compacted tombstones or the
+              last restamp or after the version of the store (e.g. from a previous run of the server). Then the
+              rows are walked from the first version of the index and the result has the flag full. The pages
+              of this walk are continued with resync, because the versions of the walk can be older than the
+              compacted tombstones; the tombstones are kept long enough for the walk.
+     \param since version known by the client
+     \param resync true when the client continues the walk of a full result
+     \param limit maximal number of changed rows and removed employees
+    */
+   ChangeSet changes_since(version_ty since, bool resync = false, std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+
+   /**
+     \brief Gives all rows new versions above base and drops the tombstones, e.g. after a load or a restore.
+     \details All versions before are invalid afterwards, a client with an older version gets all rows.
+    */
+   void restamp(version_ty base);
+
+   /// \brief true if there are tombstones of removals before the cutoff
+   bool has_tombstones_before(std::chrono::sys_seconds cutoff) const {
+      return !tombstones_.empty() && tombstones_.front().removed < cutoff;
+      }
+
+   /**
+     \brief Drops the tombstones of the removals before the cutoff.
+     \details Clients with a version before the last dropped tombstone get all rows with the next query.
+     \return number of the dropped tombstones
+    */
+   std::size_t compact_changes(std::chrono::sys_seconds cutoff);
+
+   /**
+     \brief Materializes the complete record of a row.
+     \param row valid row of the store (precondition row < size())
+     \return copy of the record as EmployeeData
+    */
+   EmployeeData record(row_ty row) const;
+
+   /**
+     \brief Copies a row directly from the columns into the IDL structure.
+     \details Used for the bulk transfer, the values are written into an element of a
+              preallocated sequence without a temporary EmployeeData.
+     \param row valid row of the store (precondition row < size())
+     \param target IDL structure which receives the data
+    */
+   void copy_to(row_ty row, Organization::EmployeeData& target) const;
+
+   /**
+     \name Column accessors for a single row
+     \pre row < size()
+     \{
+    */
+   CORBA::Long                        personId(row_ty row) const  { return ids_[row]; }
+   double                             salary(row_ty row) const    { return salaries_[row]; }
+   CORBA::Boolean                     isActive(row_ty row) const  { return active_[row]; }
+   std::string const&                 firstname(row_ty row) const { return firstnames_[row]; }
+   std::string const&                 name(row_ty row) const      { return names_[row]; }
+   Organization::EGender              gender(row_ty row) const    { return genders_[row]; }
+   std::chrono::year_month_day const& startDate(row_ty row) const { return start_dates_[row]; }
+   version_ty                         rowVersion(row_ty row) const { return versions_[row]; }
+   /// \}
+
+   /**
+     \name Read-only access to the hot columns for scans
+     \{
+    */
+   std::vector<CORBA::Long> const&    ids() const      { return ids_; }
+   std::vector<double> const&         salaries() const { return salaries_; }
+   std::vector<CORBA::Boolean> const& active() const   { return active_; }
+   /// \}
+
+   /**
+     \brief Running aggregates of the active employees.
+     \details Maintained by insert() and deactivate(), reading them needs no scan over the columns.
+    */
+   SalaryAggregates const& aggregates() const { return aggregates_; }
+
+   /**
+     \brief Sum of the salaries of all active employees.
+     \details Branch-free reduction over the salary and the active column, the execution
+              policy `std::execution::unseq` allows the reordering of the additions and
+              with this the vectorization of the loop.
+    */
+   double sum_active_salaries() const;
+
+   /// \brief number of active employees, vectorized scan over the active column
+   std::size_t count_active() const;
+
+   /**
+     \brief Rows of all active employees in ascending order of the person id.
+     \details The rows are compacted without branches (write always, advance by flag).
+    */
+   std::vector<row_ty> active_rows() const;
+
+   /**
+     \brief Rows of the employees whose last name starts with the prefix.
+     \details Binary search in the name index and a walk over the matching entries, O(log n + k).
+              The comparison is case sensitive.
+     \param prefix beginning of the last name, an empty prefix matches all employees
+     \param limit maximal number of rows in the result
+     \return rows ordered by the last name
+    */
+   std::vector<row_ty> rows_by_name_prefix(std::string_view prefix, std::size_t limit) const;
+
+   /**
+     \brief Rows of the employees who started in the closed interval [from, to].
+     \details Range query over the ordered start date index, O(log n + k).
+     \return rows ordered by the start date
+    */
+   std::vector<row_ty> rows_started_between(std::chrono::year_month_day const& from, std::chrono::year_month_day const& to) const;
+
+   /// \brief View with all rows of the store
+   auto rows() const { return std::views::iota(row_ty { 0 }, static_cast<row_ty>(size())); }
+
+   /// \brief View with all records, each element is materialized as EmployeeData
+   auto records() const {
+      return rows() | std::views::transform([this](row_ty row) { return record(row); });
+      }
+
+private:
+   void rebuild_index(row_ty from);
+
+   /// \brief assigns the next version to the row and moves its entry in the index of the versions
+   void stamp(row_ty row);
+
+   /// \brief removes the entry of the person id in the range of a multimap index
+   template <typename index_ty, typename key_ty>
+   static void erase_from_index(index_ty& index, key_ty const& key, CORBA::Long personId) {
+      auto [first, last] = index.equal_range(key);
+      if (auto it = std::ranges::find_if(first, last, [personId](auto const& entry) { return entry.second == personId; }); it != last)
+         index.erase(it);
+      }
+};
@@ -0,0 +1,125 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Immutable versions of the employee store for readers without locks (copy-on-write).
+
+  \details This header declares the class `EmployeeVersions`. The current `EmployeeStore` is
+           published as immutable version through a `std::atomic<std::shared_ptr>`. A reader takes
+           the current version once at the begin of a request and works on it until the end, it
+           never waits for a writer and sees a consistent state even when a writer publishes a new
+           version meanwhile. The old version is released with the last reader which holds it.
+
+  \details A writer copies the current version, changes the copy and publishes it. The writers are
+           serialized by an own mutex, which the readers never touch. A copy of the store costs
+           O(n), several changes should be combined in one \ref EmployeeVersions::update.
+
+  \version 1.0
+  \date    12.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see EmployeeStore.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "EmployeeStore.h"
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/**
+  \brief Owner of the published versions of the employee store.
+ */
+class EmployeeVersions {
+public:
+   using version_ty = std::shared_ptr<EmployeeStore const>; ///< immutable version, holds the store alive for the reader
+
+private:
+   std::atomic<version_ty>    current_;     ///< published version
+   std::atomic<std::uint64_t> number_ = 1;  ///< number of the published version, counts the writes
+   std::mutex                 writer_;      ///< serializes the writers, never taken by a reader
+
+public:
+   EmployeeVersions() : current_(std::make_shared<EmployeeStore const>()) { }
+   explicit EmployeeVersions(EmployeeStore&& store) : current_(std::make_shared<EmployeeStore const>(std::move(store))) { }
+
+   EmployeeVersions(EmployeeVersions const&) = delete;
+   EmployeeVersions& operator = (EmployeeVersions const&) = delete;
+
+   /**
+     \brief Current version of the store.
+     \details The version should be taken once per request and used for all reads of the request.
+    */
+   version_ty current() const { return current_.load(std::memory_order_acquire); }
+
+   /// \brief number of the current version, increased with each published version
+   std::uint64_t number() const { return number_.load(std::memory_order_acquire); }
+
+   /**
+     \brief Changes a copy of the current version and publishes it.
+     \details The change function is called with the mutex of the writers held. When it throws,
+              the copy is dropped and the current version stays unchanged.
+     \param change function which changes the copy, `void (EmployeeStore&)` or with a result
+     \return result of the change function
+    */
+   template <typename func_ty>
+      requires std::invocable<func_ty&, EmployeeStore&>
+   decltype(auto) update(func_ty&& change) {
+      std::lock_guard lock(writer_);
+      auto next = std::make_shared<EmployeeStore>(*current_.load(std::memory_order_relaxed));
+      if constexpr (std::is_void_v<std::invoke_result_t<func_ty&, EmployeeStore&>>) {
+         change(*next);
+         publish(std::move(next));
+         }
+      else {
+         auto result = change(*next);
+         publish(std::move(next));
+         return result;
+         }
+      }
+
+   /**
+     \brief Publishes a new store without a copy, e.g. after a load from the database or a snapshot.
+     \details The rows get versions above the versions of the previous store and above the time of the
+              call in microseconds, so a client with a version of the previous store or of a previous run
+              of the server gets all employees with its next delta query.
+    */
+   void replace(EmployeeStore&& store) {
+      std::lock_guard lock(writer_);
+      auto const clock = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch());
+      store.restamp(std::max(current_.load(std::memory_order_relaxed)->version(), static_cast<EmployeeStore::version_ty>(clock.count())));
+      publish(std::make_shared<EmployeeStore const>(std::move(store)));
+      }
+
+private:
+   void publish(version_ty next) {
+      current_.store(std::move(next), std::memory_order_release);
+      number_.fetch_add(1, std::memory_order_release);
+      }
+   };
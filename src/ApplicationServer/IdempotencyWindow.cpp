@@ -0,0 +1,155 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the sliding window of the idempotency keys
+
+  \details The Bloom filters use double hashing: the bits of a key are h1 + i * h2 for i < k, with h1 and
+           h2 taken from one 64 bit hash. The number of bits is rounded up to a power of two, so a bit is
+           found with a mask instead of a division.
+
+  \version 1.0
+  \date    19.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "IdempotencyWindow.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+
+IdempotencyWindow::IdempotencyWindow(Config const& config) : config_(config) {
+   config_.buckets = std::max<std::size_t>(config_.buckets, 1);
+   config_.shards  = std::max<std::size_t>(config_.shards, 1);
+   slice_ = std::max(config_.window / static_cast<std::int64_t>(config_.buckets), std::chrono::milliseconds { 1 });
+
+   // size of the filters for the keys expected in one bucket of one shard, a new key is checked against
+   // all buckets of the window, so each filter gets the share of a bucket of the false positive rate
+   auto const expected = std::max<double>(static_cast<double>(config_.expected_keys) / static_cast<double>(config_.buckets * config_.shards), 64.0);
+   auto const rate     = std::clamp(config_.false_positive / static_cast<double>(config_.buckets), 1e-6, 0.5);
+   auto const bits     = std::bit_ceil(static_cast<std::uint64_t>(std::ceil(-expected * std::log(rate) / (std::numbers::ln2 * std::numbers::ln2))));
+   bloom_mask_   = std::max<std::uint64_t>(bits, 64) - 1;
+   bloom_hashes_ = std::clamp<std::size_t>(static_cast<std::size_t>(std::lround(static_cast<double>(bloom_mask_ + 1) / expected * std::numbers::ln2)), 1, 16);
+
+   shards_.reserve(config_.shards);
+   for (std::size_t i = 0; i < config_.shards; ++i) {
+      auto& shard = shards_.emplace_back(std::make_unique<Shard>());
+      shard->buckets.resize(config_.buckets);
+      for (auto& bucket : shard->buckets) bucket.bloom.assign((bloom_mask_ + 1) / 64, 0);
+      }
+   log_trace<4>("[IdempotencyWindow {}] window of {} in {} buckets, Bloom filters with {} bits and {} hashes.", ::getTimeStamp(),
+                config_.window, config_.buckets, bloom_mask_ + 1, bloom_hashes_);
+   }
+
+std::uint64_t IdempotencyWindow::hash(Key const& value) noexcept {
+   // splitmix64 finalizer over the key and the terminal
+   auto h = value.key ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(value.terminalId)) * 0x9E37'79B9'7F4A'7C15ull);
+   h = (h ^ (h >> 30)) * 0xBF58'476D'1CE4'E5B9ull;
+   h = (h ^ (h >> 27)) * 0x94D0'49BB'1331'11EBull;
+   return h ^ (h >> 31);
+   }
+
+bool IdempotencyWindow::may_contain(Bucket const& bucket, std::uint64_t hash) const {
+   auto const step = std::rotl(hash, 32) | 1;
+   for (std::size_t i = 0; i < bloom_hashes_; ++i, hash += step) {
+      auto const bit = hash & bloom_mask_;
+      if ((bucket.bloom[bit >> 6] & (std::uint64_t { 1 } << (bit & 63))) == 0) return false;
+      }
+   return true;
+   }
+
+void IdempotencyWindow::add_to_filter(Bucket& bucket, std::uint64_t hash) const {
+   auto const step = std::rotl(hash, 32) | 1;
+   for (std::size_t i = 0; i < bloom_hashes_; ++i, hash += step) {
+      auto const bit = hash & bloom_mask_;
+      bucket.bloom[bit >> 6] |= std::uint64_t { 1 } << (bit & 63);
+      }
+   }
+
+IdempotencyWindow::EKeyState IdempotencyWindow::add(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now, bool committed) {
+   Key const value { .terminalId = terminalId, .key = key };
+   auto const h       = hash(value);
+   auto const current = slice_of(now);
+   auto& target = shard(h);
+   ++checks_;
+
+   std::lock_guard lock(target.mutex);
+   bool filtered = true;
+   for (auto const& bucket : target.buckets) {
+      if (!is_live(bucket, current) || !may_contain(bucket, h)) continue;
+      filtered = false;
+      if (auto it = bucket.keys.find(value); it != bucket.keys.end()) {
+         if (it->second) {
+            ++duplicates_;
+            return EKeyState::Committed;
+            }
+         ++pending_;
+         return EKeyState::Pending;
+         }
+      ++false_positives_;
+      }
+   if (filtered) ++filtered_;
+
+   // the bucket of the current slice replaces the slice which left the window
+   auto& bucket = target.buckets[static_cast<std::size_t>(current) % target.buckets.size()];
+   if (bucket.slice != current) {
+      if (bucket.slice >= 0) ++expired_;
+      bucket.slice = current;
+      std::ranges::fill(bucket.bloom, 0);
+      bucket.keys.clear();
+      }
+   add_to_filter(bucket, h);
+   bucket.keys.emplace(value, committed);
+   return EKeyState::New;
+   }
+
+void IdempotencyWindow::commit(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now) {
+   Key const value { .terminalId = terminalId, .key = key };
+   auto const h       = hash(value);
+   auto const current = slice_of(now);
+   auto& target = shard(h);
+
+   std::lock_guard lock(target.mutex);
+   for (auto& bucket : target.buckets)
+      if (is_live(bucket, current))
+         if (auto it = bucket.keys.find(value); it != bucket.keys.end()) it->second = true;
+   }
+
+void IdempotencyWindow::erase(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now) {
+   Key const value { .terminalId = terminalId, .key = key };
+   auto const h       = hash(value);
+   auto const current = slice_of(now);
+   auto& target = shard(h);
+
+   std::lock_guard lock(target.mutex);
+   for (auto& bucket : target.buckets)
+      if (is_live(bucket, current)) bucket.keys.erase(value);
+   }
+
+IdempotencyWindow::Statistics IdempotencyWindow::statistics() const {
+   return { .checks = checks_.load(), .filtered = filtered_.load(), .duplicates = duplicates_.load(), .pending = pending_.load(),
+            .false_positives = false_positives_.load(), .expired = expired_.load() };
+   }
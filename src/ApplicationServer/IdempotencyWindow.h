@@ -0,0 +1,254 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Sliding window of the idempotency keys of the bookings, to drop the retries of the terminals.
+
+  \details This header declares the class `IdempotencyWindow`. A terminal which repeats a booking after a
+           TRANSIENT or COMM_FAILURE sends the same key again. The keys of the last minutes are kept in a
+           ring of time buckets, each bucket with a hash set and a small Bloom filter in front of it. A new
+           key, the common case, is recognized by the Bloom filters alone, only a hit of a filter is checked
+           in the hash set of the bucket. When the ring turns, the oldest bucket is cleared and reused, so
+           the memory depends on the bookings in the window and not on the running time of the server.
+           A key is pending while its first request is in progress and committed when the booking was
+           accepted, only a committed key answers a retry as duplicate.
+
+  \details The keys are distributed over shards with an own mutex like the employees of the `BookingLog`.
+           The keys are kept only in memory; after a restart the duplicate check of the booking log by
+           time point and kind remains.
+
+  \version 1.0
+  \date    19.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see BookingLog.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "BookingLog.h"
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+  \brief Idempotency keys of the bookings in the last minutes, in time buckets with Bloom filters.
+ */
+class IdempotencyWindow {
+public:
+   /// \brief state of a key in the window
+   enum class EKeyState : std::uint8_t {
+      New,        ///< the key wasn't in the window
+      Pending,    ///< the first request with the key is still in progress, its result is open
+      Committed   ///< the booking of the key was accepted
+      };
+
+   /// \brief configuration of the window
+   struct Config {
+      std::chrono::milliseconds window        = std::chrono::minutes { 10 }; ///< keys are known at least this long
+      std::size_t               buckets       = 10;        ///< time buckets of the ring, the window is split into them
+      std::size_t               shards        = 16;        ///< number of independent shards
+      std::size_t               expected_keys = 100'000;   ///< keys expected in one window, sizes the Bloom filters
+      double                    false_positive = 0.01;     ///< rate of the Bloom filters for a new key with the expected keys
+      };
+
+   /// \brief counters of the window
+   struct Statistics {
+      std::uint64_t checks          = 0; ///< keys checked
+      std::uint64_t filtered        = 0; ///< new keys recognized by the Bloom filters alone
+      std::uint64_t duplicates      = 0; ///< committed keys found in the window
+      std::uint64_t pending         = 0; ///< keys found while their first request was in progress
+      std::uint64_t false_positives = 0; ///< hits of a Bloom filter without the key in the bucket
+      std::uint64_t expired         = 0; ///< buckets cleared for a new time slice
+      };
+
+private:
+   /// \brief key of a terminal, the terminals generate their keys independently
+   struct Key {
+      CORBA::Long   terminalId = 0;
+      std::uint64_t key        = 0;
+      friend bool operator == (Key const&, Key const&) = default;
+      };
+
+   struct KeyHash {
+      std::size_t operator()(Key const& value) const noexcept { return static_cast<std::size_t>(hash(value)); }
+      };
+
+   /// \brief keys which arrived in one time slice
+   struct Bucket {
+      std::int64_t                     slice = -1;   ///< number of the time slice, -1 for an unused bucket
+      std::vector<std::uint64_t>       bloom;        ///< bits of the Bloom filter
+      std::unordered_map<Key, bool, KeyHash> keys;   ///< key → committed, false while the request is in progress
+      };
+
+   struct alignas(64) Shard {
+      std::mutex          mutex;
+      std::vector<Bucket> buckets;   ///< ring, the slice s is kept at s % buckets
+      };
+
+   Config                              config_;
+   std::chrono::milliseconds           slice_;          ///< duration of one bucket
+   std::uint64_t                       bloom_mask_ = 0; ///< number of bits of a filter - 1, a power of two
+   std::size_t                         bloom_hashes_ = 1;
+   std::vector<std::unique_ptr<Shard>> shards_;
+
+   std::atomic<std::uint64_t>          checks_          = 0;
+   std::atomic<std::uint64_t>          filtered_        = 0;
+   std::atomic<std::uint64_t>          duplicates_      = 0;
+   std::atomic<std::uint64_t>          pending_         = 0;
+   std::atomic<std::uint64_t>          false_positives_ = 0;
+   std::atomic<std::uint64_t>          expired_         = 0;
+
+public:
+   /**
+     \brief RAII reservation of a new key, the key is erased with the destructor unless it was committed.
+     \details A booking commits its key when it is accepted, every other result and every exception
+              releases the key, so the terminal may send the booking again. Until then the key is
+              pending, a retry meanwhile finds it with \ref state() EKeyState::Pending.
+    */
+   class Reservation {
+      friend class IdempotencyWindow;
+   private:
+      IdempotencyWindow* window_     = nullptr;
+      CORBA::Long        terminalId_ = 0;
+      std::uint64_t      key_        = 0;
+      booking_time_ty    now_        = { };
+      EKeyState          state_      = EKeyState::New;
+
+      Reservation(IdempotencyWindow* window, CORBA::Long terminalId, std::uint64_t key, booking_time_ty now)
+         : window_(window), terminalId_(terminalId), key_(key), now_(now) {}
+      explicit Reservation(EKeyState state) : state_(state) {}
+
+   public:
+      /// \brief empty reservation, e.g. for a booking without key
+      Reservation() = default;
+      Reservation(Reservation const&) = delete;
+      Reservation& operator = (Reservation const&) = delete;
+      Reservation(Reservation&& other) noexcept
+         : window_(std::exchange(other.window_, nullptr)), terminalId_(other.terminalId_), key_(other.key_), now_(other.now_),
+           state_(other.state_) {}
+      Reservation& operator = (Reservation&& other) noexcept {
+         if (this != &other) {
+            release();
+            window_     = std::exchange(other.window_, nullptr);
+            terminalId_ = other.terminalId_;
+            key_        = other.key_;
+            now_        = other.now_;
+            state_      = other.state_;
+            }
+         return *this;
+         }
+      ~Reservation() { release(); }
+
+      /// \brief true while the reservation holds a new key
+      explicit operator bool () const { return window_ != nullptr; }
+
+      /// \brief state of the key found by reserve(), EKeyState::New for a reserved key
+      EKeyState state() const { return state_; }
+
+      /// \brief marks the key as committed, e.g. when the booking was accepted, a retry is a duplicate from now on
+      void commit() noexcept {
+         if (window_ != nullptr) {
+            try {
+               window_->commit(terminalId_, key_, now_);
+               }
+            catch (...) { }   // a key which remains pending answers the retries with a new attempt
+            }
+         window_ = nullptr;
+         }
+
+   private:
+      void release() noexcept {
+         if (window_ != nullptr) {
+            try {
+               window_->erase(terminalId_, key_, now_);
+               }
+            catch (...) { }   // a key which remains only drops a retry within the window
+            }
+         window_ = nullptr;
+         }
+      };
+
+   IdempotencyWindow(IdempotencyWindow const&) = delete;
+   IdempotencyWindow& operator = (IdempotencyWindow const&) = delete;
+
+   IdempotencyWindow() : IdempotencyWindow(Config { }) {}
+   explicit IdempotencyWindow(Config const& config);
+
+   /**
+     \brief Checks a key and remembers it as committed when it is new.
+     \details Check and insert happen under the lock of the shard, so of two concurrent retries with the
+              same key only one is new.
+     \param terminalId terminal which generated the key
+     \param key idempotency key of the booking
+     \param now time of the arrival at the server, determines the bucket
+     \return true if the key is new, false if it arrived in the window before
+    */
+   bool insert(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now = BookingLog::now_ms()) {
+      return add(terminalId, key, now, true) == EKeyState::New;
+      }
+
+   /**
+     \brief Checks a key like \ref insert and reserves it as pending when it is new.
+     \return reservation of the key, empty (false) with the state of the key if it arrived in the window before
+    */
+   Reservation reserve(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now = BookingLog::now_ms()) {
+      auto const state = add(terminalId, key, now, false);
+      return state == EKeyState::New ? Reservation(this, terminalId, key, now) : Reservation(state);
+      }
+
+   /// \brief marks a pending key as committed, \p now is the time passed to reserve()
+   void commit(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now);
+
+   /**
+     \brief Forgets a key, e.g. when the booking was rejected and the terminal may send it again.
+     \details The bits of the Bloom filter remain set, a later check of the key finds the filter hit
+              and then the empty place in the hash set.
+    */
+   void erase(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now = BookingLog::now_ms());
+
+   /// \brief current counters of the window
+   Statistics statistics() const;
+
+private:
+   static std::uint64_t hash(Key const& value) noexcept;
+
+   /// \brief checks a key and adds it with the state committed or pending when it is new, \return state found before
+   EKeyState add(CORBA::Long terminalId, std::uint64_t key, booking_time_ty now, bool committed);
+
+   Shard& shard(std::uint64_t hash) const { return *shards_[(hash >> 40) % shards_.size()]; }
+
+   std::int64_t slice_of(booking_time_ty now) const { return now.time_since_epoch() / slice_; }
+
+   /// \brief true if the bucket holds a slice of the window ending with the slice current
+   bool is_live(Bucket const& bucket, std::int64_t current) const {
+      return bucket.slice >= 0 && bucket.slice <= current && current - bucket.slice < static_cast<std::int64_t>(config_.buckets);
+      }
+
+   bool may_contain(Bucket const& bucket, std::uint64_t hash) const;
+   void add_to_filter(Bucket& bucket, std::uint64_t hash) const;
+   };
@@ -0,0 +1,181 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the presence of the employees as dense bitset
+
+  \details The state of a row holds the time point of the last COME or GO and the presence in the lowest
+           bit. A booking replaces the state with a compare and swap when it isn't older. The bit is
+           written after the state and again when another booking of the same employee replaced the
+           state in between, so the bit always ends with the presence of the newest booking.
+
+  \version 1.0
+  \date    16.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "PresenceBoard.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+   /// \brief state of a row without a COME or GO
+   constexpr std::int64_t NoState = std::numeric_limits<std::int64_t>::min();
+
+   constexpr std::int64_t make_state(booking_time_ty timepoint, bool present) {
+      return (timepoint.time_since_epoch().count() << 1) | (present ? 1 : 0);
+      }
+
+   constexpr bool is_present(std::int64_t state) { return state != NoState && (state & 1) != 0; }
+
+   constexpr std::int64_t time_of(std::int64_t state) { return state >> 1; }
+
+   }
+
+std::int64_t PresenceBoard::state_from_bookings(CORBA::Long personId) const {
+   std::int64_t state = NoState;
+   for (auto const& event : bookings_.events(personId)) {
+      if (event.kind != Organization::COME && event.kind != Organization::GO) continue;
+      auto const next = make_state(event.timepoint, event.kind == Organization::COME);
+      if (state == NoState || time_of(next) >= time_of(state)) state = next;
+      }
+   return state;
+   }
+
+void PresenceBoard::bind() {
+   std::unique_lock lock(mutex_);
+   // the number is read before the version, a newer version is bound again with the next access
+   auto const number = employees_.number();
+   if (number == number_) return;
+   auto store = employees_.current();
+
+   auto const size  = store->size();
+   auto const words = (size + 63) / 64;
+   auto next_words  = std::make_unique<std::atomic<std::uint64_t>[]>(words);
+   auto next_states = std::make_unique<std::atomic<std::int64_t>[]>(size);
+   std::size_t present = 0, moved = 0;
+   for (EmployeeStore::row_ty row = 0; row < size; ++row) {
+      auto const personId = store->personId(row);
+      std::int64_t state = NoState;
+      if (auto old = store_ ? store_->find(personId) : std::nullopt; old) {
+         state = states_[*old].load(std::memory_order_relaxed);
+         ++moved;
+         }
+      else state = state_from_bookings(personId);
+      next_states[row].store(state, std::memory_order_relaxed);
+      if (is_present(state)) {
+         next_words[row / 64].fetch_or(std::uint64_t { 1 } << (row % 64), std::memory_order_relaxed);
+         ++present;
+         }
+      }
+
+   store_       = std::move(store);
+   number_      = number;
+   words_count_ = words;
+   words_       = std::move(next_words);
+   states_      = std::move(next_states);
+   count_.store(present, std::memory_order_release);
+   log_trace<4>("[PresenceBoard {}] bound to version {} of the employees, {} of {} employees present, {} states moved.", ::getTimeStamp(),
+                number, present, size, moved);
+   }
+
+std::shared_lock<std::shared_mutex> PresenceBoard::lock_current() {
+   for (;;) {
+      std::shared_lock lock(mutex_);
+      if (number_ == employees_.number()) [[likely]] return lock;
+      lock.unlock();
+      bind();
+      }
+   }
+
+void PresenceBoard::invalidate() {
+   std::unique_lock lock(mutex_);
+   store_.reset();
+   number_ = 0;
+   }
+
+bool PresenceBoard::set_bit(std::size_t row, bool present) {
+   auto const mask = std::uint64_t { 1 } << (row % 64);
+   auto& word = words_[row / 64];
+   if (present) {
+      if ((word.fetch_or(mask, std::memory_order_acq_rel) & mask) != 0) return false;
+      count_.fetch_add(1, std::memory_order_relaxed);
+      }
+   else {
+      if ((word.fetch_and(~mask, std::memory_order_acq_rel) & mask) == 0) return false;
+      count_.fetch_sub(1, std::memory_order_relaxed);
+      }
+   return true;
+   }
+
+std::optional<PresenceUpdate> PresenceBoard::apply(TimeBookingEvent const& event) {
+   if (event.kind != Organization::COME && event.kind != Organization::GO) return std::nullopt;
+
+   auto lock = lock_current();
+   auto const row = store_->find(event.personId);
+   if (!row) [[unlikely]] return std::nullopt;
+
+   auto& state = states_[*row];
+   auto const desired = make_state(event.timepoint, event.kind == Organization::COME);
+   auto current = state.load(std::memory_order_acquire);
+   do {
+      if (current != NoState && time_of(current) > time_of(desired)) return std::nullopt;  // older than the known state
+      }
+   while (!state.compare_exchange_weak(current, desired, std::memory_order_acq_rel, std::memory_order_acquire));
+
+   // the bit follows the newest state, also when another booking of the employee came in between
+   bool changed = false, present = false;
+   for (auto seen = desired;;) {
+      present  = is_present(seen);
+      changed |= set_bit(*row, present);
+      auto const now = state.load(std::memory_order_acquire);
+      if (now == seen) break;
+      seen = now;
+      }
+   if (!changed) return std::nullopt;
+   return PresenceUpdate { .personId = event.personId, .present = present, .timepoint = event.timepoint,
+                           .count = count_.load(std::memory_order_relaxed) };
+   }
+
+std::vector<CORBA::Long> PresenceBoard::present() {
+   auto lock = lock_current();
+   std::vector<CORBA::Long> result;
+   result.reserve(count_.load(std::memory_order_relaxed));
+   for (std::size_t index = 0; index < words_count_; ++index) {
+      for (auto bits = words_[index].load(std::memory_order_acquire); bits != 0; bits &= bits - 1) {
+         auto const row = index * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+         result.emplace_back(store_->personId(static_cast<EmployeeStore::row_ty>(row)));
+         }
+      }
+   return result;
+   }
+
+std::size_t PresenceBoard::count() {
+   auto lock = lock_current();
+   return count_.load(std::memory_order_acquire);
+   }
@@ -0,0 +1,120 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Presence of the employees as dense bitset, updated with the COME and GO bookings.
+
+  \details This header declares the class `PresenceBoard`. The board has one bit per row of the
+           employee store, set when the last booking of the employee is COME and cleared with GO. The
+           bits are words of `std::atomic<std::uint64_t>`, a booking changes its bit with one atomic
+           operation and the number of present employees is a counter next to it. The list of the
+           present employees is one pass over the words, without a scan over the bookings.
+
+  \details The rows belong to one version of the `EmployeeVersions`. When a new version is published,
+           the board is bound to it with the next access: the state of the known employees is moved to
+           their new rows, new employees get their state from the last COME or GO in the booking log.
+           A booking only wins against the state when it isn't older, so a late booking of a terminal
+           doesn't change the presence.
+
+  \version 1.0
+  \date    16.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see BookingLog.h
+  \see EmployeeVersions.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "BookingLog.h"
+#include "EmployeeVersions.h"
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+
+/// \brief change of the presence of an employee, the base for a delta event
+struct PresenceUpdate {
+   CORBA::Long     personId;
+   bool            present;
+   booking_time_ty timepoint;  ///< time point of the booking which changed the presence
+   std::size_t     count;      ///< number of present employees after the change
+   };
+
+/**
+  \brief Bitset of the present employees, keyed by the rows of the employee store.
+ */
+class PresenceBoard {
+private:
+   EmployeeVersions const&                       employees_;
+   BookingLog const&                             bookings_;
+
+   mutable std::shared_mutex                     mutex_;            ///< shared for the bits, exclusive to bind a new version
+   EmployeeVersions::version_ty                  store_;            ///< version of the rows
+   std::uint64_t                                 number_ = 0;       ///< number of the bound version, 0 = not bound
+   std::size_t                                   words_count_ = 0;
+   std::unique_ptr<std::atomic<std::uint64_t>[]> words_;            ///< bit per row, set when present
+   std::unique_ptr<std::atomic<std::int64_t>[]>  states_;           ///< per row (time point << 1) | present of the last booking
+   std::atomic<std::size_t>                      count_ = 0;
+
+public:
+   PresenceBoard() = delete;
+   PresenceBoard(PresenceBoard const&) = delete;
+   PresenceBoard& operator = (PresenceBoard const&) = delete;
+
+   /**
+     \param employees published versions of the employees, must outlive the board
+     \param bookings booking log to determine the state of employees without an own state
+    */
+   PresenceBoard(EmployeeVersions const& employees, BookingLog const& bookings) : employees_(employees), bookings_(bookings) { }
+
+   /**
+     \brief Applies an accepted booking.
+     \details Only COME and GO change the presence, during a break the employee stays present.
+     \return the change when the bit of the employee was changed, otherwise std::nullopt
+    */
+   std::optional<PresenceUpdate> apply(TimeBookingEvent const& event);
+
+   /// \brief ids of the present employees in ascending order
+   std::vector<CORBA::Long> present();
+
+   /// \brief number of the present employees, without a pass over the bits
+   std::size_t count();
+
+   /// \brief drops the state, the next access determines the presence of all employees from the booking log
+   void invalidate();
+
+private:
+   /// \brief binds the board to the current version of the employees, when it isn't bound to it
+   void bind();
+
+   /// \brief takes the shared lock with the board bound to the current version
+   std::shared_lock<std::shared_mutex> lock_current();
+
+   /// \brief sets or clears the bit of a row, \return true when the bit was changed
+   bool set_bit(std::size_t row, bool present);
+
+   /// \brief state of an employee from the last COME or GO in the booking log
+   std::int64_t state_from_bookings(CORBA::Long personId) const;
+   };
@@ -0,0 +1,105 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the delta events of the presence
+
+  \version 1.0
+  \date    16.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "PresenceEvents.h"
+
+#include "Tools.h"
+#include <BasicUtils.h>
+#include "my_logging.h"
+
+#include <vector>
+#include <algorithm>
+
+PresenceEvents::PresenceEvents(CORBA::ORB_ptr orb, PortableServer::POA_ptr poa, CosEventChannelAdmin::EventChannel_ptr channel,
+                               Config const& config) : config_(config) {
+   config_.max_pending = std::max<std::size_t>(config_.max_pending, 1);
+   CosEventChannelAdmin::SupplierAdmin_var admin = channel->for_suppliers();
+   consumer_ = admin->obtain_push_consumer();
+   supplier_ = new supplier_ty(orb, poa, consumer_.in());
+   CosEventComm::PushSupplier_var reference = supplier_->_this();
+   consumer_->connect_push_supplier(reference.in());
+   thread_ = std::jthread([this](std::stop_token token) { run(token); });
+   log_trace<2>("[PresenceEvents {}] push supplier for the presence events connected.", ::getTimeStamp());
+   }
+
+PresenceEvents::~PresenceEvents() {
+   thread_.request_stop();
+   if (thread_.joinable()) thread_.join();
+   try {
+      supplier_->disconnect_push_supplier();
+      PortableServer::POA_var poa = supplier_->_default_POA();
+      PortableServer::ObjectId_var oid = poa->servant_to_id(supplier_.in());
+      poa->deactivate_object(oid.in());
+      }
+   catch (CORBA::Exception const& ex) {
+      log_error("[PresenceEvents {}] push supplier not disconnected: {}", ::getTimeStamp(), toString(ex));
+      }
+   log_trace<2>("[PresenceEvents {}] push supplier disconnected, {} events pushed, {} dropped.", ::getTimeStamp(),
+                pushed_.load(), dropped_.load());
+   }
+
+void PresenceEvents::publish(PresenceUpdate const& update) {
+   {
+      std::lock_guard lock(mutex_);
+      if (pending_.size() >= config_.max_pending) [[unlikely]] {
+         pending_.pop_front();
+         ++dropped_;
+         }
+      pending_.emplace_back(update);
+   }
+   wakeup_.notify_one();
+   }
+
+void PresenceEvents::run(std::stop_token token) {
+   std::vector<PresenceUpdate> batch;
+   while (!token.stop_requested()) {
+      {
+         std::unique_lock lock(mutex_);
+         if (!wakeup_.wait(lock, token, [this]() { return !pending_.empty(); })) break;
+         batch.assign(pending_.begin(), pending_.end());
+         pending_.clear();
+      }
+      // the channel is called without the lock, the bookings only wait for the queue
+      for (auto const& update : batch) {
+         Organization::PresenceChange const change { .personId     = update.personId,
+                                                     .present      = update.present,
+                                                     .timepoint    = convert<Basics::TimePoint>(std::chrono::system_clock::time_point { update.timepoint }),
+                                                     .presentCount = static_cast<CORBA::ULong>(update.count) };
+         try {
+            supplier_->push_event(change);
+            ++pushed_;
+            }
+         catch (CORBA::Exception const& ex) {
+            ++dropped_;
+            log_error("[PresenceEvents {}] presence event for ID {} not pushed: {}", ::getTimeStamp(), update.personId, toString(ex));
+            }
+         }
+      batch.clear();
+      }
+   }
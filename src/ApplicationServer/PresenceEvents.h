@@ -0,0 +1,111 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Delta events of the presence of the employees over an event channel.
+
+  \details This header declares the class `PresenceEvents`. Each change of the `PresenceBoard` is
+           pushed as `Organization::PresenceChange` with the `TEvent_PushSupplier` of CorbaEvent.h
+           to the event channel, so the displays at the reception are updated without polling.
+           The booking only puts the change into a queue, an own thread pushes the queued changes,
+           so a slow event channel doesn't delay the bookings. When the queue is full, the oldest
+           changes are dropped, a display can read the full list with getPresentEmployees().
+
+  \version 1.0
+  \date    16.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see PresenceBoard.h
+  \see CorbaEvent.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "PresenceBoard.h"
+
+#include <CorbaEvent.h>
+
+#include "OrganizationS.h"
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+/**
+  \brief Pushes the changes of the presence as events to an event channel.
+ */
+class PresenceEvents {
+public:
+   using supplier_ty = TEvent_PushSupplier<Organization::PresenceChange>;
+
+   /// \brief configuration of the queue
+   struct Config {
+      std::size_t max_pending = 10'000;  ///< changes in the queue, older changes are dropped
+      };
+
+   /// \brief counters of the events
+   struct Statistics {
+      std::uint64_t pushed  = 0;  ///< events pushed to the channel
+      std::uint64_t dropped = 0;  ///< events dropped because of a full queue or a failed push
+      };
+
+private:
+   Config                                      config_;
+   CosEventChannelAdmin::ProxyPushConsumer_var consumer_;
+   PortableServer::Servant_var<supplier_ty>    supplier_;
+
+   std::mutex                                  mutex_;
+   std::condition_variable_any                 wakeup_;
+   std::deque<PresenceUpdate>                  pending_;
+   std::atomic<std::uint64_t>                  pushed_  = 0;
+   std::atomic<std::uint64_t>                  dropped_ = 0;
+   std::jthread                                thread_;   ///< last member, started after all others are initialized
+
+public:
+   PresenceEvents() = delete;
+   PresenceEvents(PresenceEvents const&) = delete;
+   PresenceEvents& operator = (PresenceEvents const&) = delete;
+
+   /**
+     \brief Connects a push supplier to the event channel and starts the thread for the events.
+     \param orb ORB of the server
+     \param poa POA of the server, used for the push supplier
+     \param channel event channel for the presence events
+     \throws CORBA::Exception when the channel can't be reached
+    */
+   PresenceEvents(CORBA::ORB_ptr orb, PortableServer::POA_ptr poa, CosEventChannelAdmin::EventChannel_ptr channel)
+      : PresenceEvents(orb, poa, channel, Config { }) { }
+   PresenceEvents(CORBA::ORB_ptr orb, PortableServer::POA_ptr poa, CosEventChannelAdmin::EventChannel_ptr channel, Config const& config);
+
+   /// \brief stops the thread and disconnects the supplier, pending changes are dropped
+   ~PresenceEvents();
+
+   /// \brief queues a change for the event channel, never blocks on the channel
+   void publish(PresenceUpdate const& update);
+
+   Statistics statistics() const { return { .pushed = pushed_, .dropped = dropped_ }; }
+
+private:
+   void run(std::stop_token token);
+   };
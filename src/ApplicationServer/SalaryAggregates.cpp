@@ -0,0 +1,148 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the incremental salary aggregates and the salary sketch
+
+  \details The representative value of a bucket of the sketch is 2 * gamma^i / (gamma + 1).
+           With this value the relative error for every salary in the bucket is at most alpha.
+
+  \version 1.0
+  \date    25.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "SalaryAggregates.h"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <format>
+
+// -------------------------------------------------------------------------------------
+// SalarySketch
+// -------------------------------------------------------------------------------------
+
+SalarySketch::SalarySketch(double relative_accuracy) : alpha_(relative_accuracy) {
+   if (!(alpha_ > 0.0 && alpha_ < 1.0))
+      throw std::invalid_argument(std::format("[SalarySketch] relative accuracy {} out of range (0, 1).", alpha_));
+   gamma_     = (1.0 + alpha_) / (1.0 - alpha_);
+   log_gamma_ = std::log(gamma_);
+   }
+
+int SalarySketch::index(double salary) const {
+   return static_cast<int>(std::ceil(std::log(salary) / log_gamma_));
+   }
+
+double SalarySketch::lower_bound(int index) const {
+   return std::pow(gamma_, index - 1);
+   }
+
+double SalarySketch::upper_bound(int index) const {
+   return std::pow(gamma_, index);
+   }
+
+void SalarySketch::add(double salary) {
+   if (salary <= 0.0) ++zero_count_;
+   else ++buckets_[index(salary)];
+   ++count_;
+   }
+
+void SalarySketch::remove(double salary) {
+   if (salary <= 0.0) {
+      if (zero_count_ == 0) return;
+      --zero_count_;
+      }
+   else {
+      auto it = buckets_.find(index(salary));
+      if (it == buckets_.end()) return;
+      if (--it->second == 0) buckets_.erase(it);
+      }
+   --count_;
+   }
+
+void SalarySketch::merge(SalarySketch const& other) {
+   if (other.alpha_ != alpha_)
+      throw std::invalid_argument(std::format("[SalarySketch] can't merge sketches with accuracy {} and {}.", alpha_, other.alpha_));
+   for (auto const& [idx, cnt] : other.buckets_) buckets_[idx] += cnt;
+   zero_count_ += other.zero_count_;
+   count_      += other.count_;
+   }
+
+std::optional<double> SalarySketch::quantile(double q) const {
+   if (count_ == 0) return std::nullopt;
+   q = std::clamp(q, 0.0, 1.0);
+   auto const rank = static_cast<std::uint64_t>(q * static_cast<double>(count_ - 1));
+   if (rank < zero_count_) return 0.0;
+   std::uint64_t seen = zero_count_;
+   for (auto const& [idx, cnt] : buckets_) {
+      seen += cnt;
+      if (seen > rank) return 2.0 * upper_bound(idx) / (gamma_ + 1.0);
+      }
+   return 2.0 * upper_bound(buckets_.rbegin()->first) / (gamma_ + 1.0);
+   }
+
+std::vector<SalarySketch::Bucket> SalarySketch::buckets() const {
+   std::vector<Bucket> result;
+   result.reserve(buckets_.size() + 1);
+   if (zero_count_ > 0) result.push_back({ .lower = 0.0, .upper = 0.0, .count = zero_count_ });
+   for (auto const& [idx, cnt] : buckets_)
+      result.push_back({ .lower = lower_bound(idx), .upper = upper_bound(idx), .count = cnt });
+   return result;
+   }
+
+// -------------------------------------------------------------------------------------
+// SalaryAggregate
+// -------------------------------------------------------------------------------------
+
+void SalaryAggregate::add(double salary) {
+   salaries_.insert(salary);
+   sum_ += salary;
+   }
+
+void SalaryAggregate::remove(double salary) {
+   if (auto it = salaries_.find(salary); it != salaries_.end()) {
+      salaries_.erase(it);
+      // with the last salary the sum is reset, rounding errors of the running sum don't accumulate
+      sum_ = salaries_.empty() ? 0.0 : sum_ - salary;
+      }
+   }
+
+// -------------------------------------------------------------------------------------
+// SalaryAggregates
+// -------------------------------------------------------------------------------------
+
+void SalaryAggregates::add(Organization::EGender gender, int start_year, double salary) {
+   total_.add(salary);
+   by_gender_[static_cast<std::size_t>(gender)].add(salary);
+   by_start_year_[start_year].add(salary);
+   sketch_.add(salary);
+   }
+
+void SalaryAggregates::remove(Organization::EGender gender, int start_year, double salary) {
+   total_.remove(salary);
+   by_gender_[static_cast<std::size_t>(gender)].remove(salary);
+   if (auto it = by_start_year_.find(start_year); it != by_start_year_.end()) {
+      it->second.remove(salary);
+      if (it->second.count() == 0) by_start_year_.erase(it);
+      }
+   sketch_.remove(salary);
+   }
@@ -0,0 +1,158 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Incrementally maintained salary and headcount aggregates of the employee store.
+
+  \details This header declares the classes `SalarySketch`, `SalaryAggregate` and
+           `SalaryAggregates`. The `EmployeeStore` updates them with every change of an
+           active employee, so that sums, counts, minimum and maximum are available
+           without a scan over the columns.
+
+  \details The `SalarySketch` distributes the salaries into logarithmic buckets with a fixed
+           relative accuracy. The buckets can be added and subtracted, two sketches can be
+           merged (e.g. of different companies or different servers), and approximate
+           percentiles are read by a walk over the buckets.
+
+  \version 1.0
+  \date    25.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see EmployeeStore.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "OrganizationC.h"
+
+#include <array>
+#include <map>
+#include <set>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+/**
+  \brief Mergeable sketch with logarithmic buckets for approximate salary percentiles.
+
+  \details A salary x > 0 is counted in the bucket i = ceil(log(x) / log(gamma)) with
+           gamma = (1 + alpha) / (1 - alpha). Every value in a bucket is at most alpha
+           (relative) away from the representative value of the bucket, independent of the
+           distribution of the salaries. Values less or equal 0 are counted separately.
+ */
+class SalarySketch {
+public:
+   /// \brief bucket of the sketch as half-open interval (lower, upper] of salaries
+   struct Bucket {
+      double        lower;  ///< lower bound of the bucket (exclusive)
+      double        upper;  ///< upper bound of the bucket (inclusive)
+      std::uint64_t count;  ///< number of salaries in the bucket
+      };
+
+private:
+   double                        alpha_;       ///< relative accuracy of the sketch
+   double                        gamma_;       ///< base of the logarithmic buckets
+   double                        log_gamma_;   ///< log(gamma_), cached for the index calculation
+   std::map<int, std::uint64_t>  buckets_;     ///< bucket index → count, only buckets with count > 0
+   std::uint64_t                 zero_count_ = 0; ///< salaries less or equal 0
+   std::uint64_t                 count_      = 0; ///< number of all salaries in the sketch
+
+public:
+   /// \param relative_accuracy relative accuracy alpha of the percentiles, in (0, 1)
+   explicit SalarySketch(double relative_accuracy = 0.01);
+
+   void add(double salary);
+
+   /// \brief removes a salary which was added before
+   void remove(double salary);
+
+   /**
+     \brief Adds the counts of another sketch.
+     \pre both sketches have the same relative accuracy
+     \throws std::invalid_argument if the relative accuracies differ
+    */
+   void merge(SalarySketch const& other);
+
+   /**
+     \brief Approximate value of the quantile q.
+     \param q quantile in [0, 1], e.g. 0.5 for the median
+     \return representative value of the bucket with the quantile, std::nullopt for an empty sketch
+    */
+   std::optional<double> quantile(double q) const;
+
+   /// \brief buckets with at least one salary in ascending order
+   std::vector<Bucket> buckets() const;
+
+   std::uint64_t count() const { return count_; }
+   double relative_accuracy() const { return alpha_; }
+
+private:
+   int    index(double salary) const;
+   double lower_bound(int index) const;
+   double upper_bound(int index) const;
+   };
+
+/**
+  \brief Running sum, count, minimum and maximum for a group of salaries.
+  \details The multiset keeps minimum and maximum correct when a salary is removed.
+ */
+class SalaryAggregate {
+private:
+   double                  sum_ = 0.0;  ///< running sum of the salaries
+   std::multiset<double>   salaries_;   ///< all salaries of the group, ordered
+
+public:
+   void add(double salary);
+   void remove(double salary);
+
+   std::size_t count() const { return salaries_.size(); }
+   double sum() const { return sum_; }
+   double average() const { return salaries_.empty() ? 0.0 : sum_ / salaries_.size(); }
+   std::optional<double> min() const { if (salaries_.empty()) return std::nullopt; else return *salaries_.begin(); }
+   std::optional<double> max() const { if (salaries_.empty()) return std::nullopt; else return *salaries_.rbegin(); }
+   };
+
+/**
+  \brief Aggregates of all active employees, in total and grouped by gender and start year.
+ */
+class SalaryAggregates {
+public:
+   static constexpr std::size_t GenderCount = 3; ///< number of values in Organization::EGender
+
+private:
+   SalaryAggregate                              total_;         ///< all active employees
+   std::array<SalaryAggregate, GenderCount>     by_gender_;     ///< active employees grouped by gender
+   std::map<int, SalaryAggregate>               by_start_year_; ///< active employees grouped by year of entry
+   SalarySketch                                 sketch_;        ///< distribution of the salaries of the active employees
+
+public:
+   /// \brief adds an active employee to all groups
+   void add(Organization::EGender gender, int start_year, double salary);
+
+   /// \brief removes an active employee from all groups
+   void remove(Organization::EGender gender, int start_year, double salary);
+
+   SalaryAggregate const& total() const { return total_; }
+   SalaryAggregate const& by_gender(Organization::EGender gender) const { return by_gender_[static_cast<std::size_t>(gender)]; }
+   std::map<int, SalaryAggregate> const& by_start_year() const { return by_start_year_; }
+   SalarySketch const& sketch() const { return sketch_; }
+   };
@@ -0,0 +1,323 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the binary snapshots of the employees and bookings
+
+  \details A snapshot file consists of the header, the employee records, the booking records and
+           the pool with the names. The file is written as memory mapping into a temporary file,
+           synced and renamed, so a crash during the write never leaves a partial snapshot with the
+           final name.
+
+  \version 1.0
+  \date    11.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "StateSnapshot.h"
+#include "DurableFiles.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <ace/Mem_Map.h>
+
+#include <algorithm>
+#include <utility>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include <format>
+#include <cstring>
+#include <cstddef>
+
+namespace {
+
+   constexpr char SnapshotMagic[8] = { 'W', 'T', 'R', 'S', 'N', 'A', 'P', '1' };
+
+   std::uint32_t checksum(SnapshotHeader const& header) { return crc32(&header, offsetof(SnapshotHeader, checksum)); }
+
+   /// snapshot files of the directory with their journal sequence, ordered by the sequence
+   std::vector<std::pair<std::uint64_t, std::filesystem::path>> list_snapshots(std::filesystem::path const& directory) {
+      std::vector<std::pair<std::uint64_t, std::filesystem::path>> snapshots;
+      if (!std::filesystem::is_directory(directory)) return snapshots;
+      for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+         auto const name = entry.path().filename().string();
+         if (!entry.is_regular_file() || !name.starts_with("snapshot_") || entry.path().extension() != ".wts") continue;
+         auto const digits = std::string_view { name }.substr(9, 20);
+         std::uint64_t sequence = 0;
+         if (auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), sequence); ec == std::errc { })
+            snapshots.emplace_back(sequence, entry.path());
+         }
+      std::ranges::sort(snapshots);
+      return snapshots;
+      }
+
+   }
+
+SnapshotManager::SnapshotManager(Config config) : config_(std::move(config)) {
+   config_.keep         = std::max<std::size_t>(config_.keep, 1);
+   config_.replay_block = std::max<std::size_t>(config_.replay_block, 1);
+   }
+
+SnapshotManager::~SnapshotManager() {
+   stop();
+   }
+
+std::uint64_t SnapshotManager::write(StateSnapshot const& snapshot) const {
+   auto const start = std::chrono::steady_clock::now();
+   auto const& employees = snapshot.employees;
+
+   std::size_t string_bytes = 0;
+   for (std::size_t i = 0; i < employees.size(); ++i) string_bytes += employees.firstnames[i].size() + employees.names[i].size();
+   if (string_bytes > std::numeric_limits<std::uint32_t>::max())
+      throw std::runtime_error(std::format("[SnapshotManager {}] names exceed the size of the snapshot format.", ::getTimeStamp()));
+
+   std::size_t const employee_bytes = employees.size() * sizeof(SnapshotEmployee);
+   std::size_t const booking_bytes  = snapshot.bookings.size() * sizeof(SnapshotBooking);
+   std::size_t const absence_bytes  = sizeof(std::uint64_t) + snapshot.absences.size() * sizeof(SnapshotAbsence);
+   std::size_t const total_bytes    = sizeof(SnapshotHeader) + employee_bytes + booking_bytes + absence_bytes + string_bytes;
+
+   std::filesystem::create_directories(config_.directory);
+   auto const final_path = config_.directory / std::format("snapshot_{:020}.wts", snapshot.journal_sequence);
+   auto temp_path = final_path;
+   temp_path += ".tmp";
+   std::error_code ignore;
+   std::filesystem::remove(temp_path, ignore);
+
+   ACE_Mem_Map map;
+   if (map.map(ACE_TEXT_CHAR_TO_TCHAR(temp_path.string().c_str()), total_bytes, O_RDWR | O_CREAT | O_TRUNC,
+               ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_SHARED) == -1)
+      throw std::runtime_error(std::format("[SnapshotManager {}] snapshot {} can't be created.", ::getTimeStamp(), temp_path.string()));
+
+   auto* base            = static_cast<char*>(map.addr());
+   auto* employee_target = reinterpret_cast<SnapshotEmployee*>(base + sizeof(SnapshotHeader));
+   auto* booking_target  = reinterpret_cast<SnapshotBooking*>(base + sizeof(SnapshotHeader) + employee_bytes);
+   char* absence_section = base + sizeof(SnapshotHeader) + employee_bytes + booking_bytes;
+   auto* absence_target  = reinterpret_cast<SnapshotAbsence*>(absence_section + sizeof(std::uint64_t));
+   char* pool            = absence_section + absence_bytes;
+
+   std::uint32_t offset = 0;
+   auto add_string = [pool, &offset](std::string const& value) {
+      std::memcpy(pool + offset, value.data(), value.size());
+      return std::exchange(offset, static_cast<std::uint32_t>(offset + value.size()));
+      };
+   for (std::size_t i = 0; i < employees.size(); ++i) {
+      SnapshotEmployee record { };
+      record.personId         = employees.ids[i];
+      record.start_date       = std::chrono::sys_days { employees.start_dates[i] }.time_since_epoch().count();
+      record.firstname_length = static_cast<std::uint32_t>(employees.firstnames[i].size());
+      record.firstname_offset = add_string(employees.firstnames[i]);
+      record.name_length      = static_cast<std::uint32_t>(employees.names[i].size());
+      record.name_offset      = add_string(employees.names[i]);
+      record.salary           = employees.salaries[i];
+      record.gender           = static_cast<std::uint8_t>(employees.genders[i]);
+      record.active           = employees.active[i] ? 1 : 0;
+      employee_target[i] = record;
+      }
+   for (std::size_t i = 0; auto const& booking : snapshot.bookings) {
+      booking_target[i++] = SnapshotBooking { .timepoint = booking.timepoint.time_since_epoch().count(), .personId = booking.personId,
+                                              .terminalId = booking.terminalId, .kind = static_cast<std::uint16_t>(booking.kind),
+                                              .reserved = { } };
+      }
+   std::memcpy(absence_section, &snapshot.next_absence_id, sizeof(std::uint64_t));
+   for (std::size_t i = 0; auto const& absence : snapshot.absences) {
+      absence_target[i++] = SnapshotAbsence { .absenceId = absence.absenceId, .personId = absence.personId,
+                                              .from = static_cast<std::int32_t>(absence.from.time_since_epoch().count()),
+                                              .to = static_cast<std::int32_t>(absence.to.time_since_epoch().count()),
+                                              .kind = static_cast<std::uint8_t>(absence.kind), .approved = absence.approved ? std::uint8_t { 1 } : std::uint8_t { 0 },
+                                              .reserved = { } };
+      }
+
+   SnapshotHeader header { };
+   std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+   header.journal_sequence = snapshot.journal_sequence;
+   header.created          = static_cast<std::uint64_t>(BookingLog::now_ms().time_since_epoch().count());
+   header.employee_count   = employees.size();
+   header.booking_count    = snapshot.bookings.size();
+   header.string_bytes     = string_bytes;
+   header.absence_bytes    = absence_bytes;
+   header.payload_checksum = crc32(base + sizeof(SnapshotHeader), total_bytes - sizeof(SnapshotHeader));
+   header.checksum         = checksum(header);
+   std::memcpy(base, &header, sizeof(SnapshotHeader));
+
+   if (map.sync() == -1 || ACE_OS::fsync(map.handle()) == -1)
+      throw std::runtime_error(std::format("[SnapshotManager {}] snapshot {} can't be synced.", ::getTimeStamp(), temp_path.string()));
+   map.close();
+   std::filesystem::rename(temp_path, final_path);
+   // without a durable directory entry the new snapshot could be lost, the journal must not be compacted
+   if (!SyncDirectory(config_.directory))
+      throw std::runtime_error(std::format("[SnapshotManager {}] directory {} can't be synced after the rename of {}.", ::getTimeStamp(),
+                                           config_.directory.string(), final_path.filename().string()));
+
+   // older snapshots beyond the configured number are removed
+   auto snapshots = list_snapshots(config_.directory);
+   while (snapshots.size() > config_.keep) {
+      std::error_code error;
+      if (!std::filesystem::remove(snapshots.front().second, error))
+         log_error("[SnapshotManager {}] snapshot {} can't be removed: {}", ::getTimeStamp(), snapshots.front().second.string(), error.message());
+      snapshots.erase(snapshots.begin());
+      }
+
+   log_trace<2>("[SnapshotManager {}] snapshot {} with {} employees, {} bookings and {} absences written in {} ({} bytes).", ::getTimeStamp(),
+                final_path.filename().string(), employees.size(), snapshot.bookings.size(), snapshot.absences.size(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start), total_bytes);
+   return snapshots.empty() ? 0 : snapshots.front().first;
+   }
+
+bool SnapshotManager::load_file(std::filesystem::path const& file, EmployeeStore& store, bookings_ty const& bookings,
+                                absences_ty const& absences, LoadStatistics& stats) const {
+   ACE_Mem_Map map;
+   if (map.map(ACE_TEXT_CHAR_TO_TCHAR(file.string().c_str()), static_cast<size_t>(-1), O_RDONLY,
+               ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_PRIVATE) == -1 || map.size() < sizeof(SnapshotHeader)) {
+      log_error("[SnapshotManager {}] snapshot {} can't be opened.", ::getTimeStamp(), file.string());
+      return false;
+      }
+
+   auto const* base = static_cast<char const*>(map.addr());
+   SnapshotHeader header;
+   std::memcpy(&header, base, sizeof(SnapshotHeader));
+   std::size_t const employee_bytes = header.employee_count * sizeof(SnapshotEmployee);
+   std::size_t const booking_bytes  = header.booking_count * sizeof(SnapshotBooking);
+   // older snapshots have no absences, otherwise the next absence id is followed by the records
+   bool const with_absences = header.absence_bytes > 0;
+   if (std::memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 || header.checksum != checksum(header) ||
+       map.size() != sizeof(SnapshotHeader) + employee_bytes + booking_bytes + header.absence_bytes + header.string_bytes ||
+       (with_absences && (header.absence_bytes < sizeof(std::uint64_t) ||
+                          (header.absence_bytes - sizeof(std::uint64_t)) % sizeof(SnapshotAbsence) != 0)) ||
+       header.payload_checksum != crc32(base + sizeof(SnapshotHeader), map.size() - sizeof(SnapshotHeader))) {
+      log_error("[SnapshotManager {}] snapshot {} is damaged.", ::getTimeStamp(), file.string());
+      return false;
+      }
+
+   auto const* employee_source = reinterpret_cast<SnapshotEmployee const*>(base + sizeof(SnapshotHeader));
+   auto const* booking_source  = reinterpret_cast<SnapshotBooking const*>(base + sizeof(SnapshotHeader) + employee_bytes);
+   char const* absence_section = base + sizeof(SnapshotHeader) + employee_bytes + booking_bytes;
+   std::string_view const pool { absence_section + header.absence_bytes, header.string_bytes };
+
+   EmployeeBatch batch;
+   batch.reserve(header.employee_count);
+   for (auto const& record : std::span(employee_source, header.employee_count)) {
+      batch.ids.emplace_back(record.personId);
+      batch.firstnames.emplace_back(pool.substr(record.firstname_offset, record.firstname_length));
+      batch.names.emplace_back(pool.substr(record.name_offset, record.name_length));
+      batch.genders.emplace_back(static_cast<Organization::EGender>(std::min<std::uint8_t>(record.gender, Organization::OTHER)));
+      batch.salaries.emplace_back(record.salary);
+      batch.start_dates.emplace_back(std::chrono::sys_days { std::chrono::days { record.start_date } });
+      batch.active.emplace_back(record.active != 0);
+      }
+   stats.employees = store.append(std::move(batch));
+
+   std::vector<TimeBookingEvent> block;
+   block.reserve(std::min<std::size_t>(config_.replay_block, header.booking_count));
+   for (auto const& record : std::span(booking_source, header.booking_count)) {
+      block.emplace_back(TimeBookingEvent { .personId   = record.personId,
+                                            .timepoint  = booking_time_ty { std::chrono::milliseconds { record.timepoint } },
+                                            .kind       = static_cast<Organization::EBookingKind>(record.kind),
+                                            .terminalId = record.terminalId });
+      if (block.size() == config_.replay_block) {
+         bookings(block);
+         block.clear();
+         }
+      }
+   if (!block.empty()) bookings(block);
+
+   if (with_absences) {
+      std::uint64_t next_absence_id = 1;
+      std::memcpy(&next_absence_id, absence_section, sizeof(std::uint64_t));
+      auto const count = (header.absence_bytes - sizeof(std::uint64_t)) / sizeof(SnapshotAbsence);
+      std::vector<AbsenceEntry> entries;
+      entries.reserve(count);
+      for (auto const& record : std::span(reinterpret_cast<SnapshotAbsence const*>(absence_section + sizeof(std::uint64_t)), count)) {
+         entries.emplace_back(AbsenceEntry { .absenceId = record.absenceId, .personId = record.personId,
+                                             .from = std::chrono::sys_days { std::chrono::days { record.from } },
+                                             .to = std::chrono::sys_days { std::chrono::days { record.to } },
+                                             .kind = static_cast<Organization::EAbsenceKind>(record.kind), .approved = record.approved != 0 });
+         }
+      stats.absences = count;
+      if (absences) absences(std::move(entries), next_absence_id);
+      }
+
+   stats.found            = true;
+   stats.journal_sequence = header.journal_sequence;
+   stats.bookings         = header.booking_count;
+   stats.file             = file;
+   return true;
+   }
+
+SnapshotManager::LoadStatistics SnapshotManager::load_latest(EmployeeStore& store, bookings_ty const& bookings, absences_ty const& absences) const {
+   auto const start = std::chrono::steady_clock::now();
+   LoadStatistics stats;
+   for (auto const& [sequence, file] : list_snapshots(config_.directory) | std::views::reverse) {
+      if (load_file(file, store, bookings, absences, stats)) break;
+      }
+   stats.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+   if (stats.found)
+      log_trace<2>("[SnapshotManager {}] snapshot {} with {} employees, {} bookings and {} absences loaded in {}.", ::getTimeStamp(),
+                   stats.file.filename().string(), stats.employees, stats.bookings, stats.absences, stats.duration);
+   else
+      log_trace<2>("[SnapshotManager {}] no snapshot found in {}.", ::getTimeStamp(), config_.directory.string());
+   return stats;
+   }
+
+void SnapshotManager::start(provider_ty provider, written_ty written) {
+   provider_ = std::move(provider);
+   written_  = std::move(written);
+   worker_   = std::thread(&SnapshotManager::run, this);
+   log_trace<4>("[SnapshotManager {}] snapshots every {} in {}.", ::getTimeStamp(), config_.interval, config_.directory.string());
+   }
+
+void SnapshotManager::stop() {
+      {
+      std::lock_guard lock(mutex_);
+      if (stop_) return;
+      stop_ = true;
+      }
+   wake_.notify_all();
+   if (worker_.joinable()) {
+      worker_.join();
+      if (config_.snapshot_on_stop) write_snapshot();
+      }
+   }
+
+void SnapshotManager::run() {
+   std::unique_lock lock(mutex_);
+   while (!wake_.wait_for(lock, config_.interval, [this] { return stop_; })) {
+      lock.unlock();
+      write_snapshot();
+      lock.lock();
+      }
+   }
+
+bool SnapshotManager::write_snapshot() {
+   try {
+      auto const covered = write(provider_());
+      if (written_) written_(covered);
+      return true;
+      }
+   catch (std::exception const& ex) {
+      log_error("[SnapshotManager {}] snapshot failed: {}", ::getTimeStamp(), ex.what());
+      return false;
+      }
+   }
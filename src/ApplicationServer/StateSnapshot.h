@@ -0,0 +1,214 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Binary snapshots of the employees and bookings for a fast restart of the AppServer.
+
+  \details This header declares the struct `StateSnapshot` and the class `SnapshotManager`. A
+           background thread of the manager copies the state of the server periodically and
+           writes it in a compact binary format: fixed size records for the employees and the
+           bookings, followed by a pool with the names. With the snapshot written and synced, the
+           segments of the booking journal which are contained in it are removed.
+
+  \details At the startup the newest valid snapshot is mapped into the memory and read in one
+           pass, only the bookings of the journal behind the snapshot are replayed.
+
+  \version 1.0
+  \date    11.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see BookingJournal.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "EmployeeStore.h"
+#include "BookingLog.h"
+#include "AbsenceCalendar.h"
+
+#include <vector>
+#include <span>
+#include <functional>
+#include <filesystem>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+/**
+  \brief State of the server, copied for a snapshot.
+  \details The journal sequence is read before the bookings are copied, at a moment when no booking is
+           between the journal and the booking log. A booking is written to the journal before it is
+           added to the booking log, so all bookings up to the sequence are contained. Later bookings
+           can be contained too, they are skipped as repetition when the journal is replayed behind
+           the snapshot.
+ */
+struct StateSnapshot {
+   std::uint64_t                 journal_sequence = 0; ///< all bookings of the journal up to this sequence are contained
+   EmployeeBatch                 employees;            ///< columns of the employee store
+   std::vector<TimeBookingEvent> bookings;             ///< all bookings of the booking log
+   std::vector<AbsenceEntry>     absences;             ///< all absences of the absence calendar
+   std::uint64_t                 next_absence_id = 1;  ///< lowest id for new absences, read after the absences
+   };
+
+/// \brief header at the begin of a snapshot file
+struct SnapshotHeader {
+   char          magic[8];          ///< "WTRSNAP1"
+   std::uint64_t journal_sequence;  ///< see StateSnapshot::journal_sequence
+   std::uint64_t created;           ///< milliseconds since the epoch
+   std::uint64_t employee_count;    ///< number of SnapshotEmployee records
+   std::uint64_t booking_count;     ///< number of SnapshotBooking records
+   std::uint64_t string_bytes;      ///< size of the pool with the names
+   std::uint32_t payload_checksum;  ///< CRC-32 of all bytes behind the header
+   std::uint32_t checksum;          ///< CRC-32 of the previous fields of the header
+   std::uint64_t absence_bytes;     ///< size of the absences behind the bookings, 0 in snapshots without absences (see SnapshotAbsence)
+   };
+static_assert(sizeof(SnapshotHeader) == 64, "the snapshot header has a fixed size of 64 bytes");
+
+/// \brief employee in a snapshot file, the names are stored in the pool behind the bookings
+struct SnapshotEmployee {
+   std::int32_t  personId;
+   std::int32_t  start_date;        ///< days since the epoch
+   std::uint32_t firstname_offset;
+   std::uint32_t firstname_length;
+   std::uint32_t name_offset;
+   std::uint32_t name_length;
+   double        salary;
+   std::uint8_t  gender;            ///< Organization::EGender
+   std::uint8_t  active;
+   std::uint8_t  reserved[6];
+   };
+static_assert(sizeof(SnapshotEmployee) == 40, "snapshot employees have a fixed size of 40 bytes");
+
+/// \brief booking in a snapshot file
+struct SnapshotBooking {
+   std::int64_t  timepoint;         ///< milliseconds since the epoch
+   std::int32_t  personId;
+   std::int32_t  terminalId;
+   std::uint16_t kind;              ///< Organization::EBookingKind
+   std::uint16_t reserved[3];
+   };
+static_assert(sizeof(SnapshotBooking) == 24, "snapshot bookings have a fixed size of 24 bytes");
+
+/// \brief absence in a snapshot file, the records follow the next absence id (8 bytes) behind the bookings
+struct SnapshotAbsence {
+   std::uint64_t absenceId;
+   std::int32_t  personId;
+   std::int32_t  from;              ///< days since the epoch
+   std::int32_t  to;                ///< days since the epoch
+   std::uint8_t  kind;              ///< Organization::EAbsenceKind
+   std::uint8_t  approved;
+   std::uint8_t  reserved[2];
+   };
+static_assert(sizeof(SnapshotAbsence) == 24, "snapshot absences have a fixed size of 24 bytes");
+
+/**
+  \brief Writes snapshots periodically in a background thread and loads the newest one at the startup.
+ */
+class SnapshotManager {
+public:
+   /// \brief copies the current state of the server
+   using provider_ty = std::function<StateSnapshot ()>;
+   /// \brief called after a snapshot is durable with the sequence contained in all kept snapshots, e.g. to compact the journal
+   using written_ty  = std::function<void (std::uint64_t covered_sequence)>;
+   /// \brief consumer of the bookings of a loaded snapshot, called with blocks of bookings
+   using bookings_ty = std::function<void (std::span<TimeBookingEvent const>)>;
+   /// \brief consumer of the absences of a loaded snapshot with the next absence id, called once
+   using absences_ty = std::function<void (std::vector<AbsenceEntry>, std::uint64_t next_absence_id)>;
+
+   /// \brief configuration of the snapshots
+   struct Config {
+      std::filesystem::path directory;                                    ///< directory of the snapshot files
+      std::chrono::seconds  interval          = std::chrono::minutes { 15 }; ///< time between two snapshots
+      std::size_t           keep              = 2;                        ///< number of snapshot files kept
+      bool                  snapshot_on_stop  = true;                     ///< writes a last snapshot when the manager stops
+      std::size_t           replay_block      = 64 * 1'024;               ///< bookings passed with one call of the consumer
+      };
+
+   /// \brief result of loading a snapshot
+   struct LoadStatistics {
+      bool                      found            = false; ///< a valid snapshot was loaded
+      std::uint64_t             journal_sequence = 0;     ///< sequence of the journal contained in the snapshot
+      std::size_t               employees        = 0;     ///< loaded employees
+      std::size_t               bookings         = 0;     ///< loaded bookings
+      std::size_t               absences         = 0;     ///< loaded absences
+      std::chrono::milliseconds duration         = {};    ///< duration of the load
+      std::filesystem::path     file;                     ///< loaded snapshot file
+      };
+
+private:
+   Config                  config_;
+   provider_ty             provider_;
+   written_ty              written_;
+   std::mutex              mutex_;
+   std::condition_variable wake_;
+   bool                    stop_ = false;
+   std::thread             worker_;
+
+public:
+   SnapshotManager() = delete;
+   SnapshotManager(SnapshotManager const&) = delete;
+   SnapshotManager& operator = (SnapshotManager const&) = delete;
+
+   explicit SnapshotManager(Config config);
+
+   /// \brief stops the background thread, see \ref stop
+   ~SnapshotManager();
+
+   /**
+     \brief Loads the newest valid snapshot of the directory.
+     \details A snapshot with a wrong checksum is skipped with an error message and the next older one is tried.
+     \param store receives the employees of the snapshot (should be empty)
+     \param bookings receives the bookings of the snapshot in blocks
+     \param absences receives the absences of the snapshot, without a consumer they are skipped
+     \return counters of the load, `found` is false when no valid snapshot exists
+    */
+   LoadStatistics load_latest(EmployeeStore& store, bookings_ty const& bookings, absences_ty const& absences = { }) const;
+
+   /**
+     \brief Writes a snapshot into a temporary file, syncs it and renames it to the final name.
+     \details Older snapshots beyond the configured number are removed.
+     \return journal sequence contained in all kept snapshots, the journal can be compacted up to it,
+             so that the older snapshot can still be used when the newest one is damaged
+     \throws std::runtime_error if the file can't be written or the directory can't be synced after the rename,
+             in both cases nothing is covered and the journal isn't compacted
+    */
+   std::uint64_t write(StateSnapshot const& snapshot) const;
+
+   /**
+     \brief Starts the background thread which writes a snapshot after each interval.
+     \param provider copies the state of the server, called in the background thread
+     \param written called after each durable snapshot with the sequence contained in all kept snapshots
+    */
+   void start(provider_ty provider, written_ty written);
+
+   /// \brief stops the background thread and writes the last snapshot, when configured
+   void stop();
+
+private:
+   void run();
+   bool write_snapshot();
+
+   /// \brief validates and loads one snapshot file, false if the file isn't valid
+   bool load_file(std::filesystem::path const& file, EmployeeStore& store, bookings_ty const& bookings, absences_ty const& absences,
+                  LoadStatistics& stats) const;
+   };
@@ -0,0 +1,260 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the export of the timesheets
+
+  \details The partitions are handed from the workers to the writer in a map ordered by the index of the
+           partition. A worker waits before it starts a partition which is more than `max_pending` ahead
+           of the writer, the writer waits for the next partition in the order. An error or a cancel sets
+           a flag which ends both loops, then the partial file is removed.
+
+  \version 1.0
+  \date    18.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "TimesheetExport.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <fstream>
+#include <format>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+   /// \brief appends an integer little endian to the buffer
+   template <std::integral ty>
+   void append(std::string& buffer, ty value) {
+      auto bits = static_cast<std::make_unsigned_t<ty>>(value);
+      for (std::size_t i = 0; i < sizeof(ty); ++i, bits >>= 8) buffer.push_back(static_cast<char>(bits & 0xFF));
+      }
+
+   std::int32_t seconds(std::chrono::milliseconds value) {
+      return static_cast<std::int32_t>(std::chrono::duration_cast<std::chrono::seconds>(value).count());
+      }
+
+   double hours(std::chrono::milliseconds value) {
+      return std::chrono::duration<double, std::ratio<3'600>>(value).count();
+      }
+
+   }
+
+TimesheetExport::~TimesheetExport() {
+   cancel();
+   wait();
+   }
+
+bool TimesheetExport::start(Config config, std::vector<CORBA::Long> personIds) {
+   if (config.to < config.from || (config.to - config.from).count() >= MaxDays)
+      throw std::invalid_argument(std::format("[TimesheetExport {}] range of the export from {} to {} isn't valid, at most {} days.",
+                                              ::getTimeStamp(), config.from, config.to, MaxDays));
+   std::lock_guard lock(mutex_);
+   if (running_) return false;
+   if (job_.joinable()) job_.join();   // the last run has finished
+
+   config.threads        = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+   config.partition_size = std::max<std::size_t>(config.partition_size, 1);
+   config.max_pending    = std::max<std::size_t>(config.max_pending, 1);
+
+   ready_.clear();
+   written_  = 0;
+   running_  = true;
+   failed_   = false;
+   finished_ = false;
+   error_.clear();
+   file_     = config.file;
+   started_  = std::chrono::steady_clock::now();
+   employees_.store(personIds.size());
+   done_.store(0);
+   bytes_.store(0);
+   log_trace<2>("[TimesheetExport {}] export of {} employees to {} started.", ::getTimeStamp(), personIds.size(), config.file.string());
+   job_ = std::jthread([this, config = std::move(config), ids = std::move(personIds)](std::stop_token token) mutable {
+                          run(token, std::move(config), std::move(ids));
+                          });
+   return true;
+   }
+
+void TimesheetExport::wait() {
+   std::unique_lock lock(mutex_);
+   changed_.wait(lock, [this]() { return !running_; });
+   }
+
+void TimesheetExport::cancel() {
+   job_.request_stop();
+   fail("export cancelled");
+   }
+
+void TimesheetExport::fail(std::string reason) {
+   {
+      std::lock_guard lock(mutex_);
+      if (!running_ || failed_) return;
+      failed_ = true;
+      error_  = std::move(reason);
+   }
+   changed_.notify_all();
+   }
+
+TimesheetExport::Progress TimesheetExport::progress() const {
+   std::lock_guard lock(mutex_);
+   return { .running = running_, .finished = finished_, .employees = employees_.load(), .done = done_.load(), .bytes = bytes_.load(),
+            .file = file_, .error = error_,
+            .elapsed = running_ ? std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_) : elapsed_ };
+   }
+
+std::string TimesheetExport::partition(Config const& config, std::span<CORBA::Long const> personIds) {
+   std::string buffer;
+   for (auto const personId : personIds) {
+      // only the bookings around the range are copied, with the look back and ahead of a shift over midnight
+      auto const events = bookings_.events(personId, engine_.begin_of(config.from) - engine_.config().max_shift,
+                                           engine_.begin_of(config.to + std::chrono::days { 1 }) + engine_.config().max_shift);
+      auto summary = engine_.compute(personId, events, config.from, config.to);
+      if (adjust_) adjust_(summary);
+
+      if (config.format == EFormat::Csv) {
+         for (auto const& day : summary.days)
+            std::format_to(std::back_inserter(buffer), "{};{:%Y-%m-%d};{:.2f};{:.2f};{:.2f};{:.2f};{}\n", personId, day.day,
+                           hours(day.worked), hours(day.breaks), hours(day.target), hours(day.overtime()), day.incomplete ? 1 : 0);
+         }
+      else {
+         append(buffer, static_cast<std::int32_t>(personId));
+         append(buffer, static_cast<std::uint16_t>(summary.days.size()));
+         for (auto const& day : summary.days) {
+            append(buffer, seconds(day.worked));
+            append(buffer, seconds(day.breaks));
+            append(buffer, seconds(day.target));
+            append(buffer, static_cast<std::uint8_t>(day.incomplete ? 1 : 0));
+            }
+         }
+      done_.fetch_add(1, std::memory_order_relaxed);
+      }
+   return buffer;
+   }
+
+void TimesheetExport::run(std::stop_token token, Config config, std::vector<CORBA::Long> personIds) {
+   auto const partial = std::filesystem::path { config.file }.concat(".part");
+   std::size_t const partitions = (personIds.size() + config.partition_size - 1) / config.partition_size;
+   std::atomic<std::size_t> next = 0;
+
+   auto stopped = [this]() { return failed_; };   // called with the mutex held
+
+   auto worker = [&]() {
+      for (std::size_t index; (index = next.fetch_add(1)) < partitions;) {
+         {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [&]() { return stopped() || index < written_ + config.max_pending; });
+            if (stopped()) return;
+         }
+         try {
+            auto const first = index * config.partition_size;
+            auto const count = std::min(config.partition_size, personIds.size() - first);
+            auto buffer = partition(config, std::span { personIds }.subspan(first, count));
+            {
+               std::lock_guard lock(mutex_);
+               ready_.emplace(index, std::move(buffer));
+            }
+            changed_.notify_all();
+            }
+         catch (std::exception const& ex) {
+            fail(std::format("partition {} not calculated: {}", index, ex.what()));
+            return;
+            }
+         }
+      };
+
+   {
+      std::vector<char> stream_buffer(std::max<std::size_t>(config.buffer_size, 4'096));
+      std::ofstream out;
+      out.rdbuf()->pubsetbuf(stream_buffer.data(), static_cast<std::streamsize>(stream_buffer.size()));
+      out.open(partial, std::ios::binary | std::ios::trunc);
+      if (!out) fail(std::format("file {} can't be created", partial.string()));
+
+      std::vector<std::jthread> workers;
+      if (out) {
+         std::string header;
+         if (config.format == EFormat::Csv) header = "personId;day;worked;breaks;target;overtime;incomplete\n";
+         else {
+            header = "WTX1";
+            append(header, static_cast<std::int32_t>(config.from.time_since_epoch().count()));
+            append(header, static_cast<std::int32_t>(config.to.time_since_epoch().count()));
+            append(header, static_cast<std::uint32_t>(personIds.size()));
+            }
+         out.write(header.data(), static_cast<std::streamsize>(header.size()));
+         bytes_.fetch_add(header.size(), std::memory_order_relaxed);
+         workers.reserve(config.threads);
+         for (std::size_t i = 0; i < std::min(config.threads, partitions); ++i) workers.emplace_back(worker);
+         }
+
+      // the thread of the job is the only writer, the partitions are written in their order
+      for (std::size_t index = 0; out && index < partitions; ++index) {
+         std::string buffer;
+         {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [&]() { return stopped() || ready_.contains(index); });
+            if (stopped()) break;
+            buffer = std::move(ready_.extract(index).mapped());
+         }
+         out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+         if (!out) fail(std::format("write to {} failed", partial.string()));
+         bytes_.fetch_add(buffer.size(), std::memory_order_relaxed);
+         {
+            std::lock_guard lock(mutex_);
+            ++written_;
+         }
+         changed_.notify_all();
+         if (token.stop_requested()) fail("export cancelled");
+         }
+
+      if (out) {
+         out.flush();
+         if (!out) fail(std::format("write to {} failed", partial.string()));
+         }
+      out.close();
+      for (auto& thread : workers) thread.join();
+   }
+
+   std::error_code ec;
+   bool failed = false;
+   {
+      std::lock_guard lock(mutex_);
+      failed = failed_;
+   }
+   if (!failed) {
+      std::filesystem::rename(partial, config.file, ec);
+      if (ec) fail(std::format("file {} can't be renamed: {}", partial.string(), ec.message()));
+      }
+
+   std::lock_guard lock(mutex_);
+   if (failed_) std::filesystem::remove(partial, ec);
+   finished_ = !failed_;
+   running_  = false;
+   elapsed_  = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_);
+   ready_.clear();
+   if (finished_)
+      log_trace<2>("[TimesheetExport {}] {} employees exported to {}, {} bytes in {}.", ::getTimeStamp(), done_.load(),
+                   config.file.string(), bytes_.load(), elapsed_);
+   else
+      log_error("[TimesheetExport {}] export to {} failed: {}", ::getTimeStamp(), config.file.string(), error_);
+   changed_.notify_all();
+   }
@@ -0,0 +1,166 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Export of the timesheets of all employees for the payroll, computed in parallel and streamed to a file.
+
+  \details This header declares the class `TimesheetExport`. The employees are split into partitions,
+           a pool of worker threads takes the partitions one after another, calculates the worked time
+           with the `WorkTimeEngine` and serializes the partition into an own buffer. The thread of the
+           job is the only writer: it writes the buffers in the order of the partitions through one
+           buffered stream. The workers run at most `max_pending` partitions ahead of the writer, so the
+           memory doesn't depend on the number of employees.
+
+  \details The file is written with the extension ".part" and renamed when it is complete, so the
+           payroll never reads a partial export. Two formats are supported:
+           - CSV, one line per employee and day: `personId;day;worked;breaks;target;overtime;incomplete`,
+             times in hours with two decimals, separated by semicolons.
+           - binary, little endian: the header "WTX1", the first and the last day (int32 days since
+             1970-01-01) and the number of employees (uint32), then for each employee the personId
+             (int32), the number of days (uint16) and per day worked, breaks and target in seconds
+             (3 × int32) and the flag incomplete (uint8).
+
+  \version 1.0
+  \date    18.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see WorkTimeEngine.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "WorkTimeEngine.h"
+
+#include <vector>
+#include <span>
+#include <string>
+#include <map>
+#include <functional>
+#include <filesystem>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+  \brief Background job which exports the timesheets of many employees into one file.
+ */
+class TimesheetExport {
+public:
+   /// \brief format of the export file
+   enum class EFormat : std::uint8_t { Csv, Binary };
+
+   /// \brief longest range of an export in days, a year with the leap day, the binary format counts the days with uint16
+   static constexpr std::int64_t MaxDays = 366;
+
+   /// \brief parameters of one run
+   struct Config {
+      std::filesystem::path file;                        ///< target file, written as file.part and renamed at the end
+      EFormat               format         = EFormat::Csv;
+      std::chrono::sys_days from;                        ///< first day of the timesheets
+      std::chrono::sys_days to;                          ///< last day of the timesheets
+      std::size_t           threads        = 0;          ///< worker threads, 0 = hardware concurrency
+      std::size_t           partition_size = 256;        ///< employees in one partition
+      std::size_t           max_pending    = 16;         ///< partitions the workers may run ahead of the writer
+      std::size_t           buffer_size    = 1 << 20;    ///< size of the buffer of the output stream
+      };
+
+   /// \brief state of the current or the last run
+   struct Progress {
+      bool                      running   = false;
+      bool                      finished  = false;  ///< the last run wrote the complete file
+      std::size_t               employees = 0;      ///< employees of the run
+      std::size_t               done      = 0;      ///< employees calculated
+      std::uint64_t             bytes     = 0;      ///< bytes written to the file
+      std::filesystem::path     file;
+      std::string               error;              ///< reason when the last run failed or was cancelled
+      std::chrono::milliseconds elapsed   = { };
+      };
+
+   /// \brief called for each calculated timesheet before it is written, e.g. to apply the absences
+   using adjust_ty = std::function<void (WorkTimeSummary&)>;
+
+private:
+   WorkTimeEngine const&      engine_;
+   BookingLog const&          bookings_;
+   adjust_ty                  adjust_;
+
+   mutable std::mutex         mutex_;            ///< guards the state of the run and the ready partitions
+   std::condition_variable    changed_;
+   std::map<std::size_t, std::string> ready_;    ///< serialized partitions waiting for the writer
+   std::size_t                written_ = 0;      ///< partitions written, the workers wait for it
+   bool                       running_ = false;
+   bool                       failed_  = false;
+   bool                       finished_ = false;
+   std::string                error_;
+   std::filesystem::path      file_;
+   std::chrono::steady_clock::time_point started_;
+   std::chrono::milliseconds  elapsed_ = { };
+
+   std::atomic<std::size_t>   employees_ = 0;
+   std::atomic<std::size_t>   done_      = 0;
+   std::atomic<std::uint64_t> bytes_     = 0;
+   std::jthread               job_;              ///< last member, stopped and joined first
+
+public:
+   TimesheetExport() = delete;
+   TimesheetExport(TimesheetExport const&) = delete;
+   TimesheetExport& operator = (TimesheetExport const&) = delete;
+
+   /**
+     \param engine calculation of the worked time, must outlive the export
+     \param bookings booking log with the bookings, must outlive the export
+     \param adjust optional change of each timesheet before it is written
+    */
+   TimesheetExport(WorkTimeEngine const& engine, BookingLog const& bookings, adjust_ty adjust = { })
+      : engine_(engine), bookings_(bookings), adjust_(std::move(adjust)) { }
+
+   /// \brief cancels a running export, the partial file is removed
+   ~TimesheetExport();
+
+   /**
+     \brief Starts an export in the background.
+     \param config file, format and range of the export
+     \param personIds employees of the export, in the order of the file
+     \return false when an export is already running
+     \throws std::invalid_argument if to is before from or the range is longer than MaxDays
+    */
+   bool start(Config config, std::vector<CORBA::Long> personIds);
+
+   /// \brief waits until the current run is finished
+   void wait();
+
+   /// \brief cancels the current run, the partial file is removed
+   void cancel();
+
+   Progress progress() const;
+
+private:
+   void run(std::stop_token token, Config config, std::vector<CORBA::Long> personIds);
+
+   /// \brief calculates and serializes the partition, called by the workers
+   std::string partition(Config const& config, std::span<CORBA::Long const> personIds);
+
+   /// \brief stops the run with an error, the workers and the writer leave their loops
+   void fail(std::string reason);
+   };
@@ -0,0 +1,236 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the incrementally maintained worked time per employee and day
+
+  \details A booking changes the interval in front of it and the interval behind it. An interval is at
+           most one shift long, so a booking on a day changes only the day itself, the previous and the
+           next day. These three days are recomputed with the bookings of the window around them.
+
+  \version 1.0
+  \date    14.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "WorkTimeAggregates.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <algorithm>
+
+WorkTimeAggregates::WorkTimeAggregates(BookingLog const& bookings, WorkTimeEngine const& engine, Config const& config)
+   : bookings_(bookings), engine_(engine), config_(config) {
+   config_.shards    = std::max<std::size_t>(config_.shards, 1);
+   config_.keep_days = std::max<std::size_t>(config_.keep_days, 62);
+   shards_.reserve(config_.shards);
+   for (std::size_t i = 0; i < config_.shards; ++i) shards_.emplace_back(std::make_unique<Shard>());
+   log_trace<4>("[WorkTimeAggregates {}] Worked time aggregates created with {} shards, {} days kept.", ::getTimeStamp(),
+                config_.shards, config_.keep_days);
+   }
+
+WorkTimeAggregates::EmployeeDays WorkTimeAggregates::build(CORBA::Long personId, std::chrono::sys_days day) const {
+   auto const events = bookings_.events(personId);
+   auto const latest_kept = latest_day();
+   auto first = day, last = day;
+   if (!events.empty()) {
+      auto [earliest, latest] = std::ranges::minmax_element(events, { }, &TimeBookingEvent::timepoint);
+      first = std::min(first, engine_.day_of(earliest->timepoint));
+      last  = std::max(last, engine_.day_of(latest->timepoint));
+      }
+   // bookings after the latest day don't extend the days, e.g. of a terminal with a wrong clock
+   last  = std::min(last, latest_kept);
+   first = std::min(first, last);
+
+   EmployeeDays employee;
+   if (static_cast<std::size_t>((last - first).count()) >= config_.keep_days) {
+      first = last - std::chrono::days { config_.keep_days - 1 };
+      employee.trimmed = true;
+      }
+   employee.first = first;
+   employee.days  = engine_.compute(personId, events, first, last).days;
+   update_sums(employee, 0);
+   return employee;
+   }
+
+void WorkTimeAggregates::extend(EmployeeDays& employee, std::chrono::sys_days day) const {
+   day = std::min(day, latest_day());
+   for (auto next = employee.first + std::chrono::days { static_cast<std::int64_t>(employee.days.size()) }; next <= day; next += std::chrono::days { 1 }) {
+      employee.days.emplace_back(WorkDay { .day = next, .target = engine_.target(next) });
+      employee.worked_sum.emplace_back(employee.worked_sum.back());
+      employee.breaks_sum.emplace_back(employee.breaks_sum.back());
+      employee.incomplete_sum.emplace_back(employee.incomplete_sum.back());
+      }
+   if (employee.days.size() > config_.keep_days) {
+      auto const drop = employee.days.size() - config_.keep_days;
+      employee.days.erase(employee.days.begin(), employee.days.begin() + drop);
+      employee.first += std::chrono::days { static_cast<std::int64_t>(drop) };
+      employee.trimmed = true;
+      update_sums(employee, 0);
+      }
+   }
+
+void WorkTimeAggregates::update_sums(EmployeeDays& employee, std::size_t from) {
+   auto const size = employee.days.size();
+   employee.worked_sum.resize(size + 1);
+   employee.breaks_sum.resize(size + 1);
+   employee.incomplete_sum.resize(size + 1);
+   for (std::size_t i = from; i < size; ++i) {
+      auto const& day = employee.days[i];
+      employee.worked_sum[i + 1]     = employee.worked_sum[i] + day.worked.count();
+      employee.breaks_sum[i + 1]     = employee.breaks_sum[i] + day.breaks.count();
+      employee.incomplete_sum[i + 1] = employee.incomplete_sum[i] + (day.incomplete ? 1 : 0);
+      }
+   }
+
+void WorkTimeAggregates::apply(EmployeeDays& employee, std::vector<WorkDay> const& days) {
+   auto changed = employee.days.size();
+   for (auto const& day : days) {
+      auto const index = static_cast<std::size_t>((day.day - employee.first).count());
+      if (day.day < employee.first || index >= employee.days.size()) continue;
+      employee.days[index] = day;
+      changed = std::min(changed, index);
+      }
+   update_sums(employee, changed);
+   }
+
+WorkTimeAggregates::EmployeeDays& WorkTimeAggregates::employee_locked(Shard& shard, CORBA::Long personId, std::chrono::sys_days day) {
+   auto it = shard.employees.find(personId);
+   if (it == shard.employees.end()) [[unlikely]] {
+      it = shard.employees.emplace(personId, build(personId, day)).first;
+      ++builds_;
+      }
+   extend(it->second, day);
+   return it->second;
+   }
+
+void WorkTimeAggregates::refresh(CORBA::Long personId, booking_time_ty timepoint) {
+   auto const day = engine_.day_of(timepoint);
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   auto it = current.employees.find(personId);
+   if (it == current.employees.end()) return;
+
+   auto& employee = it->second;
+   if (day < employee.first) {
+      // a booking in front of the kept days, the employee is built again with the next request
+      current.employees.erase(it);
+      return;
+      }
+
+   auto const latest = latest_day();
+   if (day > latest) [[unlikely]] {
+      log_trace<4>("[WorkTimeAggregates {}] booking of employee {} after the latest day {} isn't aggregated.", ::getTimeStamp(),
+                   personId, latest);
+      return;
+      }
+
+   extend(employee, day + std::chrono::days { 1 });
+   auto const from = std::max(day - std::chrono::days { 1 }, employee.first);
+   auto const to   = std::min(day + std::chrono::days { 1 }, latest);
+   auto const events = bookings_.events(personId, engine_.begin_of(from) - engine_.config().max_shift,
+                                        engine_.begin_of(to + std::chrono::days { 1 }));
+   auto const summary = engine_.compute(personId, events, from, to);
+   apply(employee, summary.days);
+   refreshes_ += summary.days.size();
+   }
+
+void WorkTimeAggregates::invalidate(CORBA::Long personId) {
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   current.employees.erase(personId);
+   }
+
+WorkPeriod WorkTimeAggregates::period_locked(CORBA::Long personId, EmployeeDays const& employee,
+                                             std::chrono::sys_days from, std::chrono::sys_days to) {
+   WorkPeriod result { .begin = from, .target = engine_.target(from, to) };
+   if (to < from) return result;
+
+   if (from < employee.first && employee.trimmed) [[unlikely]] {
+      // days before the kept days are calculated from the bookings
+      auto const last = std::min(to, employee.first - std::chrono::days { 1 });
+      auto const events = bookings_.events(personId, engine_.begin_of(from) - engine_.config().max_shift,
+                                           engine_.begin_of(last + std::chrono::days { 1 }));
+      for (auto const& day : engine_.compute(personId, events, from, last).days) {
+         result.worked += day.worked;
+         result.breaks += day.breaks;
+         result.incomplete_days += day.incomplete ? 1 : 0;
+         }
+      ++fallbacks_;
+      }
+
+   auto const size  = static_cast<std::int64_t>(employee.days.size());
+   auto const first = static_cast<std::size_t>(std::clamp<std::int64_t>((from - employee.first).count(), 0, size));
+   auto const last  = static_cast<std::size_t>(std::clamp<std::int64_t>((to - employee.first).count() + 1, 0, size));
+   if (first < last) {
+      result.worked += std::chrono::milliseconds { employee.worked_sum[last] - employee.worked_sum[first] };
+      result.breaks += std::chrono::milliseconds { employee.breaks_sum[last] - employee.breaks_sum[first] };
+      result.incomplete_days += employee.incomplete_sum[last] - employee.incomplete_sum[first];
+      }
+   return result;
+   }
+
+WorkDay WorkTimeAggregates::day_locked(CORBA::Long personId, EmployeeDays const& employee, std::chrono::sys_days day) {
+   if (day >= employee.first && static_cast<std::size_t>((day - employee.first).count()) < employee.days.size()) [[likely]]
+      return employee.days[static_cast<std::size_t>((day - employee.first).count())];
+   auto const period = period_locked(personId, employee, day, day);
+   return WorkDay { .day = day, .worked = period.worked, .breaks = period.breaks, .target = period.target,
+                    .incomplete = period.incomplete_days > 0 };
+   }
+
+WorkDay WorkTimeAggregates::day(CORBA::Long personId, std::chrono::sys_days day) {
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   auto const& employee = employee_locked(current, personId, day);
+   ++queries_;
+   return day_locked(personId, employee, day);
+   }
+
+WorkPeriod WorkTimeAggregates::period(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to) {
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   auto const& employee = employee_locked(current, personId, to);
+   ++queries_;
+   return period_locked(personId, employee, from, to);
+   }
+
+WorkTimeAggregates::Totals WorkTimeAggregates::totals(CORBA::Long personId, std::chrono::sys_days day) {
+   auto const week_begin  = day - (std::chrono::weekday { day } - std::chrono::Monday);
+   auto const ymd         = std::chrono::year_month_day { day };
+   auto const month_begin = std::chrono::sys_days { ymd.year() / ymd.month() / std::chrono::day { 1 } };
+
+   Shard& current = shard(personId);
+   std::lock_guard lock(current.mutex);
+   auto const& employee = employee_locked(current, personId, day);
+   ++queries_;
+   return { .day   = day_locked(personId, employee, day),
+            .week  = period_locked(personId, employee, week_begin, day),
+            .month = period_locked(personId, employee, month_begin, day) };
+   }
+
+std::chrono::sys_days WorkTimeAggregates::latest_day() const {
+   return engine_.day_of(BookingLog::now_ms()) + std::chrono::days { 1 };
+   }
+
+WorkTimeAggregates::Statistics WorkTimeAggregates::statistics() const {
+   return { .builds = builds_, .refreshes = refreshes_, .queries = queries_, .fallbacks = fallbacks_ };
+   }
@@ -0,0 +1,167 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Incrementally maintained worked time per employee and day, with prefix sums for weeks and months.
+
+  \details This header declares the class `WorkTimeAggregates`. For each employee the worked time of
+           each day is kept in a vector together with prefix sums over the days. A new or corrected
+           booking recomputes only its day and the neighbouring days (a shift over midnight) with the
+           `WorkTimeEngine` and updates the prefix sums behind them, usually only the last entries.
+           The totals of a day, a week or a month are then read with two lookups in the prefix sums,
+           independent of the number of bookings.
+
+  \details The days of an employee are built from the booking log with the first request, so the
+           aggregates need no own persistence and are rebuilt lazily after a restart. The employees
+           are distributed over shards with an own mutex, like in the `BookingLog`.
+
+  \version 1.0
+  \date    14.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see WorkTimeEngine.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "WorkTimeEngine.h"
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+  \brief Worked time per employee and day, updated with each booking.
+ */
+class WorkTimeAggregates {
+public:
+   /// \brief configuration of the aggregates
+   struct Config {
+      std::size_t shards    = 64;   ///< number of shards, each with an own mutex
+      std::size_t keep_days = 400;  ///< days kept per employee, older days are calculated on request
+      };
+
+   /// \brief totals for the terminal display
+   struct Totals {
+      WorkDay    day;    ///< the requested day
+      WorkPeriod week;   ///< week of the day from monday up to the day
+      WorkPeriod month;  ///< month of the day from the first up to the day
+      };
+
+   /// \brief counters of the aggregates
+   struct Statistics {
+      std::uint64_t builds    = 0;  ///< employees built from the booking log
+      std::uint64_t refreshes = 0;  ///< days recomputed after a booking
+      std::uint64_t queries   = 0;  ///< answered requests
+      std::uint64_t fallbacks = 0;  ///< requests for days before the kept days, calculated with the engine
+      };
+
+private:
+   /// \brief days of one employee, the prefix sums have one entry more than the days
+   struct EmployeeDays {
+      std::chrono::sys_days      first;                 ///< day of days[0]
+      std::vector<WorkDay>       days;
+      std::vector<std::int64_t>  worked_sum { 0 };      ///< worked_sum[i] = worked milliseconds of days[0 .. i)
+      std::vector<std::int64_t>  breaks_sum { 0 };
+      std::vector<std::uint32_t> incomplete_sum { 0 };
+      bool                       trimmed = false;       ///< older days were dropped, days before first can have bookings
+      };
+
+   struct alignas(64) Shard {
+      std::mutex                                    mutex;
+      std::unordered_map<CORBA::Long, EmployeeDays> employees;
+      };
+
+   BookingLog const&                   bookings_;
+   WorkTimeEngine const&               engine_;
+   Config                              config_;
+   std::vector<std::unique_ptr<Shard>> shards_;
+
+   std::atomic<std::uint64_t>          builds_    = 0;
+   std::atomic<std::uint64_t>          refreshes_ = 0;
+   std::atomic<std::uint64_t>          queries_   = 0;
+   std::atomic<std::uint64_t>          fallbacks_ = 0;
+
+public:
+   WorkTimeAggregates() = delete;
+   WorkTimeAggregates(WorkTimeAggregates const&) = delete;
+   WorkTimeAggregates& operator = (WorkTimeAggregates const&) = delete;
+
+   /**
+     \param bookings booking log with the bookings, must outlive the aggregates
+     \param engine rules of the calculation, must outlive the aggregates
+    */
+   WorkTimeAggregates(BookingLog const& bookings, WorkTimeEngine const& engine) : WorkTimeAggregates(bookings, engine, Config { }) {}
+   WorkTimeAggregates(BookingLog const& bookings, WorkTimeEngine const& engine, Config const& config);
+
+   /**
+     \brief Updates the days around a new or corrected booking.
+     \details Called after the booking is in the booking log. Employees without aggregates are skipped,
+              they are built with the next request. A booking after \ref latest_day (e.g. of a terminal with
+              a wrong clock in a restored journal) doesn't extend the kept days.
+     \param personId id of the employee
+     \param timepoint time point of the booking
+    */
+   void refresh(CORBA::Long personId, booking_time_ty timepoint);
+
+   /// \brief removes the aggregates of an employee, they are rebuilt with the next request
+   void invalidate(CORBA::Long personId);
+
+   /// \brief worked time of an employee on a day, days after \ref latest_day have no worked time
+   WorkDay day(CORBA::Long personId, std::chrono::sys_days day);
+
+   /// \brief worked time of an employee in the closed range [from, to], read from the prefix sums
+   WorkPeriod period(CORBA::Long personId, std::chrono::sys_days from, std::chrono::sys_days to);
+
+   /// \brief totals of the day, the week and the month up to the day
+   Totals totals(CORBA::Long personId, std::chrono::sys_days day);
+
+   Statistics statistics() const;
+
+   /// \brief last day which is kept for the employees (tomorrow in the time zone of the engine)
+   std::chrono::sys_days latest_day() const;
+
+private:
+   Shard& shard(CORBA::Long personId) const {
+      return *shards_[static_cast<std::uint32_t>(personId) % shards_.size()];
+      }
+
+   /// \brief aggregates of an employee which contain the day, built or extended when necessary
+   EmployeeDays& employee_locked(Shard& shard, CORBA::Long personId, std::chrono::sys_days day);
+
+   EmployeeDays build(CORBA::Long personId, std::chrono::sys_days day) const;
+
+   /// \brief extends the days up to the day (at most the latest day), drops the oldest days beyond keep_days
+   void extend(EmployeeDays& employee, std::chrono::sys_days day) const;
+
+   /// \brief writes the calculated days and updates the prefix sums behind the first changed day
+   static void apply(EmployeeDays& employee, std::vector<WorkDay> const& days);
+
+   /// \brief recomputes the prefix sums from the position to the end
+   static void update_sums(EmployeeDays& employee, std::size_t from);
+
+   WorkPeriod period_locked(CORBA::Long personId, EmployeeDays const& employee, std::chrono::sys_days from, std::chrono::sys_days to);
+   WorkDay day_locked(CORBA::Long personId, EmployeeDays const& employee, std::chrono::sys_days day);
+   };
@@ -0,0 +1,233 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the calculation of the worked time
+
+  \details The totals are collected in buckets with one bucket in front of and one behind the range,
+           the index of a time point is clamped into them. So the intervals before the range (from
+           the look back for night shifts) need no extra condition and are simply dropped at the end.
+
+  \version 1.0
+  \date    13.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "WorkTimeEngine.h"
+
+#include <algorithm>
+#include <numeric>
+#include <execution>
+#include <array>
+#include <bit>
+
+namespace {
+
+   /// \brief state of an employee between two bookings
+   enum EState : std::uint8_t { Out = 0, Work = 1, Break = 2 };
+
+   /// \brief next state for [state][kind], kinds in the order of Organization::EBookingKind
+   constexpr std::array<std::array<std::uint8_t, 4>, 3> Transition {{
+      //  COME   GO    BREAK_BEGIN  BREAK_END
+      {{ Work,  Out,  Out,         Out   }},  // Out
+      {{ Work,  Out,  Break,       Work  }},  // Work
+      {{ Break, Out,  Break,       Work  }},  // Break
+      }};
+
+   /// \brief 1 when the booking [kind] doesn't fit the state, e.g. GO without COME
+   constexpr std::array<std::array<std::uint8_t, 4>, 3> Unexpected {{
+      //  COME GO  BREAK_BEGIN  BREAK_END
+      {{ 0,   1,  1,           1 }},  // Out
+      {{ 1,   0,  0,           1 }},  // Work
+      {{ 1,   0,  1,           0 }},  // Break
+      }};
+
+   /// \brief columns of the bookings in a window with the time and the state after each booking
+   struct BookingColumns {
+      std::vector<std::int64_t> times;       ///< UTC time in milliseconds
+      std::vector<std::uint8_t> states;      ///< EState after the booking
+      std::vector<std::uint8_t> unexpected;  ///< 1 when the booking doesn't fit the state before it
+      };
+
+   BookingColumns to_columns(std::span<TimeBookingEvent const> events, booking_time_ty window_begin, booking_time_ty window_end) {
+      // the log keeps the order of arrival, buffered bookings of a terminal can be older
+      std::vector<TimeBookingEvent> sorted;
+      if (!std::ranges::is_sorted(events, { }, &TimeBookingEvent::timepoint)) {
+         sorted.assign(events.begin(), events.end());
+         std::ranges::stable_sort(sorted, { }, &TimeBookingEvent::timepoint);
+         events = sorted;
+         }
+
+      auto const begin = std::ranges::lower_bound(events, window_begin, { }, &TimeBookingEvent::timepoint);
+      auto const end   = std::ranges::lower_bound(begin, events.end(), window_end, { }, &TimeBookingEvent::timepoint);
+      std::size_t const count = static_cast<std::size_t>(end - begin);
+
+      BookingColumns columns { .times = std::vector<std::int64_t>(count), .states = std::vector<std::uint8_t>(count),
+                               .unexpected = std::vector<std::uint8_t>(count) };
+      std::vector<std::uint8_t> kinds(count);
+      std::ranges::transform(begin, end, columns.times.begin(), [](TimeBookingEvent const& event) {
+                                                                   return event.timepoint.time_since_epoch().count(); });
+      std::ranges::transform(begin, end, kinds.begin(), [](TimeBookingEvent const& event) {
+                                                           return static_cast<std::uint8_t>(event.kind); });
+
+      std::uint8_t state = Out;
+      for (std::size_t i = 0; i < count; ++i) {
+         columns.unexpected[i] = Unexpected[state][kinds[i]];
+         state = columns.states[i] = Transition[state][kinds[i]];
+         }
+      return columns;
+      }
+
+   }
+
+std::chrono::milliseconds WorkTimeEngine::target(std::chrono::sys_days day) const {
+   auto const weekday = std::chrono::weekday { day }.c_encoding();
+   return (config_.workdays >> weekday) & 1 ? config_.daily_target : std::chrono::milliseconds { 0 };
+   }
+
+std::chrono::milliseconds WorkTimeEngine::target(std::chrono::sys_days from, std::chrono::sys_days to) const {
+   if (to < from) return std::chrono::milliseconds { 0 };
+   auto const count = (to - from).count() + 1;
+   auto result = config_.daily_target * ((count / 7) * std::popcount(static_cast<std::uint8_t>(config_.workdays & 0x7f)));
+   for (auto day = from + std::chrono::days { count - count % 7 }; day <= to; day += std::chrono::days { 1 }) result += target(day);
+   return result;
+   }
+
+WorkTimeSummary WorkTimeEngine::compute(CORBA::Long personId, std::span<TimeBookingEvent const> events,
+                                        std::chrono::sys_days from, std::chrono::sys_days to) const {
+   WorkTimeSummary summary { .personId = personId, .days = { } };
+   if (to < from) return summary;
+
+   std::int64_t const day_count = (to - from).count() + 1;
+   auto const columns = to_columns(events, begin_of(from) - config_.max_shift, begin_of(to + std::chrono::days { 1 }));
+   auto const& times      = columns.times;
+   auto const& states     = columns.states;
+   auto const& unexpected = columns.unexpected;
+   std::size_t const count = times.size();
+   std::uint8_t const state = count > 0 ? states.back() : std::uint8_t { Out };
+
+   // begin of the local days of the range and of the day behind, with the change of the daylight saving time
+   // a local day has 23 or 25 hours, so the days are found in this table and not with a division
+   std::vector<std::int64_t> bounds(day_count + 1);
+   for (std::int64_t i = 0; i <= day_count; ++i) bounds[i] = begin_of(from + std::chrono::days { i }).time_since_epoch().count();
+
+   // buckets: 0 = before the range, 1 .. day_count = days of the range, day_count + 1 = behind
+   std::vector<std::int64_t> worked(day_count + 2), breaks(day_count + 2);
+   std::vector<std::uint8_t> incomplete(day_count + 2);
+   auto bucket = [&bounds](std::int64_t time) {
+      return static_cast<std::size_t>(std::ranges::upper_bound(bounds, time) - bounds.begin());
+      };
+
+   std::int64_t const max_shift = std::chrono::milliseconds { config_.max_shift }.count();
+   if (count > 0) incomplete[bucket(times[0])] |= unexpected[0];
+   for (std::size_t i = 1; i < count; ++i) {
+      std::int64_t const start = times[i - 1], stop = times[i];
+      std::uint8_t const current = states[i - 1];
+      // an interval longer than a shift misses a booking, it isn't counted
+      std::int64_t const valid = (stop - start) <= max_shift;
+      std::int64_t const in_work  = valid & (current == Work);
+      std::int64_t const in_break = valid & (current == Break);
+      incomplete[bucket(stop)] |= unexpected[i] | static_cast<std::uint8_t>(!valid & (current != Out));
+
+      auto const first = bucket(start), last = bucket(stop);
+      if (first == last) [[likely]] {
+         worked[first] += (stop - start) * in_work;
+         breaks[first] += (stop - start) * in_break;
+         }
+      else {
+         // interval over midnight, split at the begin of each day
+         for (std::int64_t part = start; part < stop; ) {
+            auto const current_bucket = bucket(part);
+            std::int64_t const next = current_bucket < bounds.size() ? std::min(stop, bounds[current_bucket]) : stop;
+            worked[current_bucket] += (next - part) * in_work;
+            breaks[current_bucket] += (next - part) * in_break;
+            part = next;
+            }
+         }
+      }
+   // an open interval at the end isn't counted yet
+   if (count > 0 && state != Out) incomplete[bucket(times[count - 1])] = 1;
+
+   summary.days.reserve(day_count);
+   for (std::int64_t i = 0; i < day_count; ++i) {
+      auto const day = from + std::chrono::days { i };
+      summary.days.emplace_back(WorkDay { .day = day, .worked = std::chrono::milliseconds { worked[i + 1] },
+                                          .breaks = std::chrono::milliseconds { breaks[i + 1] }, .target = target(day),
+                                          .incomplete = incomplete[i + 1] != 0 });
+      }
+   return summary;
+   }
+
+WorkIntervals WorkTimeEngine::intervals(std::span<TimeBookingEvent const> events, std::chrono::sys_days from, std::chrono::sys_days to) const {
+   WorkIntervals result;
+   if (to < from) return result;
+   auto const columns = to_columns(events, begin_of(from) - config_.max_shift, begin_of(to + std::chrono::days { 1 }));
+   std::int64_t const max_shift = std::chrono::milliseconds { config_.max_shift }.count();
+   for (std::size_t i = 1; i < columns.times.size(); ++i) {
+      std::uint8_t const current = columns.states[i - 1];
+      if (current == Out || columns.times[i] - columns.times[i - 1] > max_shift) continue;
+      result.begin.emplace_back(columns.times[i - 1]);
+      result.end.emplace_back(columns.times[i]);
+      result.in_break.emplace_back(current == Break ? 1 : 0);
+      }
+   return result;
+   }
+
+std::vector<WorkTimeSummary> WorkTimeEngine::compute_all(BookingLog const& bookings, std::span<CORBA::Long const> personIds,
+                                                         std::chrono::sys_days from, std::chrono::sys_days to) const {
+   std::vector<WorkTimeSummary> results(personIds.size());
+   std::vector<std::size_t> indices(personIds.size());
+   std::iota(indices.begin(), indices.end(), std::size_t { 0 });
+   std::for_each(std::execution::par, indices.begin(), indices.end(), [&](std::size_t i) {
+                    auto const events = bookings.events(personIds[i]);
+                    results[i] = compute(personIds[i], events, from, to);
+                    });
+   return results;
+   }
+
+namespace {
+
+   /// \brief sums the days into periods, a new period starts where the key of the day changes
+   template <typename key_ty>
+   std::vector<WorkPeriod> periods(std::vector<WorkDay> const& days, key_ty key) {
+      std::vector<WorkPeriod> result;
+      for (auto const& day : days) {
+         if (result.empty() || key(result.back().begin) != key(day.day)) result.emplace_back(WorkPeriod { .begin = day.day });
+         result.back().add(day);
+         }
+      return result;
+      }
+
+   }
+
+std::vector<WorkPeriod> WorkTimeSummary::weeks() const {
+   return periods(days, [](std::chrono::sys_days day) { return day - (std::chrono::weekday { day } - std::chrono::Monday); });
+   }
+
+std::vector<WorkPeriod> WorkTimeSummary::months() const {
+   return periods(days, [](std::chrono::sys_days day) { return std::chrono::year_month_day { day }.year() / std::chrono::year_month_day { day }.month(); });
+   }
+
+WorkPeriod WorkTimeSummary::total() const {
+   WorkPeriod result { .begin = days.empty() ? std::chrono::sys_days { } : days.front().day };
+   for (auto const& day : days) result.add(day);
+   return result;
+   }
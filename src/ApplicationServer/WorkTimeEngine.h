@@ -0,0 +1,179 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Calculation of the worked hours, breaks and overtime from the time bookings.
+
+  \details This header declares the class `WorkTimeEngine`. The bookings of an employee are ordered by
+           the time point and copied into two columns (time and kind). A table driven state machine
+           (out, work, break) determines the state between two bookings without branches, then one
+           pass over the columns adds the length of each interval to the totals of its day. Only an
+           interval over midnight is split, the rare case.
+
+  \details The days are local days with a fixed offset to UTC. The target time of a day is the daily
+           target on the configured workdays. The calculation for all employees of the company runs
+           in parallel with `std::execution::par`, one employee per task.
+
+  \version 1.0
+  \date    13.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see BookingLog.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "BookingLog.h"
+
+#include <string>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <cstdint>
+
+using namespace std::string_literals;
+
+/// \brief worked time of an employee on one day
+struct WorkDay {
+   std::chrono::sys_days     day;              ///< local day
+   std::chrono::milliseconds worked     = {};  ///< time between COME and GO without the breaks
+   std::chrono::milliseconds breaks     = {};  ///< time between BREAK_BEGIN and BREAK_END
+   std::chrono::milliseconds target     = {};  ///< target time of the day
+   bool                      incomplete = false; ///< a booking is missing or doesn't fit the state of the employee
+
+   std::chrono::milliseconds overtime() const { return worked - target; }
+   };
+
+/// \brief sum of the worked time of several days (week, month or the whole range)
+struct WorkPeriod {
+   std::chrono::sys_days     begin;                ///< first day of the period
+   std::chrono::milliseconds worked          = {};
+   std::chrono::milliseconds breaks          = {};
+   std::chrono::milliseconds target          = {};
+   std::size_t               incomplete_days = 0;
+
+   std::chrono::milliseconds overtime() const { return worked - target; }
+
+   void add(WorkDay const& day) {
+      worked += day.worked;
+      breaks += day.breaks;
+      target += day.target;
+      incomplete_days += day.incomplete ? 1 : 0;
+      }
+   };
+
+/// \brief worked time of an employee in a range of days
+struct WorkTimeSummary {
+   CORBA::Long          personId = 0;
+   std::vector<WorkDay> days;      ///< every day of the range in ascending order
+
+   /// \brief sums of the weeks (from monday), the first and the last week can be partial
+   std::vector<WorkPeriod> weeks() const;
+
+   /// \brief sums of the calendar months, the first and the last month can be partial
+   std::vector<WorkPeriod> months() const;
+
+   /// \brief sum of the whole range
+   WorkPeriod total() const;
+   };
+
+/// \brief closed intervals of work and breaks as UTC time points (milliseconds), columns of the same length
+struct WorkIntervals {
+   std::vector<std::int64_t> begin;
+   std::vector<std::int64_t> end;
+   std::vector<std::uint8_t> in_break;  ///< 1 for a break, 0 for work
+
+   std::size_t size() const { return begin.size(); }
+   };
+
+/**
+  \brief Calculates the worked time from the bookings of the booking log.
+ */
+class WorkTimeEngine {
+public:
+   /// \brief rules of the calculation
+   struct Config {
+      std::chrono::milliseconds daily_target = std::chrono::hours { 8 };    ///< target time of a workday
+      std::uint8_t              workdays     = 0b0011'1110;                 ///< bit per weekday, bit 0 = sunday (monday to friday)
+      std::string               time_zone    = "Europe/Berlin"s;            ///< IANA time zone of the local days, with daylight saving time
+      std::chrono::hours        max_shift    = std::chrono::hours { 24 };   ///< longer intervals are a missing booking and not counted
+      std::size_t               max_days     = 366;                         ///< maximal length of a range
+      };
+
+private:
+   Config                         config_;
+   std::chrono::time_zone const*  zone_;     ///< time zone of the configuration, entry of the tz database
+
+public:
+   WorkTimeEngine() : WorkTimeEngine(Config { }) { }
+
+   /// \throws std::runtime_error if the time zone of the configuration isn't in the tz database
+   explicit WorkTimeEngine(Config const& config) : config_(config), zone_(std::chrono::locate_zone(config_.time_zone)) { }
+
+   Config const& config() const { return config_; }
+
+   /**
+     \brief Calculates the worked time of an employee in the closed range [from, to].
+     \details Bookings up to `max_shift` before the range are included, so a shift over midnight into the
+              first day is counted. An interval at the end which isn't closed yet isn't counted, the day is
+              marked as incomplete.
+     \param personId id of the employee, copied into the result
+     \param events bookings of the employee in any order
+     \param from first local day of the range
+     \param to last local day of the range
+     \return worked time for each day of the range, empty if to is before from
+    */
+   WorkTimeSummary compute(CORBA::Long personId, std::span<TimeBookingEvent const> events,
+                           std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /**
+     \brief Intervals of work and breaks of an employee, e.g. for the check of the rules of the working time.
+     \details Contains the intervals which end in the range, with the same look back as \ref compute.
+              Intervals longer than `max_shift` are left out.
+    */
+   WorkIntervals intervals(std::span<TimeBookingEvent const> events, std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /**
+     \brief Calculates the worked time of many employees in parallel, e.g. for the month-end run.
+     \param bookings booking log with the bookings of the employees
+     \param personIds ids of the employees
+     \return worked time of the employees in the order of personIds
+    */
+   std::vector<WorkTimeSummary> compute_all(BookingLog const& bookings, std::span<CORBA::Long const> personIds,
+                                            std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /// \brief target time of a local day
+   std::chrono::milliseconds target(std::chrono::sys_days day) const;
+
+   /// \brief target time of the closed range [from, to], calculated from the number of full weeks
+   std::chrono::milliseconds target(std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /// \brief local day of a time point in the time zone of the configuration
+   std::chrono::sys_days day_of(booking_time_ty timepoint) const {
+      return std::chrono::sys_days { std::chrono::floor<std::chrono::days>(zone_->to_local(timepoint)).time_since_epoch() };
+      }
+
+   /// \brief first time point of a local day, with the change of the daylight saving time a day has 23 or 25 hours
+   booking_time_ty begin_of(std::chrono::sys_days day) const {
+      return std::chrono::time_point_cast<booking_time_ty::duration>(
+                   zone_->to_sys(std::chrono::local_days { day.time_since_epoch() }, std::chrono::choose::earliest));
+      }
+   };
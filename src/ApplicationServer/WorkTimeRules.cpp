@@ -0,0 +1,157 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the table driven check of the working time rules
+
+  \details The measures belong to working days and not to calendar days. A working day begins with the
+           first work after a gap of at least the minimal rest of the rules, or 24 hours after the begin
+           of the working day before, like the working day of the Arbeitszeitgesetz, which starts with the
+           begin of the work. So a night shift over midnight is one working day of the local day on which
+           it begins. The breaks are the gaps between the intervals of work of the same working day, booked
+           with BREAK_BEGIN / BREAK_END or with GO / COME, so both ways count the same.
+
+  \version 1.0
+  \date    15.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "WorkTimeRules.h"
+
+#include "Tools.h"
+#include "my_logging.h"
+
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <execution>
+#include <limits>
+
+namespace {
+
+   constexpr std::int64_t DayMs = std::chrono::milliseconds { std::chrono::days { 1 } }.count();
+
+   /// \brief rest of a working day without earlier work in the window, large but without overflow in the comparisons
+   constexpr std::int64_t NoRest = std::numeric_limits<std::int64_t>::max() / 4;
+
+   std::int64_t ms(std::chrono::milliseconds value) { return value.count(); }
+
+   }
+
+std::vector<WorkTimeRule> WorkTimeRules::german_rules() {
+   using namespace std::chrono_literals;
+   return {
+      { Organization::RULE_MAX_DAILY_WORK, EWorkTimeMeasure::Worked, 0ms, EWorkTimeMeasure::Worked, EWorkTimeLimit::AtMost,  10h  },
+      { Organization::RULE_MIN_BREAK_6H,   EWorkTimeMeasure::Worked, 6h,  EWorkTimeMeasure::Breaks, EWorkTimeLimit::AtLeast, 30min },
+      { Organization::RULE_MIN_BREAK_9H,   EWorkTimeMeasure::Worked, 9h,  EWorkTimeMeasure::Breaks, EWorkTimeLimit::AtLeast, 45min },
+      { Organization::RULE_MIN_REST,       EWorkTimeMeasure::Worked, 0ms, EWorkTimeMeasure::Rest,   EWorkTimeLimit::AtLeast, 11h  },
+      };
+   }
+
+WorkTimeRules::WorkTimeRules(WorkTimeEngine const& engine, std::vector<WorkTimeRule> const& rules, std::chrono::minutes min_break)
+   : engine_(engine), min_break_(ms(min_break)), min_rest_(0) {
+   program_.reserve(rules.size());
+   for (auto const& rule : rules) {
+      if (rule.measure == EWorkTimeMeasure::Rest && rule.comparison == EWorkTimeLimit::AtLeast) min_rest_ = std::max(min_rest_, ms(rule.limit));
+      program_.emplace_back(Instruction { .condition = static_cast<std::uint8_t>(rule.condition), .threshold = ms(rule.threshold),
+                                          .measure = static_cast<std::uint8_t>(rule.measure),
+                                          .sign = rule.comparison == EWorkTimeLimit::AtMost ? 1 : -1,
+                                          .limit = ms(rule.limit), .rule = rule.rule });
+      }
+   if (min_rest_ == 0) min_rest_ = ms(std::chrono::hours { 11 });
+   log_trace<4>("[WorkTimeRules {}] {} rules of the working time compiled.", ::getTimeStamp(), program_.size());
+   }
+
+std::vector<WorkTimeViolation> WorkTimeRules::check(CORBA::Long personId, std::span<TimeBookingEvent const> events,
+                                                    std::chrono::sys_days from, std::chrono::sys_days to) const {
+   std::vector<WorkTimeViolation> violations;
+   if (to < from) return violations;
+
+   // the day in front of the range is needed for the rest before the first working day, the day behind
+   // for the end of a night shift which begins on the last day
+   auto const intervals = engine_.intervals(events, from - std::chrono::days { 1 }, to + std::chrono::days { 1 });
+
+   // measures per working day, a column for each working day in the window
+   std::array<std::vector<std::int64_t>, MeasureCount> measures;
+   for (auto& column : measures) column.reserve(intervals.size());
+   auto& worked = measures[static_cast<std::size_t>(EWorkTimeMeasure::Worked)];
+   auto& breaks = measures[static_cast<std::size_t>(EWorkTimeMeasure::Breaks)];
+   auto& rest   = measures[static_cast<std::size_t>(EWorkTimeMeasure::Rest)];
+   std::vector<std::chrono::sys_days> days;   ///< local day of the begin of each working day
+
+   std::int64_t last_end  = std::numeric_limits<std::int64_t>::min();
+   std::int64_t day_begin = std::numeric_limits<std::int64_t>::min();
+   for (std::size_t i = 0; i < intervals.size(); ++i) {
+      if (intervals.in_break[i]) continue;
+      std::int64_t const begin = intervals.begin[i], end = intervals.end[i];
+      bool const first = last_end == std::numeric_limits<std::int64_t>::min();
+      std::int64_t const gap = first ? NoRest : begin - last_end;
+      if (first || gap >= min_rest_ || begin - day_begin >= DayMs) {
+         worked.emplace_back(0);
+         breaks.emplace_back(0);
+         rest.emplace_back(gap);
+         days.emplace_back(engine_.day_of(booking_time_ty { std::chrono::milliseconds { begin } }));
+         day_begin = begin;
+         }
+      else breaks.back() += gap * (gap >= min_break_);
+      worked.back() += end - begin;
+      last_end = end;
+      }
+
+   // the program runs over the columns of the working days, without a branch per day
+   std::size_t const count = days.size();
+   std::vector<std::uint8_t> violated(count);
+   for (auto const& instruction : program_) {
+      auto const& condition = measures[instruction.condition];
+      auto const& measure   = measures[instruction.measure];
+      for (std::size_t day = 0; day < count; ++day) {
+         violated[day] = (condition[day] > instruction.threshold) &
+                         ((measure[day] - instruction.limit) * instruction.sign > 0) &
+                         (days[day] >= from) & (days[day] <= to);
+         }
+      for (std::size_t day = 0; day < count; ++day) {
+         if (violated[day]) [[unlikely]]
+            violations.emplace_back(WorkTimeViolation { .personId = personId, .day = days[day],
+                                                        .rule = instruction.rule, .value = std::chrono::milliseconds { measure[day] },
+                                                        .limit = std::chrono::milliseconds { instruction.limit } });
+         }
+      }
+   std::ranges::stable_sort(violations, { }, &WorkTimeViolation::day);
+   return violations;
+   }
+
+std::vector<WorkTimeViolation> WorkTimeRules::check_all(BookingLog const& bookings, std::span<CORBA::Long const> personIds,
+                                                        std::chrono::sys_days from, std::chrono::sys_days to) const {
+   std::vector<std::vector<WorkTimeViolation>> results(personIds.size());
+   std::vector<std::size_t> indices(personIds.size());
+   std::iota(indices.begin(), indices.end(), std::size_t { 0 });
+   std::for_each(std::execution::par, indices.begin(), indices.end(), [&](std::size_t i) {
+                    auto const events = bookings.events(personIds[i], engine_.begin_of(from - std::chrono::days { 1 }) - engine_.config().max_shift,
+                                                        engine_.begin_of(to + std::chrono::days { 2 }));
+                    results[i] = check(personIds[i], events, from, to);
+                    });
+
+   std::vector<WorkTimeViolation> violations;
+   violations.reserve(std::transform_reduce(results.begin(), results.end(), std::size_t { 0 }, std::plus<> { },
+                                            [](auto const& result) { return result.size(); }));
+   for (auto const& result : results) violations.insert(violations.end(), result.begin(), result.end());
+   return violations;
+   }
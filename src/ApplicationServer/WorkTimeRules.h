@@ -0,0 +1,138 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Table driven check of the rules of the working time (Arbeitszeitgesetz) for all employees.
+
+  \details This header declares the class `WorkTimeRules`. A rule is a row of a table: when a measure
+           of a working day (worked time, breaks or rest before the working day) is above a threshold,
+           another measure must be at most or at least a limit. The rules are compiled into a flat program
+           of such comparisons, which runs over the columns of the measures of all working days of an
+           employee without a branch per day. The measures are calculated from the intervals of the
+           `WorkTimeEngine`, a working day ends with a rest of at least the minimal rest of the rules.
+
+  \details The default rules are those of the German Arbeitszeitgesetz: at most 10 hours per day (§ 3),
+           30 minutes break after 6 hours and 45 minutes after 9 hours (§ 4, only interruptions of at
+           least 15 minutes count) and 11 hours rest between two working days (§ 5). The check for the
+           whole company runs in parallel, one employee per task.
+
+  \version 1.0
+  \date    15.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see WorkTimeEngine.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "WorkTimeEngine.h"
+
+#include <vector>
+#include <span>
+#include <chrono>
+#include <cstdint>
+
+/// \brief measure of a working day which is used by a rule
+enum class EWorkTimeMeasure : std::uint8_t {
+   Worked = 0,  ///< worked time of the working day
+   Breaks = 1,  ///< interruptions of the work in the working day, each at least the minimal break
+   Rest   = 2,  ///< time between the end of the working day before and the first work of the working day
+   };
+
+/// \brief comparison of a rule
+enum class EWorkTimeLimit : std::uint8_t {
+   AtMost,   ///< the measure must not exceed the limit
+   AtLeast   ///< the measure must reach the limit
+   };
+
+/**
+  \brief Row of the rule table: when `condition` is above `threshold`, `measure` must be at most / at least `limit`.
+ */
+struct WorkTimeRule {
+   Organization::EWorkTimeRule rule;       ///< id of the rule in the reported violations
+   EWorkTimeMeasure            condition;
+   std::chrono::milliseconds   threshold;
+   EWorkTimeMeasure            measure;
+   EWorkTimeLimit              comparison;
+   std::chrono::milliseconds   limit;
+   };
+
+/// \brief violation of a rule by an employee on a day
+struct WorkTimeViolation {
+   CORBA::Long                 personId;
+   std::chrono::sys_days       day;    ///< local day on which the working day begins
+   Organization::EWorkTimeRule rule;
+   std::chrono::milliseconds   value;  ///< value of the measure of the working day
+   std::chrono::milliseconds   limit;  ///< limit of the rule
+   };
+
+/**
+  \brief Compiled rules of the working time, checked per employee or for the whole company.
+ */
+class WorkTimeRules {
+public:
+   static constexpr std::size_t MeasureCount = 3;
+
+   /// \brief rules of the German Arbeitszeitgesetz (§§ 3 - 5)
+   static std::vector<WorkTimeRule> german_rules();
+
+private:
+   /// \brief compiled rule, the comparison is a factor for a branch-free check
+   struct Instruction {
+      std::uint8_t                condition;
+      std::int64_t                threshold;
+      std::uint8_t                measure;
+      std::int64_t                sign;      ///< +1 for AtMost, -1 for AtLeast
+      std::int64_t                limit;
+      Organization::EWorkTimeRule rule;
+      };
+
+   WorkTimeEngine const&    engine_;
+   std::vector<Instruction> program_;
+   std::int64_t             min_break_;
+   std::int64_t             min_rest_;   ///< gap which ends a working day, the longest minimal rest of the rules (11 hours without a rule)
+
+public:
+   WorkTimeRules() = delete;
+   WorkTimeRules(WorkTimeRules const&) = delete;
+   WorkTimeRules& operator = (WorkTimeRules const&) = delete;
+
+   /**
+     \param engine calculation of the intervals, must outlive the rules
+     \param rules table of the rules, compiled in the constructor
+     \param min_break minimal length of an interruption which counts as break
+    */
+   WorkTimeRules(WorkTimeEngine const& engine, std::vector<WorkTimeRule> const& rules,
+                 std::chrono::minutes min_break = std::chrono::minutes { 15 });
+
+   explicit WorkTimeRules(WorkTimeEngine const& engine) : WorkTimeRules(engine, german_rules()) { }
+
+   /**
+     \brief checks the rules for the working days of an employee which begin in the days [from, to]
+     \param events bookings of the employee from the day before from up to the day behind to
+    */
+   std::vector<WorkTimeViolation> check(CORBA::Long personId, std::span<TimeBookingEvent const> events,
+                                        std::chrono::sys_days from, std::chrono::sys_days to) const;
+
+   /// \brief checks the rules for many employees in parallel, the violations are ordered by the employees
+   std::vector<WorkTimeViolation> check_all(BookingLog const& bookings, std::span<CORBA::Long const> personIds,
+                                            std::chrono::sys_days from, std::chrono::sys_days to) const;
+   };
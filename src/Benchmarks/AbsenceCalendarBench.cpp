@@ -0,0 +1,198 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Benchmark of the absence calendar with 100000 absences.
+
+  \details The program loads the absences of a year for the employees into an `AbsenceCalendar` and
+           measures the queries of the server: the absences of all employees in a week, the absences
+           of one employee in a month and the absent days of an employee for a timesheet. Each result
+           is compared with a linear scan over all absences. The single changes are measured with a
+           smaller number, because each change publishes a new version of the calendar. At last the
+           absences are written to a journal and recovered with `AbsenceRecovery`, like at the start
+           of the server.
+
+           Options: `-Entries <n>` (default 100000), `-Employees <n>` (default 10000), `-Queries <n>`
+           queries of each kind (default 1000), `-Changes <n>` single changes (default 200),
+           `-Directory <path>` of the journal (default in the temp directory, removed at the end).
+
+  \version 1.0
+  \date    16.10.2026
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+
+#include "AbsenceCalendar.h"
+#include "BookingJournal.h"
+
+#include <vector>
+#include <random>
+#include <filesystem>
+#include <algorithm>
+
+namespace {
+
+   using namespace std::chrono;
+
+   /// \brief ascending ids of the absences which overlap [from, to], of all employees or of one employee
+   std::vector<std::uint64_t> scan(std::vector<AbsenceEntry> const& entries, std::optional<CORBA::Long> personId, sys_days from, sys_days to) {
+      std::vector<std::uint64_t> result;
+      for (auto const& entry : entries)
+         if (entry.from <= to && entry.to >= from && (!personId || entry.personId == *personId)) result.emplace_back(entry.absenceId);
+      std::ranges::sort(result);
+      return result;
+      }
+
+   /// \brief ascending ids of the absences
+   std::vector<std::uint64_t> ids(std::vector<AbsenceEntry> const& entries) {
+      std::vector<std::uint64_t> result;
+      result.reserve(entries.size());
+      for (auto const& entry : entries) result.emplace_back(entry.absenceId);
+      std::ranges::sort(result);
+      return result;
+      }
+
+   }
+
+int main(int argc, char* argv[]) {
+   auto const count     = bench::option<std::size_t>(argc, argv, "-Entries", 100'000);
+   auto const employees = std::max(bench::option<CORBA::Long>(argc, argv, "-Employees", 10'000), CORBA::Long { 1 });
+   auto const queries   = bench::option<std::size_t>(argc, argv, "-Queries", 1'000);
+   auto const changes   = bench::option<std::size_t>(argc, argv, "-Changes", 200);
+   std::filesystem::path directory = std::filesystem::temp_directory_path() / "AbsenceCalendarBench";
+   for (int i = 1; i + 1 < argc; ++i)
+      if (std::string_view { argv[i] } == "-Directory") directory = argv[i + 1];
+   bool ok = true;
+
+   // absences of 1 to 15 days in 2025, every 4th one isn't approved
+   sys_days const year_begin { 2025y / January / 1 }, year_end { 2025y / December / 31 };
+   auto const year_days = (year_end - year_begin).count() + 1;
+   std::mt19937 random { 4711 };
+   std::vector<AbsenceEntry> entries;
+   entries.reserve(count);
+   for (std::size_t i = 0; i < count; ++i) {
+      auto const from = year_begin + days { std::uniform_int_distribution<int> { 0, year_days - 1 }(random) };
+      entries.emplace_back(AbsenceEntry { .absenceId = i + 1,
+                                          .personId  = static_cast<CORBA::Long>(i % static_cast<std::size_t>(employees)) + 1,
+                                          .from      = from,
+                                          .to        = from + days { std::uniform_int_distribution<int> { 0, 14 }(random) },
+                                          .kind      = i % 10 == 0 ? Organization::ABSENCE_SICKNESS : Organization::ABSENCE_VACATION,
+                                          .approved  = i % 4 != 0 });
+      }
+
+   AbsenceCalendar calendar;
+   auto const loaded = bench::measure_once([&]() { calendar.load(entries, count + 1); });
+   ok &= bench::check(calendar.size() == count, "all absences loaded");
+
+   // the ranges of the queries are drawn before, so all runs use the same queries
+   std::vector<std::pair<CORBA::Long, sys_days>> ranges;
+   ranges.reserve(queries);
+   for (std::size_t i = 0; i < queries; ++i)
+      ranges.emplace_back(std::uniform_int_distribution<CORBA::Long> { 1, employees }(random),
+                          year_begin + days { std::uniform_int_distribution<int> { 0, year_days - 31 }(random) });
+
+   std::size_t company_found = 0, employee_found = 0, absent_found = 0;
+   auto const company_time = bench::measure(5, [&]() {
+      company_found = 0;
+      for (auto const& [personId, from] : ranges) company_found += calendar.overlapping(from, from + days { 6 }).size();
+      });
+   auto const employee_time = bench::measure(5, [&]() {
+      employee_found = 0;
+      for (auto const& [personId, from] : ranges) employee_found += calendar.overlapping(personId, from, from + days { 30 }).size();
+      });
+   auto const absent_time = bench::measure(5, [&]() {
+      absent_found = 0;
+      for (auto const& [personId, from] : ranges) absent_found += calendar.absent_days(personId, from, from + days { 30 }).size();
+      });
+
+   // the results of the tree are compared with the linear scan
+   bool company_equal = true, employee_equal = true, absent_equal = true;
+   for (auto const& [personId, from] : ranges) {
+      company_equal  &= ids(calendar.overlapping(from, from + days { 6 })) == scan(entries, std::nullopt, from, from + days { 6 });
+      employee_equal &= ids(calendar.overlapping(personId, from, from + days { 30 })) == scan(entries, personId, from, from + days { 30 });
+      std::vector<sys_days> expected;
+      for (auto const& entry : entries) {
+         if (entry.personId != personId || !entry.approved) continue;
+         for (auto day = std::max(entry.from, from); day <= std::min(entry.to, from + days { 30 }); day += days { 1 }) expected.emplace_back(day);
+         }
+      std::ranges::sort(expected);
+      expected.erase(std::ranges::unique(expected).begin(), expected.end());
+      absent_equal &= calendar.absent_days(personId, from, from + days { 30 }) == expected;
+      }
+   ok &= bench::check(company_equal, "absences of all employees like the linear scan");
+   ok &= bench::check(employee_equal, "absences of an employee like the linear scan");
+   ok &= bench::check(absent_equal, "absent days like the linear scan");
+
+   // single changes, each publishes a new version with the whole calendar
+   std::vector<std::uint64_t> added;
+   added.reserve(changes);
+   auto const add_time = bench::measure_once([&]() {
+      for (std::size_t i = 0; i < changes; ++i)
+         added.emplace_back(calendar.add(static_cast<CORBA::Long>(i % static_cast<std::size_t>(employees)) + 1, year_end, year_end,
+                                         Organization::ABSENCE_TRAINING, true));
+      });
+   auto const remove_time = bench::measure_once([&]() {
+      for (auto const absenceId : added) ok &= calendar.remove(absenceId);
+      });
+   ok &= bench::check(calendar.size() == count, "added absences removed again");
+
+   // journal with all absences in batches and the recovery at the start of the server
+   std::error_code ec;
+   std::filesystem::remove_all(directory, ec);
+   auto const written = bench::measure_once([&]() {
+      BookingJournal journal({ .directory = directory });
+      journal.open([](std::span<TimeBookingEvent const>) { });
+      std::vector<AbsenceChange> batch;
+      batch.reserve(10'000);
+      for (auto const& entry : entries) {
+         batch.emplace_back(AbsenceChange { .type = EJournalRecord::AbsenceAdded, .entry = entry });
+         if (batch.size() < 10'000) continue;
+         journal.append(batch);
+         batch.clear();
+         }
+      journal.append(batch);
+      });
+   BookingJournal::RecoveryStatistics recovery;
+   AbsenceCalendar recovered;
+   auto const recovery_time = bench::measure_once([&]() {
+      AbsenceRecovery absences;
+      BookingJournal journal({ .directory = directory });
+      recovery = journal.open([](std::span<TimeBookingEvent const>) { }, 0,
+                              [&absences](AbsenceChange const& change) { absences.apply(change); });
+      recovered.load(absences.entries(), absences.next_id());
+      });
+   ok &= bench::check(recovery.absences == count && ids(recovered.entries()) == ids(entries) && recovered.next_id() == count + 1,
+                      "all absences recovered from the journal");
+   std::filesystem::remove_all(directory, ec);
+
+   std::println("absence calendar with {} absences of {} employees", count, employees);
+   std::println("   load:                       {:10.1f} ms", loaded.count());
+   std::println("   {} weeks of all employees: {:10.1f} ms  {:12.0f} queries/s  {} absences", queries, company_time.count(),
+                bench::per_second(queries, company_time), company_found);
+   std::println("   {} months of an employee:  {:10.1f} ms  {:12.0f} queries/s  {} absences", queries, employee_time.count(),
+                bench::per_second(queries, employee_time), employee_found);
+   std::println("   {} absent days:            {:10.1f} ms  {:12.0f} queries/s  {} days", queries, absent_time.count(),
+                bench::per_second(queries, absent_time), absent_found);
+   std::println("   {} single adds / removes:   {:10.1f} ms / {:.1f} ms", changes, add_time.count(), remove_time.count());
+   std::println("   journal write / recovery:   {:10.1f} ms / {:.1f} ms", written.count(), recovery_time.count());
+   return ok ? 0 : 1;
+   }
@@ -0,0 +1,96 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Small helpers for the benchmark programs of the application server.
+
+  \details The benchmarks are plain programs without a framework. A measurement is repeated a few
+           times after a warm up and the median is reported, the programs print one line per case
+           and return 1 when a check of the results fails, so they can be run as smoke test, too.
+
+  \version 1.0
+  \date    25.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string_view>
+#include <charconv>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <print>
+
+namespace bench {
+
+   using clock_ty    = std::chrono::steady_clock;
+   using duration_ty = std::chrono::duration<double, std::milli>;
+
+   /// \brief duration of one call of the function
+   inline duration_ty measure_once(std::function<void ()> const& func) {
+      auto const start = clock_ty::now();
+      func();
+      return std::chrono::duration_cast<duration_ty>(clock_ty::now() - start);
+      }
+
+   /**
+     \brief Median duration of repeated calls after one warm up call.
+     \param repeats number of measured calls
+     \param func measured function, it has to prepare its own input on each call
+    */
+   inline duration_ty measure(std::size_t repeats, std::function<void ()> const& func) {
+      func();
+      std::vector<duration_ty> times;
+      times.reserve(repeats);
+      for (std::size_t i = 0; i < std::max<std::size_t>(repeats, 1); ++i) times.emplace_back(measure_once(func));
+      std::ranges::nth_element(times, times.begin() + times.size() / 2);
+      return times[times.size() / 2];
+      }
+
+   /// \brief operations per second for a count of operations in a duration
+   inline double per_second(std::size_t count, duration_ty duration) {
+      return duration.count() > 0.0 ? count * 1'000.0 / duration.count() : 0.0;
+      }
+
+   /// \brief value of the option `name <value>` of the command line, or the default
+   template <typename ty>
+   ty option(int argc, char* argv[], std::string_view name, ty default_value) {
+      for (int i = 1; i + 1 < argc; ++i) {
+         if (std::string_view { argv[i] } != name) continue;
+         std::string_view value { argv[i + 1] };
+         ty result { };
+         if (auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result); ec == std::errc { })
+            return result;
+         std::println(std::cerr, "invalid value \"{}\" for {}, {} used.", value, name, default_value);
+         }
+      return default_value;
+      }
+
+   /// \brief reports a failed check, the programs return 1 when a check failed
+   inline bool check(bool condition, std::string_view what) {
+      if (!condition) std::println(std::cerr, "check failed: {}", what);
+      return condition;
+      }
+
+} // end of namespace bench
@@ -0,0 +1,162 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Load test of the booking log with a simulated 8:00 rush at the shift change.
+
+  \details Every employee books COME once in a window around 8:00, the arrival times are normal
+           distributed with the maximum at 8:00. The employees are spread over the terminals, each
+           terminal is a thread which books its employees in the order of their arrival, as fast as
+           possible. A part of the bookings is sent twice, like a terminal which repeats a booking
+           after a lost answer. The rush is replayed once with single bookings (`bookTimeEvent`) and
+           once with batches (`bookTimeEvents`), each time into a new `BookingLog`.
+
+           Options: `-Employees <n>` (default 20000), `-Terminals <n>` threads (default 32),
+           `-Window <n>` minutes around 8:00 (default 30), `-Repeats <n>` percent of repeated
+           bookings (default 5), `-Batch <n>` bookings of a batch (default 16), `-Shards <n>` (default 64).
+
+  \version 1.0
+  \date    27.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+
+#include "BookingLog.h"
+
+#include <vector>
+#include <thread>
+#include <barrier>
+#include <random>
+#include <algorithm>
+#include <span>
+
+namespace {
+
+   using namespace std::chrono;
+
+   /// \brief bookings of one terminal in the order of the arrival
+   using terminal_bookings_ty = std::vector<TimeBookingEvent>;
+
+   std::vector<terminal_bookings_ty> simulate_rush(CORBA::Long employees, std::size_t terminals, minutes window, int repeat_percent,
+                                                   sys_days today) {
+      std::mt19937 random(2025);
+      std::normal_distribution<double> arrival(0.0, duration_cast<milliseconds>(window).count() / 6.0);
+      std::uniform_int_distribution<int> percent(0, 99);
+      auto const rush = today + 8h;
+      std::vector<terminal_bookings_ty> result(terminals);
+      for (CORBA::Long personId = 1; personId <= employees; ++personId) {
+         auto const offset = std::clamp(arrival(random), -duration_cast<milliseconds>(window).count() / 2.0,
+                                                          duration_cast<milliseconds>(window).count() / 2.0);
+         auto const terminal = static_cast<std::size_t>(personId) % terminals;
+         TimeBookingEvent event { personId, rush + milliseconds { static_cast<std::int64_t>(offset) }, Organization::COME,
+                                  static_cast<CORBA::Long>(terminal) };
+         result[terminal].emplace_back(event);
+         if (percent(random) < repeat_percent) result[terminal].emplace_back(event);
+         }
+      for (auto& bookings : result) std::ranges::stable_sort(bookings, { }, &TimeBookingEvent::timepoint);
+      return result;
+      }
+
+   struct RushResult {
+      bench::duration_ty          duration;
+      std::vector<nanoseconds>    latencies;   ///< duration of each call
+      };
+
+   /// \brief replays the bookings of all terminals at the same time, batch 0 books single events
+   RushResult replay(BookingLog& log, std::vector<terminal_bookings_ty> const& terminals, std::size_t batch, booking_time_ty now) {
+      RushResult result;
+      std::vector<std::vector<nanoseconds>> latencies(terminals.size());
+      std::barrier start(static_cast<std::ptrdiff_t>(terminals.size() + 1));
+      {
+         std::vector<std::jthread> threads;
+         for (std::size_t t = 0; t < terminals.size(); ++t) {
+            threads.emplace_back([&, t]() {
+               auto const& bookings = terminals[t];
+               auto& times = latencies[t];
+               times.reserve(bookings.size());
+               std::vector<Organization::EBookingResult> results(std::max<std::size_t>(batch, 1));
+               start.arrive_and_wait();
+               if (batch == 0) {
+                  for (auto const& booking : bookings) {
+                     auto const begin = bench::clock_ty::now();
+                     log.append(booking, now);
+                     times.emplace_back(bench::clock_ty::now() - begin);
+                     }
+                  }
+               else {
+                  for (std::size_t pos = 0; pos < bookings.size(); pos += batch) {
+                     auto const chunk = std::span { bookings }.subspan(pos, std::min(batch, bookings.size() - pos));
+                     auto const begin = bench::clock_ty::now();
+                     log.append(chunk, std::span { results }.first(chunk.size()), now);
+                     times.emplace_back(bench::clock_ty::now() - begin);
+                     }
+                  }
+               });
+            }
+         result.duration = bench::measure_once([&]() {
+            start.arrive_and_wait();
+            threads.clear();
+            });
+      }
+      for (auto& times : latencies) result.latencies.insert(result.latencies.end(), times.begin(), times.end());
+      std::ranges::sort(result.latencies);
+      return result;
+      }
+
+   nanoseconds percentile(std::vector<nanoseconds> const& sorted, double p) {
+      if (sorted.empty()) return nanoseconds { 0 };
+      return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()))];
+      }
+
+   }
+
+int main(int argc, char* argv[]) {
+   auto const employees = bench::option<CORBA::Long>(argc, argv, "-Employees", 20'000);
+   auto const terminals = bench::option<std::size_t>(argc, argv, "-Terminals", 32);
+   auto const window    = minutes { bench::option<int>(argc, argv, "-Window", 30) };
+   auto const repeats   = bench::option<int>(argc, argv, "-Repeats", 5);
+   auto const batch     = bench::option<std::size_t>(argc, argv, "-Batch", 16);
+   auto const shards    = bench::option<std::size_t>(argc, argv, "-Shards", 64);
+   bool ok = true;
+
+   auto const today = floor<days>(system_clock::now());
+   auto const now   = booking_time_ty { today + 8h } + window;   // the replay runs after the rush, all bookings are in the past
+   auto const rush  = simulate_rush(employees, std::max<std::size_t>(terminals, 1), window, repeats, today);
+   std::size_t bookings = 0;
+   for (auto const& terminal : rush) bookings += terminal.size();
+
+   std::println("8:00 rush: {} employees, {} bookings ({} repeated) from {} terminals within {}, {} shards", employees, bookings,
+                bookings - static_cast<std::size_t>(employees), rush.size(), window, shards);
+   for (auto const size : { std::size_t { 0 }, batch }) {
+      BookingLog log({ .shards = shards });
+      auto const result = replay(log, rush, size, now);
+      auto const stats  = log.statistics();
+      auto const what   = size == 0 ? std::string { "single bookings" } : std::format("batches of {}", size);
+      ok &= bench::check(stats.accepted == static_cast<std::uint64_t>(employees), std::format("{}: one accepted COME per employee", what));
+      ok &= bench::check(stats.duplicates == bookings - static_cast<std::size_t>(employees), std::format("{}: repeated bookings dropped", what));
+      ok &= bench::check(stats.invalid == 0, std::format("{}: no invalid booking", what));
+      std::println("   {:<16} {:9.1f} ms  {:10.0f} bookings/s  latency p50 {}  p99 {}  max {}", what, result.duration.count(),
+                   bench::per_second(bookings, result.duration), percentile(result.latencies, 0.50),
+                   percentile(result.latencies, 0.99), result.latencies.empty() ? nanoseconds { 0 } : result.latencies.back());
+      }
+   return ok ? 0 : 1;
+   }
@@ -0,0 +1,152 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Test and benchmark of the DatabasePool against a generated SQLite database.
+
+  \details The program generates a SQLite file with employees and runs the lookups of the read-through
+           cache (`FetchEmployee`) with several threads over a `DatabasePool` of `SQLiteConnection`s.
+           Every result is compared with the generated data. The same lookups are measured once more
+           with a statement prepared for each request, to show the effect of the statement cache.
+           At the end the health check runs over all connections.
+
+           Options: `-Employees <n>` (default 10000), `-Pool <n>` connections (default 4),
+           `-Threads <n>` (default 8), `-Lookups <n>` per thread (default 5000),
+           `-File <path>` of the SQLite database (default in the temp directory).
+
+  \version 1.0
+  \date    25.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+#include "SQLiteStandIn.h"
+
+#include "DatabasePool.h"
+#include "EmployeeStatements.h"
+#include "EmployeeLoader.h"
+
+#include <QtCore/QCoreApplication>
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <numeric>
+#include <filesystem>
+
+using sqlite_pool_ty = DatabasePool<SQLiteConnection, SQLiteQuery>;
+
+namespace {
+
+   bool same_employee(EmployeeData const& lhs, EmployeeData const& rhs) {
+      return lhs.personID == rhs.personID && lhs.firstname == rhs.firstname && lhs.name == rhs.name && lhs.gender == rhs.gender &&
+             lhs.salary == rhs.salary && lhs.startDate == rhs.startDate && lhs.isActive == rhs.isActive;
+      }
+
+   /// \brief runs the lookup with the threads, each thread reads random ids, also ids which don't exist
+   template <typename lookup_ty>
+   std::size_t run_lookups(std::size_t threads, std::size_t lookups, CORBA::Long employees, lookup_ty lookup) {
+      std::atomic<std::size_t> errors = 0;
+      std::vector<std::jthread> workers;
+      for (std::size_t t = 0; t < threads; ++t) {
+         workers.emplace_back([&, t]() {
+            std::mt19937 random(static_cast<std::mt19937::result_type>(t + 1));
+            std::uniform_int_distribution<CORBA::Long> ids(1, employees + employees / 10);
+            for (std::size_t i = 0; i < lookups; ++i) {
+               auto const personId = ids(random);
+               auto const data = lookup(personId);
+               bool const ok = personId <= employees ? data && same_employee(*data, FixtureEmployee(personId)) : !data;
+               if (!ok) ++errors;
+               }
+            });
+         }
+      workers.clear();
+      return errors;
+      }
+
+   }
+
+int main(int argc, char* argv[]) {
+   QCoreApplication app(argc, argv);
+   auto const employees = bench::option<CORBA::Long>(argc, argv, "-Employees", 10'000);
+   auto const pool_size = bench::option<std::size_t>(argc, argv, "-Pool", 4);
+   auto const threads   = bench::option<std::size_t>(argc, argv, "-Threads", 8);
+   auto const lookups   = bench::option<std::size_t>(argc, argv, "-Lookups", 5'000);
+   std::filesystem::path file = std::filesystem::temp_directory_path() / "DatabasePoolBench.sqlite";
+   for (int i = 1; i + 1 < argc; ++i)
+      if (std::string_view { argv[i] } == "-File") file = argv[i + 1];
+   bool ok = true;
+
+   std::vector<CORBA::Long> ids(static_cast<std::size_t>(employees));
+   std::iota(ids.begin(), ids.end(), CORBA::Long { 1 });
+   auto const created = bench::measure_once([&]() { CreateEmployeeFixture(file, ids); });
+   std::println("SQLite fixture {} with {} employees created in {:.1f} ms", file.string(), employees, created.count());
+
+   {
+      sqlite_pool_ty pool({ .size = pool_size }, [&file](SQLiteConnection& connection) { connection.Open(file); });
+
+      // lookups with the statement cache of the connections
+      std::size_t errors = 0;
+      auto const cached = bench::measure_once([&]() {
+         errors = run_lookups(threads, lookups, employees, [&pool](CORBA::Long personId) { return FetchEmployee(pool, personId); });
+         });
+      ok &= bench::check(errors == 0, "lookups with the statement cache return the generated employees");
+
+      // the same lookups, the statement is prepared for each request
+      auto const prepared = bench::measure_once([&]() {
+         errors = run_lookups(threads, lookups, employees, [&pool](CORBA::Long personId) -> std::optional<EmployeeData> {
+            auto lease = pool.acquire();
+            auto query = lease.connection().CreateQuery(EmployeeById.sql);
+            if (query.Execute({ { "keyID", static_cast<int>(personId), true } }); query.IsEof()) return std::nullopt;
+            EmployeeData data;
+            data.personID  = query.Get<int>("ID").value_or(personId);
+            data.firstname = query.Get<std::string>("Firstname").value_or(""s);
+            data.name      = query.Get<std::string>("Name").value_or(""s);
+            data.gender    = static_cast<Organization::EGender>(query.Get<int>("Gender").value_or(2));
+            data.salary    = query.Get<double>("Salary").value_or(0.0);
+            data.startDate = query.Get<std::chrono::year_month_day>("StartDate").value_or(std::chrono::year_month_day { });
+            data.isActive  = query.Get<bool>("IsActive").value_or(false);
+            return data;
+            });
+         });
+      ok &= bench::check(errors == 0, "lookups with prepared statements return the generated employees");
+
+      auto const failures = pool.check_health();
+      ok &= bench::check(failures == 0, "health check of all connections");
+
+      auto const metrics = pool.metrics();
+      ok &= bench::check(metrics.statements_prepared <= metrics.size, "one prepared statement per connection");
+      ok &= bench::check(metrics.idle == metrics.size && metrics.timeouts == 0, "all connections returned, no timeouts");
+
+      auto const total = threads * lookups;
+      std::println("{} lookups with {} threads over {} connections", total, threads, pool_size);
+      std::println("   statement cache:        {:10.1f} ms  {:10.0f} lookups/s", cached.count(), bench::per_second(total, cached));
+      std::println("   prepared per request:   {:10.1f} ms  {:10.0f} lookups/s", prepared.count(), bench::per_second(total, prepared));
+      std::println("   metrics: {} acquired, {} waits, {} timeouts, {} prepared, {} reused, {} health failures",
+                   metrics.acquired, metrics.waits, metrics.timeouts, metrics.statements_prepared, metrics.statements_reused,
+                   metrics.health_failures);
+   }
+
+   std::error_code ec;
+   std::filesystem::remove(file, ec);
+   return ok ? 0 : 1;
+   }
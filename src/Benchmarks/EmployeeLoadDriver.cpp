@@ -0,0 +1,235 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Load driver of a Company_i server with concurrent getEmployeeData callers, scaled from 1 to N dispatch threads.
+
+  \details For each step a `Company_i` with the test employees is registered in a `CORBAServer` and
+           served with `CORBAServer::run()` by 1, 2, 4, ... up to the configured number of dispatch
+           threads and the selected dispatch profile. The clients are threads with an own stub of the
+           company each, they call `getEmployeeData()` for random employees, every 100th call asks for
+           an id which doesn't exist and gets `EmployeeNotFound`. The ORB is initialized with
+           `-ORBCollocation no`, so the calls take the way through IIOP and the dispatch threads like
+           the calls of a remote client. The throughput of each step is compared with the single
+           dispatch thread, a servant which serializes its callers shows up as a speedup near 1.
+           With the profile `connection` each client connection gets an own thread of TAO, the
+           dispatch threads only accept the connections.
+
+           Like the application server the driver needs the naming service, e.g. with
+           `-ORBInitRef NameService=corbaloc:iiop:localhost:2809/NameService`.
+
+           Options: `-Employees <n>` (default 10000), `-DispatchThreads <n>` maximal number of
+           dispatch threads (default one per core), `-DispatchProfile pool|connection` (default pool),
+           `-Clients <n>` concurrent clients (default 16), `-Calls <n>` of each client (default 10000).
+
+  \version 1.0
+  \date    16.10.2026
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+
+#include "Company_i.h"
+#include "EmployeePOA.h"
+#include "EmployeeStore.h"
+#include "EmployeeData.h"
+#include "Corba_Interfaces.h"
+
+#include "OrganizationC.h"
+
+#include <tao/corba.h>
+#include <tao/PortableServer/PortableServer.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <barrier>
+#include <random>
+#include <algorithm>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace {
+
+   using namespace std::chrono;
+
+   struct RunResult {
+      std::uint64_t       found     = 0;  ///< calls which returned the requested employee
+      std::uint64_t       not_found = 0;  ///< calls for ids which don't exist
+      std::uint64_t       wrong     = 0;  ///< calls which returned another employee, missed an existing one or failed
+      bench::duration_ty  duration  = {}; ///< wall time from the start of the clients to the end of the last one
+      };
+
+   EmployeeData employee(CORBA::Long personId) {
+      return { { personId, std::format("Firstname{}", personId), std::format("Name{}", personId % 977),
+                 static_cast<Organization::EGender>(personId % 3) },
+               40'000.0 + personId % 1'000, year_month_day { 2000y, January, 1d }, personId % 10 != 0 };
+      }
+
+   /// \brief dispatch profile of `-DispatchProfile pool|connection`, the thread pool is the default
+   EORBDispatch profile_option(int argc, char* argv[]) {
+      for (int i = 1; i + 1 < argc; ++i) {
+         if (std::string_view { argv[i] } != "-DispatchProfile"sv) continue;
+         std::string_view value { argv[i + 1] };
+         if (value == "pool"sv) return EORBDispatch::ThreadPool;
+         if (value == "connection"sv) return EORBDispatch::ThreadPerConnection;
+         std::println(std::cerr, "invalid value \"{}\" for -DispatchProfile, pool used.", value);
+         }
+      return EORBDispatch::ThreadPool;
+      }
+
+   /**
+     \brief Calls getEmployeeData() with concurrent clients, each with an own stub of the company.
+     \details The first call of each client opens its connection before the measurement starts.
+    */
+   RunResult drive(CORBA::ORB_ptr orb, const char* ior, std::size_t clients, CORBA::Long employees, std::size_t calls) {
+      std::atomic<std::uint64_t> found = 0, not_found = 0, wrong = 0;
+      std::barrier start(static_cast<std::ptrdiff_t>(clients + 1));
+      std::vector<std::jthread> callers;
+      for (std::size_t t = 0; t < clients; ++t) {
+         callers.emplace_back([&, t]() {
+            Organization::Company_var company;
+            try {
+               CORBA::Object_var object = orb->string_to_object(ior);
+               company = Organization::Company::_narrow(object.in());
+               if (!CORBA::is_nil(company.in())) Organization::EmployeeData_var first = company->getEmployeeData(1);
+               }
+            catch (CORBA::Exception const& ex) {
+               std::println(std::cerr, "client {} can't reach the company: {}", t, toString(ex));
+               company = Organization::Company::_nil();
+               }
+            std::mt19937 random(static_cast<std::mt19937::result_type>(t + 1));
+            std::uniform_int_distribution<CORBA::Long> ids(1, employees);
+            std::uint64_t hits = 0, misses = 0, errors = 0;
+            start.arrive_and_wait();
+            if (CORBA::is_nil(company.in())) {
+               wrong += calls;
+               return;
+               }
+            for (std::size_t call = 0; call < calls; ++call) {
+               CORBA::Long const personId = call % 100 == 99 ? employees + ids(random) : ids(random);
+               try {
+                  Organization::EmployeeData_var reply = company->getEmployeeData(personId);
+                  if (reply->personId == personId) ++hits;
+                  else ++errors;
+                  }
+               catch (Organization::EmployeeNotFound const&) {
+                  if (personId > employees) ++misses;
+                  else ++errors;
+                  }
+               catch (CORBA::Exception const&) {
+                  ++errors;
+                  }
+               }
+            found += hits;
+            not_found += misses;
+            wrong += errors;
+            });
+         }
+      start.arrive_and_wait();
+      auto const begin = bench::clock_ty::now();
+      callers.clear();
+      RunResult result;
+      result.duration  = duration_cast<bench::duration_ty>(bench::clock_ty::now() - begin);
+      result.found     = found;
+      result.not_found = not_found;
+      result.wrong     = wrong;
+      return result;
+      }
+
+   /**
+     \brief Serves a Company_i with the employees by the dispatch threads and drives it with the clients.
+     \details Server and ORB live for one step, the ORB is initialized again for the next number of threads.
+              `ORB_init` consumes its options, therefore each step gets an own copy of the command line.
+    */
+   RunResult serve(int argc, char* argv[], EORBDispatch profile, std::size_t dispatch_threads, EmployeeStore const& employees,
+                   std::size_t clients, std::size_t calls) {
+      std::vector<char*> args(argv, argv + argc);
+      std::string collocation = "-ORBCollocation"s, collocation_value = "no"s;
+      args.emplace_back(collocation.data());
+      args.emplace_back(collocation_value.data());
+      ORBArguments orb_args(static_cast<int>(args.size()), args.data(), profile);
+      CORBAServer<Company_i> server("EmployeeLoadDriver"s, orb_args.argc(), orb_args.argv());
+
+      auto empl_pol = CreateEmployeePolicies(server.root_poa());
+      PortableServer::POA_var employee_poa = server.root_poa()->create_POA("EmployeePOA", server.poa_manager(), empl_pol);
+      for (CORBA::ULong i = 0; i < empl_pol.length(); ++i) empl_pol[i]->destroy();
+
+      auto company = new Company_i(server.orb(), server.servant_poa(), employee_poa.in());
+      company->replaceEmployees(EmployeeStore { employees });
+      server.register_servant<0>("EmployeeLoadDriver"s, [poa = std::move(employee_poa)]() mutable {
+                                    if (!CORBA::is_nil(poa.in())) poa->destroy(true, true);
+                                    },
+                                 company);
+
+      CORBA::Object_var object = server.servant_poa()->servant_to_reference(company);
+      CORBA::String_var ior = server.orb()->object_to_string(object.in());
+
+      std::atomic<bool> shutdown_requested = false;
+      std::jthread dispatcher([&server, &shutdown_requested, dispatch_threads]() { server.run(shutdown_requested, dispatch_threads); });
+      auto const result = drive(server.orb(), ior.in(), clients, static_cast<CORBA::Long>(employees.size()), calls);
+      shutdown_requested = true;
+      return result;
+      }
+
+   }
+
+int main(int argc, char* argv[]) {
+   auto const employees = bench::option<CORBA::Long>(argc, argv, "-Employees", 10'000);
+   auto const threads   = bench::option<std::size_t>(argc, argv, "-DispatchThreads", std::max(1u, std::thread::hardware_concurrency()));
+   auto const clients   = bench::option<std::size_t>(argc, argv, "-Clients", 16);
+   auto const calls     = bench::option<std::size_t>(argc, argv, "-Calls", 10'000);
+   auto const profile   = profile_option(argc, argv);
+   bool ok = true;
+
+   EmployeeStore store;
+   store.reserve(static_cast<std::size_t>(employees));
+   for (CORBA::Long personId = 1; personId <= employees; ++personId) store.insert(employee(personId));
+
+   std::println("{} employees, {} clients with {} calls of getEmployeeData each, dispatch profile {}", employees, clients, calls,
+                profile == EORBDispatch::ThreadPool ? "pool"sv : "connection"sv);
+   std::println("   dispatch threads   calls/s   speedup");
+   try {
+      double single = 0.0;
+      for (std::size_t count = 1; count <= threads; count = count < threads && count * 2 > threads ? threads : count * 2) {
+         auto const result = serve(argc, argv, profile, count, store, clients, calls);
+         auto const total  = clients * calls;
+         auto const rate   = bench::per_second(total, result.duration);
+         if (count == 1) single = rate;
+         ok &= bench::check(result.found + result.not_found == total && result.wrong == 0,
+                            std::format("{} dispatch threads: every call returned the requested employee", count));
+         std::println("   {:16}   {:7.0f}   {:7.2f}", count, rate, single > 0.0 ? rate / single : 0.0);
+         if (count == threads) break;
+         }
+      }
+   catch (CORBA::Exception const& ex) {
+      std::println(std::cerr, "CORBA exception: {}", toString(ex));
+      return 1;
+      }
+   catch (std::exception const& ex) {
+      std::println(std::cerr, "exception: {}", ex.what());
+      return 1;
+      }
+   return ok ? 0 : 1;
+   }
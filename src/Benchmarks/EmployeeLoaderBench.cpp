@@ -0,0 +1,113 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Test and benchmark of the parallel bulk load `LoadEmployees` against a generated SQLite database.
+
+  \details The program generates a SQLite file with employees, once with dense person ids and once
+           with sparse ids (a gap of `-Stride` between the ids), and loads each file into an empty
+           `EmployeeStore` with one partition and with the partitions of the configuration. The
+           loaded store is compared with the generated data, the partitions are checked against the
+           size of the pool.
+
+           Options: `-Employees <n>` (default 100000), `-Stride <n>` of the sparse ids (default 97),
+           `-Pool <n>` connections (default 4), `-Partitions <n>` (default 8, limited to the pool),
+           `-Rowset <n>` width of a rowset (default 10000), `-File <path>` of the SQLite database.
+
+  \version 1.0
+  \date    26.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+#include "SQLiteStandIn.h"
+
+#include "DatabasePool.h"
+#include "EmployeeLoader.h"
+#include "EmployeeStore.h"
+
+#include <QtCore/QCoreApplication>
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <filesystem>
+
+using sqlite_pool_ty = DatabasePool<SQLiteConnection, SQLiteQuery>;
+
+namespace {
+
+   /// \brief loads the file into an empty store, checks the content and returns the statistics
+   EmployeeLoadStatistics load_and_check(sqlite_pool_ty& pool, std::vector<CORBA::Long> const& ids, EmployeeLoadConfig const& config,
+                                         std::string_view what, bool& ok) {
+      EmployeeStore store;
+      auto const stats = LoadEmployees(pool, store, config);
+      ok &= bench::check(stats.rows == ids.size() && store.size() == ids.size(), std::format("{}: all employees loaded", what));
+      ok &= bench::check(stats.partitions <= pool.size(), std::format("{}: partitions limited to the pool", what));
+      ok &= bench::check(store.ids() == ids, std::format("{}: ids in the order of the keys", what));
+      bool same = true;
+      for (std::size_t i = 0; i < ids.size() && same; i += 1 + ids.size() / 1'000) {
+         auto const expected = FixtureEmployee(ids[i]);
+         auto const loaded   = store.record(static_cast<EmployeeStore::row_ty>(i));
+         same = loaded.personID == expected.personID && loaded.firstname == expected.firstname && loaded.name == expected.name &&
+                loaded.gender == expected.gender && loaded.salary == expected.salary && loaded.startDate == expected.startDate &&
+                loaded.isActive == expected.isActive;
+         }
+      ok &= bench::check(same, std::format("{}: loaded data equal to the generated data", what));
+      return stats;
+      }
+
+   }
+
+int main(int argc, char* argv[]) {
+   QCoreApplication app(argc, argv);
+   auto const employees  = bench::option<CORBA::Long>(argc, argv, "-Employees", 100'000);
+   auto const stride     = bench::option<CORBA::Long>(argc, argv, "-Stride", 97);
+   auto const pool_size  = bench::option<std::size_t>(argc, argv, "-Pool", 4);
+   auto const partitions = bench::option<std::size_t>(argc, argv, "-Partitions", 8);
+   auto const rowset     = bench::option<CORBA::Long>(argc, argv, "-Rowset", 10'000);
+   std::filesystem::path file = std::filesystem::temp_directory_path() / "EmployeeLoaderBench.sqlite";
+   for (int i = 1; i + 1 < argc; ++i)
+      if (std::string_view { argv[i] } == "-File") file = argv[i + 1];
+   bool ok = true;
+
+   std::println("LoadEmployees with {} employees, pool of {} connections, rowsets of {} ids", employees, pool_size, rowset);
+   for (auto const& [what, gap] : { std::pair { std::string_view { "dense ids" }, CORBA::Long { 1 } }, std::pair { std::string_view { "sparse ids" }, stride } }) {
+      std::vector<CORBA::Long> ids;
+      ids.reserve(static_cast<std::size_t>(employees));
+      for (CORBA::Long i = 0; i < employees; ++i) ids.emplace_back(1 + i * gap);
+      CreateEmployeeFixture(file, ids);
+      {
+         sqlite_pool_ty pool({ .size = pool_size }, [&file](SQLiteConnection& connection) { connection.Open(file); });
+         auto const single   = load_and_check(pool, ids, { .partitions = 1, .rowset_size = rowset }, what, ok);
+         auto const parallel = load_and_check(pool, ids, { .partitions = partitions, .rowset_size = rowset }, what, ok);
+         std::println("   {:<10}  1 partition:  {:8} ms  {:10.0f} rows/s  {:6} rowsets", what, single.duration.count(),
+                      single.rows_per_second(), single.rowsets);
+         std::println("   {:<10}  {} partitions: {:8} ms  {:10.0f} rows/s  {:6} rowsets", what, parallel.partitions,
+                      parallel.duration.count(), parallel.rows_per_second(), parallel.rowsets);
+      }
+      }
+
+   std::error_code ec;
+   std::filesystem::remove(file, ec);
+   return ok ? 0 : 1;
+   }
@@ -0,0 +1,161 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Contention benchmark of the published versions of the employee store against a shared_mutex.
+
+  \details Readers look up random employees and read a column, while one writer changes the salary
+           of an employee in a fixed interval. The same load runs once with `EmployeeVersions`
+           (lock-free reads of an immutable version, the writer copies the store) and once with an
+           `EmployeeStore` protected by a `std::shared_mutex` (shared lock for the readers, exclusive
+           lock for the writer), for 1, 2, 4, ... up to the configured number of readers.
+
+           Options: `-Employees <n>` (default 10000), `-Readers <n>` (default 16),
+           `-Duration <ms>` of each run (default 1000), `-WriteInterval <ms>` (default 1).
+
+  \version 1.0
+  \date    29.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+
+#include "EmployeeVersions.h"
+#include "EmployeeStore.h"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <barrier>
+#include <random>
+#include <shared_mutex>
+#include <mutex>
+
+namespace {
+
+   using namespace std::chrono;
+
+   struct RunResult {
+      std::uint64_t reads  = 0;  ///< lookups of all readers
+      std::uint64_t writes = 0;  ///< changes of the writer
+      };
+
+   EmployeeData employee(CORBA::Long personId, double salary) {
+      return { { personId, std::format("Firstname{}", personId), std::format("Name{}", personId % 977),
+                 static_cast<Organization::EGender>(personId % 3) },
+               salary, year_month_day { 2000y, January, 1d }, true };
+      }
+
+   /**
+     \brief Runs the readers and the writer for the duration.
+     \param read reads the employee with the id and returns its salary
+     \param write changes the employee with the id to the salary
+    */
+   template <typename read_ty, typename write_ty>
+   RunResult run(std::size_t readers, CORBA::Long employees, milliseconds duration, milliseconds interval, read_ty read, write_ty write) {
+      std::atomic<bool> stop = false;
+      std::atomic<std::uint64_t> reads = 0;
+      RunResult result;
+      std::barrier start(static_cast<std::ptrdiff_t>(readers + 2));
+      {
+         std::vector<std::jthread> threads;
+         for (std::size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r]() {
+               std::mt19937 random(static_cast<std::mt19937::result_type>(r + 1));
+               std::uniform_int_distribution<CORBA::Long> ids(1, employees);
+               std::uint64_t count = 0;
+               double sum = 0.0;
+               start.arrive_and_wait();
+               while (!stop.load(std::memory_order_relaxed)) {
+                  sum += read(ids(random));
+                  ++count;
+                  }
+               reads += count;
+               if (sum < 0.0) std::println("{}", sum);   // keeps the reads alive
+               });
+            }
+         threads.emplace_back([&]() {
+            start.arrive_and_wait();
+            for (CORBA::Long next = 0; !stop.load(std::memory_order_relaxed); ++next) {
+               write(next % employees + 1, 50'000.0 + static_cast<double>(next));
+               ++result.writes;
+               std::this_thread::sleep_for(interval);
+               }
+            });
+         start.arrive_and_wait();
+         std::this_thread::sleep_for(duration);
+         stop = true;
+      }
+      result.reads = reads;
+      return result;
+      }
+
+   }
+
+int main(int argc, char* argv[]) {
+   auto const employees = bench::option<CORBA::Long>(argc, argv, "-Employees", 10'000);
+   auto const readers   = bench::option<std::size_t>(argc, argv, "-Readers", 16);
+   auto const duration  = milliseconds { bench::option<int>(argc, argv, "-Duration", 1'000) };
+   auto const interval  = milliseconds { bench::option<int>(argc, argv, "-WriteInterval", 1) };
+   bool ok = true;
+
+   EmployeeStore initial;
+   initial.reserve(static_cast<std::size_t>(employees));
+   for (CORBA::Long personId = 1; personId <= employees; ++personId) initial.insert(employee(personId, 40'000.0));
+
+   std::println("{} employees, one writer every {}, {} per run", employees, interval, duration);
+   std::println("   readers   EmployeeVersions reads/s   shared_mutex reads/s   writes (versions / shared_mutex)");
+   for (std::size_t count = 1; count <= readers; count = count < readers && count * 2 > readers ? readers : count * 2) {
+      EmployeeVersions versions { EmployeeStore { initial } };
+      auto const lock_free = run(count, employees, duration, interval,
+                                 [&versions](CORBA::Long personId) {
+                                    auto const store = versions.current();
+                                    auto const row = store->find(personId);
+                                    return row ? store->salary(*row) : 0.0;
+                                    },
+                                 [&versions](CORBA::Long personId, double salary) {
+                                    versions.update([&](EmployeeStore& store) { store.insert(employee(personId, salary)); });
+                                    });
+
+      std::shared_mutex mutex;
+      EmployeeStore locked { initial };
+      auto const shared = run(count, employees, duration, interval,
+                              [&mutex, &locked](CORBA::Long personId) {
+                                 std::shared_lock lock(mutex);
+                                 auto const row = locked.find(personId);
+                                 return row ? locked.salary(*row) : 0.0;
+                                 },
+                              [&mutex, &locked](CORBA::Long personId, double salary) {
+                                 auto const data = employee(personId, salary);
+                                 std::unique_lock lock(mutex);
+                                 locked.insert(data);
+                                 });
+
+      ok &= bench::check(lock_free.reads > 0 && shared.reads > 0 && lock_free.writes > 0 && shared.writes > 0,
+                         std::format("{} readers: reads and writes done", count));
+      ok &= bench::check(versions.current()->size() == static_cast<std::size_t>(employees) && locked.size() == static_cast<std::size_t>(employees),
+                         std::format("{} readers: no employee lost", count));
+      std::println("   {:7}   {:24.0f}   {:20.0f}   {} / {}", count, lock_free.reads * 1'000.0 / duration.count(),
+                   shared.reads * 1'000.0 / duration.count(), lock_free.writes, shared.writes);
+      if (count == readers) break;
+      }
+   return ok ? 0 : 1;
+   }
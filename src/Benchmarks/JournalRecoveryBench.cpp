@@ -0,0 +1,107 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Benchmark of the recovery of the booking journal with 10 million records.
+
+  \details The program writes the records with batches into a new journal, closes it and measures
+           the replay at the start of the server twice: once only the reading and checking of the
+           segments, once with the restore into a `BookingLog` like in `Company_i::openBookingJournal`.
+           The number of replayed records and the content of the log are checked.
+
+           Options: `-Records <n>` (default 10000000), `-Employees <n>` (default 50000),
+           `-Batch <n>` records of one append (default 10000), `-Directory <path>` of the journal
+           (default in the temp directory, about 32 bytes per record, removed at the end).
+
+  \version 1.0
+  \date    28.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+
+#include "BookingJournal.h"
+#include "BookingLog.h"
+
+#include <vector>
+#include <filesystem>
+#include <algorithm>
+
+int main(int argc, char* argv[]) {
+   using namespace std::chrono;
+   auto const records   = bench::option<std::uint64_t>(argc, argv, "-Records", 10'000'000);
+   auto const employees = bench::option<CORBA::Long>(argc, argv, "-Employees", 50'000);
+   auto const batch     = bench::option<std::size_t>(argc, argv, "-Batch", 10'000);
+   std::filesystem::path directory = std::filesystem::temp_directory_path() / "JournalRecoveryBench";
+   for (int i = 1; i + 1 < argc; ++i)
+      if (std::string_view { argv[i] } == "-Directory") directory = argv[i + 1];
+   bool ok = true;
+
+   std::error_code ec;
+   std::filesystem::remove_all(directory, ec);
+
+   // every record has an own time point, so the restore drops no record as repetition
+   auto const start = BookingLog::now_ms() - milliseconds { records };
+   auto const written = bench::measure_once([&]() {
+      BookingJournal journal({ .directory = directory });
+      journal.open([](std::span<TimeBookingEvent const>) { });
+      std::vector<TimeBookingEvent> events;
+      events.reserve(std::max<std::size_t>(batch, 1));
+      for (std::uint64_t record = 0; record < records; ) {
+         events.clear();
+         for (; record < records && events.size() < std::max<std::size_t>(batch, 1); ++record)
+            events.emplace_back(TimeBookingEvent { .personId   = static_cast<CORBA::Long>(record % static_cast<std::uint64_t>(employees)) + 1,
+                                                   .timepoint  = start + milliseconds { record },
+                                                   .kind       = record / static_cast<std::uint64_t>(employees) % 2 == 0 ? Organization::COME : Organization::GO,
+                                                   .terminalId = static_cast<CORBA::Long>(record % 64) });
+         journal.append(events);
+         }
+      });
+
+   // replay only, the consumer counts the records
+   std::uint64_t scanned = 0;
+   BookingJournal::RecoveryStatistics scan;
+   auto const scan_time = bench::measure_once([&]() {
+      BookingJournal journal({ .directory = directory });
+      scan = journal.open([&scanned](std::span<TimeBookingEvent const> events) { scanned += events.size(); });
+      });
+   ok &= bench::check(scan.records == records && scanned == records && !scan.torn_tail, "all records replayed");
+
+   // replay with the restore into the booking log, as at the start of the server
+   BookingJournal::RecoveryStatistics recovery;
+   BookingLog::Statistics restored;
+   auto const recovery_time = bench::measure_once([&]() {
+      BookingLog log;
+      BookingJournal journal({ .directory = directory });
+      recovery = journal.open([&log](std::span<TimeBookingEvent const> events) { log.restore(events); });
+      restored = log.statistics();
+      });
+   ok &= bench::check(recovery.records == records && restored.accepted == records && restored.duplicates == 0,
+                      "all records restored into the booking log");
+
+   std::println("booking journal with {} records of {} employees, {} segments", records, employees, scan.segments);
+   std::println("   write in batches of {}:   {:10.1f} ms  {:12.0f} records/s", batch, written.count(), bench::per_second(records, written));
+   std::println("   replay, read and check:   {:10.1f} ms  {:12.0f} records/s", scan_time.count(), bench::per_second(records, scan_time));
+   std::println("   replay into BookingLog:   {:10.1f} ms  {:12.0f} records/s", recovery_time.count(), bench::per_second(records, recovery_time));
+
+   std::filesystem::remove_all(directory, ec);
+   return ok ? 0 : 1;
+   }
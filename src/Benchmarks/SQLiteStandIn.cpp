@@ -0,0 +1,132 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Implementation of the SQLite stand-in for the database tests and benchmarks
+
+  \version 1.0
+  \date    25.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "SQLiteStandIn.h"
+
+#include <QtSql/QSqlError>
+
+#include <atomic>
+#include <format>
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+SQLiteQuery::SQLiteQuery(QSqlDatabase const& database, std::string const& sql) : query_(database) {
+   query_.setForwardOnly(true);
+   if (!query_.prepare(QString::fromStdString(sql)))
+      throw std::runtime_error(std::format("statement \"{}\" not prepared: {}", sql, query_.lastError().text().toStdString()));
+   }
+
+void SQLiteQuery::Execute(std::vector<SQLiteParameter> const& parameters) {
+   for (auto const& parameter : parameters)
+      query_.bindValue(QString::fromStdString(":" + parameter.name), parameter.value);
+   if (!query_.exec())
+      throw std::runtime_error(std::format("statement not executed: {}", query_.lastError().text().toStdString()));
+   eof_ = !query_.next();
+   }
+
+std::optional<std::chrono::year_month_day> SQLiteQuery::ToDate(std::string const& text) {
+   int year = 0;
+   unsigned month = 0, day = 0;
+   auto parse = [&text](std::size_t pos, std::size_t len, auto& value) {
+      return pos + len <= text.size() && std::from_chars(text.data() + pos, text.data() + pos + len, value).ec == std::errc { };
+      };
+   if (!parse(0, 4, year) || !parse(5, 2, month) || !parse(8, 2, day)) return std::nullopt;
+   std::chrono::year_month_day const date { std::chrono::year { year }, std::chrono::month { month }, std::chrono::day { day } };
+   return date.ok() ? std::optional { date } : std::nullopt;
+   }
+
+SQLiteConnection::SQLiteConnection(SQLiteConnection&& other) noexcept
+   : name_(std::exchange(other.name_, QString { })), database_(std::exchange(other.database_, QSqlDatabase { })) { }
+
+SQLiteConnection& SQLiteConnection::operator = (SQLiteConnection&& other) noexcept {
+   if (this != &other) {
+      Close();
+      name_     = std::exchange(other.name_, QString { });
+      database_ = std::exchange(other.database_, QSqlDatabase { });
+      }
+   return *this;
+   }
+
+void SQLiteConnection::Open(std::filesystem::path const& file) {
+   static std::atomic<int> counter = 0;
+   Close();
+   name_     = QString::fromStdString(std::format("SQLiteStandIn_{}", ++counter));
+   database_ = QSqlDatabase::addDatabase("QSQLITE", name_);
+   database_.setDatabaseName(QString::fromStdString(file.string()));
+   if (!database_.open())
+      throw std::runtime_error(std::format("SQLite database {} not opened: {}", file.string(), database_.lastError().text().toStdString()));
+   }
+
+void SQLiteConnection::Close() {
+   if (name_.isEmpty()) return;
+   database_.close();
+   database_ = QSqlDatabase { };   // the last handle has to be released before the connection is removed
+   QSqlDatabase::removeDatabase(name_);
+   name_.clear();
+   }
+
+EmployeeData FixtureEmployee(CORBA::Long personId) {
+   using namespace std::chrono;
+   EmployeeData data;
+   data.personID  = personId;
+   data.firstname = std::format("Firstname{}", personId);
+   data.name      = std::format("Name{}", personId % 997);
+   data.gender    = static_cast<Organization::EGender>(personId % 3);
+   data.salary    = 30'000.0 + static_cast<double>(personId % 50'000);
+   data.startDate = year_month_day { sys_days { 2000y / January / 1d } + days { personId % 9'000 } };
+   data.isActive  = personId % 11 != 0;
+   return data;
+   }
+
+void CreateEmployeeFixture(std::filesystem::path const& file, std::vector<CORBA::Long> const& personIds) {
+   std::error_code ec;
+   std::filesystem::remove(file, ec);
+   SQLiteConnection connection;
+   connection.Open(file);
+   connection.Execute("CREATE TABLE Person (ID INTEGER PRIMARY KEY, Firstname TEXT NOT NULL, Name TEXT NOT NULL, Gender INTEGER NOT NULL)");
+   connection.Execute("CREATE TABLE Employee (ID INTEGER PRIMARY KEY REFERENCES Person(ID), Salary REAL NOT NULL, "
+                      "StartDate TEXT NOT NULL, IsActive INTEGER NOT NULL)");
+   connection.Execute("CREATE VIEW EmployeeView AS "
+                      "SELECT p.ID, p.Firstname, p.Name, p.Gender, e.Salary, e.StartDate, e.IsActive "
+                      "FROM Person p INNER JOIN Employee e ON e.ID = p.ID");
+
+   connection.Execute("BEGIN");
+   auto person   = connection.CreateQuery("INSERT INTO Person (ID, Firstname, Name, Gender) VALUES (:id, :firstname, :name, :gender)");
+   auto employee = connection.CreateQuery("INSERT INTO Employee (ID, Salary, StartDate, IsActive) VALUES (:id, :salary, :start, :active)");
+   for (auto const personId : personIds) {
+      auto const data = FixtureEmployee(personId);
+      person.Execute({ { "id", data.personID }, { "firstname", QString::fromStdString(data.firstname) },
+                       { "name", QString::fromStdString(data.name) }, { "gender", static_cast<int>(data.gender) } });
+      employee.Execute({ { "id", data.personID }, { "salary", data.salary },
+                         { "start", QString::fromStdString(std::format("{:%Y-%m-%d}", std::chrono::sys_days { data.startDate })) },
+                         { "active", data.isActive ? 1 : 0 } });
+      }
+   connection.Execute("COMMIT");
+   }
@@ -0,0 +1,138 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Local SQLite database as stand-in for the MS SQL server, accessed with Qt SQL.
+
+  \details The database layer of the application server is used with two operations only: the
+           connection creates queries with `CreateQuery(sql)`, a query is executed with named
+           parameters and read with `IsEof()`, `Next()` and the typed `Get<ty>(column)`. The classes
+           `SQLiteConnection` and `SQLiteQuery` provide these operations with the QSQLITE driver of
+           Qt SQL, so the `DatabasePool`, the statements of `EmployeeStatements.h` and the loaders of
+           `EmployeeLoader.h` run unchanged against a generated file.
+
+  \details `CreateEmployeeFixture` writes the tables `Person` and `Employee` and the view
+           `EmployeeView` like the production database, with generated employees.
+
+  \version 1.0
+  \date    25.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \see DatabasePool.h
+  \see EmployeeLoader.h
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include "EmployeeData.h"
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <filesystem>
+#include <chrono>
+#include <concepts>
+
+/// \brief named parameter of a statement, written like the parameters of the adecc Database layer
+struct SQLiteParameter {
+   std::string name;           ///< name without the colon of the placeholder
+   QVariant    value;
+   bool        input = true;   ///< only input parameters are supported
+   };
+
+/**
+  \brief Prepared statement of a `SQLiteConnection`.
+  \details The statement is prepared once and executed again with new parameters. The result is read
+           forward only, `IsEof()` is true after the last row.
+ */
+class SQLiteQuery {
+   QSqlQuery query_;
+   bool      eof_ = true;
+public:
+   SQLiteQuery(QSqlDatabase const& database, std::string const& sql);
+
+   /// \throws std::runtime_error if the execution fails
+   void Execute(std::vector<SQLiteParameter> const& parameters);
+
+   bool IsEof() const { return eof_; }
+   void Next() { eof_ = !query_.next(); }
+
+   /// \brief value of the column in the current row, std::nullopt for NULL
+   template <typename ty>
+   std::optional<ty> Get(std::string const& column) const {
+      QVariant const value = query_.value(QString::fromStdString(column));
+      if (value.isNull()) return std::nullopt;
+      if constexpr (std::same_as<ty, std::string>) return value.toString().toStdString();
+      else if constexpr (std::same_as<ty, bool>) return value.toBool();
+      else if constexpr (std::integral<ty>) return static_cast<ty>(value.toLongLong());
+      else if constexpr (std::floating_point<ty>) return static_cast<ty>(value.toDouble());
+      else if constexpr (std::same_as<ty, std::chrono::year_month_day>) return ToDate(value.toString().toStdString());
+      else static_assert(sizeof(ty) == 0, "type not supported by the SQLite stand-in");
+      }
+
+private:
+   /// \brief date of the ISO format YYYY-MM-DD, the format SQLite stores the dates in
+   static std::optional<std::chrono::year_month_day> ToDate(std::string const& text);
+   };
+
+/**
+  \brief Connection to a SQLite file, the connection type of the `DatabasePool` for the tests.
+  \details A connection is used by one thread at the same time only, like the connections of the
+           pool. A default constructed connection is closed, `Open()` opens it in place.
+ */
+class SQLiteConnection {
+   QString      name_;       ///< name of the connection in Qt SQL
+   QSqlDatabase database_;
+public:
+   SQLiteConnection() = default;
+   SQLiteConnection(SQLiteConnection const&) = delete;
+   SQLiteConnection& operator = (SQLiteConnection const&) = delete;
+   SQLiteConnection(SQLiteConnection&& other) noexcept;
+   SQLiteConnection& operator = (SQLiteConnection&& other) noexcept;
+   ~SQLiteConnection() { Close(); }
+
+   /// \throws std::runtime_error if the file can't be opened
+   void Open(std::filesystem::path const& file);
+   void Close();
+
+   bool IsOpen() const { return database_.isOpen(); }
+
+   SQLiteQuery CreateQuery(std::string const& sql) const { return SQLiteQuery(database_, sql); }
+
+   /// \brief executes a statement without parameters and result, e.g. DDL or BEGIN / COMMIT
+   void Execute(std::string const& sql) { CreateQuery(sql).Execute({ }); }
+   };
+
+/// \brief content of a generated employee, the benchmarks check the loaded data against it
+EmployeeData FixtureEmployee(CORBA::Long personId);
+
+/**
+  \brief Writes a new SQLite file with the tables of the employees and the given person ids.
+  \param file target file, an existing file is replaced
+  \param personIds ids of the generated employees, the data is built with \ref FixtureEmployee
+ */
+void CreateEmployeeFixture(std::filesystem::path const& file, std::vector<CORBA::Long> const& personIds);
@@ -0,0 +1,87 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Microbenchmark of the construction of EmployeeDataSeq replies with the CorbaSequenceBuilder.
+
+  \details Compares the former growth by one element (`length(i + 1)` for each element) with the
+           presized builder and with the geometric growth of the builder for an unsized range.
+           Each case copies the same employees of an `EmployeeStore` into a new sequence.
+
+           Options: `-Count <n>` employees in the reply (default 10000), `-Repeats <n>` (default 20).
+
+  \version 1.0
+  \date    25.08.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+
+#include "EmployeeStore.h"
+#include "CorbaSequenceBuilder.h"
+
+#include <ranges>
+#include <string>
+#include <format>
+
+int main(int argc, char* argv[]) {
+   using namespace std::chrono;
+   auto const count   = bench::option<std::size_t>(argc, argv, "-Count", 10'000);
+   auto const repeats = bench::option<std::size_t>(argc, argv, "-Repeats", 20);
+
+   EmployeeStore store;
+   store.reserve(count);
+   for (std::size_t i = 0; i < count; ++i)
+      store.insert({ { static_cast<CORBA::Long>(1'000 + i), std::format("Firstname{}", i), std::format("Name{}", i % 977),
+                       static_cast<Organization::EGender>(i % 3) },
+                     40'000.0 + static_cast<double>(i % 50'000), year_month_day { 2000y + years { static_cast<int>(i % 25) }, January, 1d }, i % 7 != 0 });
+   auto const rows = std::views::iota(EmployeeStore::row_ty { 0 }, static_cast<EmployeeStore::row_ty>(store.size()));
+   bool ok = true;
+
+   // former implementation, the length grows with each element
+   auto const grow_by_one = bench::measure(repeats, [&]() {
+      Organization::EmployeeDataSeq_var seq = new Organization::EmployeeDataSeq;
+      for (CORBA::ULong index = 0; auto row : rows) {
+         seq->length(index + 1);
+         store.copy_to(row, seq[index++]);
+         }
+      ok &= bench::check(seq->length() == count, "length of the sequence grown by one");
+      });
+
+   auto const presized = bench::measure(repeats, [&]() {
+      Organization::EmployeeDataSeq_var seq = build_sequence<Organization::EmployeeDataSeq>(rows,
+                                                 [&store](Organization::EmployeeData& target, EmployeeStore::row_ty row) { store.copy_to(row, target); });
+      ok &= bench::check(seq->length() == count, "length of the presized sequence");
+      });
+
+   // the filter hides the size of the range, the builder doubles its capacity
+   auto const geometric = bench::measure(repeats, [&]() {
+      Organization::EmployeeDataSeq_var seq = build_sequence<Organization::EmployeeDataSeq>(rows | std::views::filter([](auto) { return true; }),
+                                                 [&store](Organization::EmployeeData& target, EmployeeStore::row_ty row) { store.copy_to(row, target); });
+      ok &= bench::check(seq->length() == count, "length of the geometric grown sequence");
+      });
+
+   std::println("EmployeeDataSeq with {} elements, median of {} runs", count, repeats);
+   std::println("   length(i + 1) per element: {:10.3f} ms", grow_by_one.count());
+   std::println("   builder, presized:         {:10.3f} ms  ({:.1f}x)", presized.count(), grow_by_one / presized);
+   std::println("   builder, geometric growth: {:10.3f} ms  ({:.1f}x)", geometric.count(), grow_by_one / geometric);
+   return ok ? 0 : 1;
+   }
@@ -0,0 +1,136 @@
+﻿// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Benchmark of the check of the working time rules for all employees over a full month.
+
+  \details The program books the shifts of a month into a `BookingLog` and runs
+           `WorkTimeRules::check_all` for all employees, like the monthly check of the company. Most
+           employees work a day shift with a break at noon, some a night shift from 22:00 to 06:00
+           with a break at 02:00, which must be one working day without a violation, and some a long
+           day, which violates the maximal daily work and the break after 9 hours on each workday.
+           The month is March 2025 with the change to the daylight saving time in Europe/Berlin.
+
+           Options: `-Employees <n>` (default 10000), `-Repeats <n>` measured runs (default 5),
+           `-Budget <n>` milliseconds allowed for one run (default 1000).
+
+  \version 1.0
+  \date    16.10.2026
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#include "BenchmarkTools.h"
+
+#include "BookingLog.h"
+#include "WorkTimeEngine.h"
+#include "WorkTimeRules.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+namespace {
+
+   using namespace std::chrono;
+
+   enum class EShift { Day, Night, Long };
+
+   /// \brief 15 % night shifts, 5 % long days, the others day shifts
+   EShift shift_of(CORBA::Long personId) {
+      switch (personId % 20) {
+         case 0:           return EShift::Long;
+         case 1: case 2: case 3: return EShift::Night;
+         default:          return EShift::Day;
+         }
+      }
+
+   /// \brief bookings of an employee for the workdays of the month, times are local times of the engine
+   void book_month(BookingLog& log, WorkTimeEngine const& engine, CORBA::Long personId, sys_days first, sys_days last, booking_time_ty now) {
+      auto at = [&engine](sys_days day, minutes time) { return time_point_cast<milliseconds>(engine.begin_of(day) + time); };
+      auto book = [&](booking_time_ty time, Organization::EBookingKind kind) { log.append(TimeBookingEvent { personId, time, kind, 1 }, now); };
+      for (auto day = first; day <= last; day += days { 1 }) {
+         if (engine.target(day) == milliseconds { 0 }) continue;
+         switch (shift_of(personId)) {
+            case EShift::Day:
+               book(at(day, 8h), Organization::COME);
+               book(at(day, 12h), Organization::BREAK_BEGIN);
+               book(at(day, 12h + 30min), Organization::BREAK_END);
+               book(at(day, 16h + 30min), Organization::GO);
+               break;
+            case EShift::Night:
+               book(at(day, 22h), Organization::COME);
+               book(at(day + days { 1 }, 2h), Organization::BREAK_BEGIN);
+               book(at(day + days { 1 }, 2h + 30min), Organization::BREAK_END);
+               book(at(day + days { 1 }, 6h), Organization::GO);
+               break;
+            case EShift::Long:
+               book(at(day, 7h), Organization::COME);
+               book(at(day, 12h), Organization::BREAK_BEGIN);
+               book(at(day, 12h + 30min), Organization::BREAK_END);
+               book(at(day, 18h + 30min), Organization::GO);
+               break;
+            }
+         }
+      }
+
+   }
+
+int main(int argc, char* argv[]) {
+   auto const employees = bench::option<CORBA::Long>(argc, argv, "-Employees", 10'000);
+   auto const repeats   = bench::option<std::size_t>(argc, argv, "-Repeats", 5);
+   auto const budget    = bench::duration_ty { bench::option<double>(argc, argv, "-Budget", 1'000.0) };
+   bool ok = true;
+
+   sys_days const month_begin { 2025y / March / 1 }, month_end { 2025y / March / last };
+   WorkTimeEngine const engine;
+   WorkTimeRules const rules(engine);
+   BookingLog log({ .max_past = days { 62 } });
+   auto const now = time_point_cast<milliseconds>(engine.begin_of(month_end + days { 2 }));
+
+   std::vector<CORBA::Long> personIds(static_cast<std::size_t>(std::max<CORBA::Long>(employees, 0)));
+   std::iota(personIds.begin(), personIds.end(), CORBA::Long { 1 });
+   auto const booked = bench::measure_once([&]() {
+      for (auto const personId : personIds) book_month(log, engine, personId, month_begin, month_end, now);
+      });
+   auto const stats = log.statistics();
+
+   std::vector<WorkTimeViolation> violations;
+   auto const duration = bench::measure(repeats, [&]() { violations = rules.check_all(log, personIds, month_begin, month_end); });
+
+   std::size_t workdays = 0;
+   for (auto day = month_begin; day <= month_end; day += days { 1 }) workdays += engine.target(day) > milliseconds { 0 } ? 1 : 0;
+   auto const long_days = static_cast<std::size_t>(std::ranges::count(personIds, EShift::Long, shift_of)) * workdays;
+
+   std::println("working time rules: {} employees, {} bookings of {} days booked in {:.1f} ms", personIds.size(), stats.accepted,
+                (month_end - month_begin).count() + 1, booked.count());
+   std::println("   check_all {:9.1f} ms  {:10.0f} employees/s  {} violations", duration.count(),
+                bench::per_second(personIds.size(), duration), violations.size());
+
+   ok &= bench::check(stats.invalid == 0, "all bookings accepted");
+   ok &= bench::check(std::ranges::none_of(violations, [](auto const& violation) { return shift_of(violation.personId) != EShift::Long; }),
+                      "no violation of the day and night shifts (night shift is one working day)");
+   ok &= bench::check(std::ranges::count(violations, Organization::RULE_MAX_DAILY_WORK, &WorkTimeViolation::rule) ==
+                         static_cast<std::ptrdiff_t>(long_days), "maximal daily work of each long day");
+   ok &= bench::check(std::ranges::count(violations, Organization::RULE_MIN_BREAK_9H, &WorkTimeViolation::rule) ==
+                         static_cast<std::ptrdiff_t>(long_days), "break after 9 hours of each long day");
+   ok &= bench::check(duration < budget, std::format("check of a month within {}", budget));
+   return ok ? 0 : 1;
+   }
@@ -64,6 +64,7 @@ using namespace std::string_literals;
 static_assert(CORBAStub<Organization::Company>, "Organization::Company does not satisfy the CORBAStub concept");
 static_assert(CORBAStub<Organization::Employee>, "Organization::Employee does not satisfy the CORBAStub concept");
 static_assert(CORBAStubWithDestroy<Organization::Employee>, "Organization::Employee does not satisfy the CORBAStubWithDestroy concept");
+static_assert(CORBAStubWithDestroy<Organization::EmployeeIterator>, "Organization::EmployeeIterator does not satisfy the CORBAStubWithDestroy concept");
 
 int main(int argc, char *argv[]) {
    const std::string strMainClient = "Client"s;
@@ -83,6 +84,7 @@ int main(int argc, char *argv[]) {
       std::println(std::cout, "Company {}, to paid salaries {:.2f}", company()->nameCompany(), company()->getSumSalary());
       GetEmployee(company(), 105);
       GetEmployees(company());
+      StreamEmployees(company());
       Organization::Employee_var employee = company()->getEmployee(180);
 
       }
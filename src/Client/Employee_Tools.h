@@ -86,6 +86,18 @@ inline void ShowEmployee(std::ostream& out, Organization::Employee_ptr employee)
 	//   }
 }
 
+/**
+ \brief Displays key information for the transferred data of an employee.
+
+ \param out Output stream to write the formatted data to.
+ \param employee value-based data of the employee.
+ */
+inline void ShowEmployee(std::ostream& out, Organization::EmployeeData const& employee) {
+	std::println(out, "ID: {:>4}, Name: {:<25}, Status: {:<3}, Salary: {:>10.2f}", employee.personId,
+	             std::string { employee.firstName.in() } + " "s + employee.name.in(),
+	             (employee.isActive ? "Yes" : "No"), employee.salary);
+   }
+
 /**
  \brief Requests and displays a single employee by ID from the Company object.
 
@@ -200,48 +212,48 @@ std::vector<Destroyable_Var<corba_ty>> move_from_sequence(typename CorbaSequence
 /**
  \brief Retrieves and prints the list of all employees from the company.
 
- \param comp_in Company CORBA object providing the employee sequence.
+ \details The employees are transferred as values in pages with \c getEmployeesData(). One remote
+          call delivers a complete page, instead of a reference per employee and several remote
+          calls for the attributes of each reference.
 
- \note The function cleans up the returned references by calling \c destroy() on each.
+ \param comp_in Company CORBA object providing the employee data.
+ \param page_size requested number of employees per page (the server can reduce it).
  */
-inline void GetEmployees(Organization::Company_ptr comp_in) {
+inline void GetEmployees(Organization::Company_ptr comp_in, CORBA::ULong page_size = 250) {
 	static const std::string strScope = "GetEmployees()"s;
 	log_trace<2>("[{} {}] Requesting employees.", strScope, getTimeStamp(comp_in));
 
-	auto values = move_from_sequence<Organization::Employee>(Organization::EmployeeSeq_var { comp_in->getEmployees() });
-	//auto values = move_from_sequence<Organization::Employee>( comp_in->getEmployees() );
-	std::println(std::cout, "[{} {}] Received sequence with {} employee references.", strScope, getTimeStamp(comp_in), values.size());
-	for(auto const& value : values) ShowEmployee(std::cout, value.get());
-
-	/*
-	Organization::EmployeeSeq_var employees_seq = comp_in->getEmployees();
-	std::println(std::cout, "[{} {}] Received sequence with {} employee references.", strScope, getTimeStamp(comp_in),
-					 employees_seq->length());
-
-	for (CORBA::ULong i = 0; i < employees_seq->length(); ++i) {
-		Organization::Employee_ptr current_employee = employees_seq[i];
-		if (CORBA::is_nil(current_employee)) {
-			log_error("[{} {}] WARNING: Nil reference encountered in sequence at index {}", strScope, getTimeStamp(comp_in), i);
-			continue;
-	   	}
-
-		try {
-			std::print(std::cout, "  Employee [{:>3}] - ", i);
-			ShowEmployee(std::cout, current_employee);
-
-		   } 
-		catch (CORBA::Exception const& ex) {
-			log_error("[{} {}] Error accessing employee data at index {}: {}", strScope, getTimeStamp(comp_in), i, toString(ex));
-		   }
+	CORBA::ULong offset = 0, received = 0, pages = 0;
+	for (;;) {
+		Organization::EmployeeDataPage_var page = comp_in->getEmployeesData(offset, page_size);
+		++pages;
+		for (CORBA::ULong i = 0; i < page->employees.length(); ++i) ShowEmployee(std::cout, page->employees[i]);
+		received += page->employees.length();
+		if (page->nextOffset <= offset || page->nextOffset >= page->totalCount) break;
+		offset = page->nextOffset;
 	   }
+	std::println(std::cout, "[{} {}] Received {} employees in {} page(s).", strScope, getTimeStamp(comp_in), received, pages);
+   }
 
-	std::println(std::cout, "[Client] End of scope for EmployeeSeq_var. Releasing references in sequence...");
+/**
+ \brief Streams the data of all employees with a server side iterator.
 
-	for (CORBA::ULong i = 0; i < employees_seq->length(); ++i) {
-		if (!CORBA::is_nil(employees_seq[i].in())) {
-			employees_seq[i]->destroy();
-			employees_seq[i] = Organization::Employee::_nil();
-		   }
+ \details The employees are requested in chunks with \c next_n(), the memory on the client
+          is bound by the size of a chunk. The iterator is destroyed on the server when the
+          \c Destroyable_Var leaves the scope.
+
+ \param comp_in Company CORBA object providing the iterator.
+ \param chunk_size requested number of employees per chunk (the server can reduce it).
+ */
+inline void StreamEmployees(Organization::Company_ptr comp_in, CORBA::ULong chunk_size = 100) {
+	static const std::string strScope = "StreamEmployees()"s;
+	log_trace<2>("[{} {}] Requesting employee iterator.", strScope, getTimeStamp(comp_in));
+
+	auto iterator = make_destroyable(comp_in->getEmployeesIterator());
+	CORBA::ULong received = 0;
+	for (Organization::EmployeeDataSeq_var chunk; iterator->next_n(chunk_size, chunk.out()); ) {
+		for (CORBA::ULong i = 0; i < chunk->length(); ++i) ShowEmployee(std::cout, chunk[i]);
+		received += chunk->length();
 	   }
-	*/
+	std::println(std::cout, "[{} {}] Received {} employees from the iterator.", strScope, getTimeStamp(comp_in), received);
    }
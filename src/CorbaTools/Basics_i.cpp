@@ -63,6 +63,9 @@ DestroyableInterface_i::~DestroyableInterface_i() {
  
            After deactivation, the method calls `_remove_ref()` which decrements the servant’s reference count.
            When it reaches zero, the object is deleted.
+
+           Servants without an ObjectId (see `set_oid()`) were incarnated by a servant manager
+           (e.g. a servant locator) and aren't in an active object map. For them the call is ignored.
  
   \note On the client side, a concept named `CORBAStubWithDestroy` is defined. It builds upon the
         `CORBAStub` concept (which verifies that a type represents a CORBA stub), and additionally checks
@@ -78,6 +81,12 @@ DestroyableInterface_i::~DestroyableInterface_i() {
 void DestroyableInterface_i::destroy() {
    log_trace<4>("[DestroyableInterface_i {}] destroy() called.", ::getTimeStamp());
 
+   // servant without ObjectId is incarnated by a servant manager, the manager controls the lifetime
+   if (oid_.ptr() == nullptr) {
+      log_trace<4>("[DestroyableInterface_i {}] servant not explicit activated, lifetime managed by the servant manager.", ::getTimeStamp());
+      return;
+      }
+
    try {
       poa_->deactivate_object(oid_);  // Objekt deregistrieren
       }
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 adecc Systemhaus GmbH
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/**
+  \file
+  \brief Builder for unbounded CORBA sequences with reserved capacity and geometric growth.
+
+  \details `seq->length(n + 1)` for each new element lets the TAO sequence reallocate and copy
+           the whole buffer with every call, the construction of a reply becomes O(n²).
+           `CorbaSequenceBuilder` separates the logical size from the length of the sequence:
+           the buffer is allocated once for sized ranges or grows geometrically for unsized
+           ranges, and the length is set to the real number of elements at the end.
+
+  \version 1.0
+  \date    28.07.2025
+  \author  Volker Hillmann (adecc Systemhaus GmbH)
+  \copyright Copyright © 2020 - 2025 adecc Systemhaus GmbH
+
+  \licenseblock{GPL-3.0-or-later}
+  This program is free software: you can redistribute it and/or modify it
+  under the terms of the GNU General Public License, version 3,
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program. If not, see <https://www.gnu.org/licenses/>.
+  \endlicenseblock
+
+  \note This file is part of the adecc Scholar project – Free educational materials for modern C++.
+ */
+
+#pragma once
+
+#include <tao/corba.h>
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+/**
+  \brief Builds an unbounded CORBA sequence without a reallocation for each element.
+
+  \tparam seq_ty generated IDL sequence type (e.g. `Organization::EmployeeSeq`)
+
+  \details Elements are written in place with \ref next() (e.g. for a copy from a column store)
+           or assigned with \ref push_back(). For object references the pointer is taken over
+           with `_retn()` of a `_var`, for structures the value is moved into the element.
+
+  \code{.cpp}
+  CorbaSequenceBuilder<Organization::EmployeeDataSeq> builder(rows.size());
+  for (auto row : rows) store.copy_to(row, builder.next());
+  return builder.release();
+  \endcode
+ */
+template <typename seq_ty>
+class CorbaSequenceBuilder {
+public:
+   using var_type = typename seq_ty::_var_type;
+
+   static constexpr CORBA::ULong MinGrowth = 16; ///< first capacity when the size is unknown
+
+private:
+   var_type     seq_;      ///< sequence under construction
+   CORBA::ULong size_ = 0; ///< number of elements written, the length of seq_ is the capacity
+
+public:
+   CorbaSequenceBuilder() : seq_(new seq_ty) {}
+
+   /// \param capacity number of elements which are written without a reallocation
+   explicit CorbaSequenceBuilder(CORBA::ULong capacity) : seq_(new seq_ty) { reserve(capacity); }
+
+   CorbaSequenceBuilder(CorbaSequenceBuilder const&) = delete;
+   CorbaSequenceBuilder& operator = (CorbaSequenceBuilder const&) = delete;
+
+   /// \brief number of elements written so far
+   CORBA::ULong size() const { return size_; }
+
+   /// \brief makes sure that at least `capacity` elements can be written without a reallocation
+   void reserve(CORBA::ULong capacity) {
+      if (capacity > seq_->length()) seq_->length(capacity);
+      }
+
+   /**
+     \brief Returns the next free element of the sequence to write it in place.
+     \details When the capacity is exhausted, it is doubled.
+    */
+   decltype(auto) next() {
+      if (size_ == seq_->length()) reserve(std::max(MinGrowth, size_ * 2));
+      return seq_[size_++];
+      }
+
+   /// \brief appends an element, values are moved, `_ptr` are taken over by the sequence
+   template <typename elem_ty>
+   void push_back(elem_ty&& elem) {
+      next() = std::forward<elem_ty>(elem);
+      }
+
+   /**
+     \brief Sets the length to the number of written elements and hands the sequence to the caller.
+     \return sequence with the ownership for the caller (e.g. as return value of an IDL operation)
+    */
+   seq_ty* release() {
+      seq_->length(size_);
+      size_ = 0;
+      return seq_._retn();
+      }
+   };
+
+/**
+  \brief Builds a CORBA sequence from a range with a projection for each element.
+
+  \details For a `std::ranges::sized_range` the buffer is allocated once with the exact size,
+           otherwise the builder grows geometrically.
+
+  \tparam seq_ty generated IDL sequence type
+  \param range input range
+  \param fill callable `void(element&, value)` which writes one element in place
+  \return new sequence, the caller takes the ownership
+ */
+template <typename seq_ty, std::ranges::input_range range_ty, typename fill_ty>
+seq_ty* build_sequence(range_ty&& range, fill_ty&& fill) {
+   CorbaSequenceBuilder<seq_ty> builder;
+   if constexpr (std::ranges::sized_range<range_ty>)
+      builder.reserve(static_cast<CORBA::ULong>(std::ranges::size(range)));
+   for (auto&& value : range) fill(builder.next(), std::forward<decltype(value)>(value));
+   return builder.release();
+   }
@@ -88,6 +88,8 @@
 #include <array>
 #include <atomic>
 #include <thread>
+#include <algorithm>
+#include <cstdint>
 
 using namespace std::string_literals;
 
@@ -339,6 +341,50 @@ protected:
 };
 
 
+/**
+  \brief Dispatch profile of a CORBA server, selects the TAO strategies for the upcalls.
+
+  \details TAO reads its strategies from the service configurator when the ORB is initialized. The
+           profile is translated into `-ORBSvcConfDirective` options for `ORB_init` by \ref ORBArguments,
+           so no svc.conf file is needed. The number of threads which dispatch the requests is the
+           parameter of \ref CORBAServer::run.
+ */
+enum class EORBDispatch : std::uint8_t {
+   ThreadPool,          ///< default of TAO, the TP reactor dispatches with all threads of run() (leader / followers)
+   ThreadPerConnection  ///< an own thread for each client connection, the threads of run() only accept the connections
+   };
+
+/**
+  \brief Copy of the command line for `ORB_init` with the options of a dispatch profile.
+
+  \details `ORB_init` removes the options it has consumed from the arguments, the copy keeps the
+           original command line of `main` unchanged for the options of the application.
+ */
+class ORBArguments {
+   std::vector<std::string> args_;   ///< owned arguments
+   std::vector<char*>       argv_;   ///< pointers to the arguments, terminated by nullptr
+public:
+   ORBArguments(int argc, char* argv[], EORBDispatch profile = EORBDispatch::ThreadPool) : args_(argv, argv + argc) {
+      switch (profile) {
+         case EORBDispatch::ThreadPool: break;
+         case EORBDispatch::ThreadPerConnection:
+            args_.emplace_back("-ORBSvcConfDirective"s);
+            args_.emplace_back("static Server_Strategy_Factory \"-ORBConcurrency thread-per-connection\""s);
+            break;
+         }
+      argv_.reserve(args_.size() + 1);
+      for (auto& arg : args_) argv_.emplace_back(arg.data());
+      argv_.emplace_back(nullptr);
+      }
+
+   ORBArguments(ORBArguments const&) = delete;
+   ORBArguments& operator = (ORBArguments const&) = delete;
+
+   int    argc() const { return static_cast<int>(args_.size()); }
+   char** argv() { return argv_.data(); }
+   };
+
+
 /**
   \class CORBAServer
   \brief Templated CORBA server class for managing multiple servant types.
@@ -350,11 +396,20 @@ protected:
   - Creating and managing a single servant POA (Persistent lifespan)
   - Registering each servant with the naming service
   - Activating and deactivating servant objects
-  - Launching the ORB event loop in a background thread
+  - Launching the ORB event loop in one or more background threads
   - Automatically cleaning up on shutdown
  
   The internal storage and indexing are tuple-based and rely on compile-time indices.
 
+  \par Thread safety of the servants
+  With more than one thread in \ref run the operations of the servants are called concurrently,
+  also the same operation for the same object. A servant registered here must therefore
+  - protect all state which is changed by its operations (mutex, atomics or immutable versions),
+  - set its configuration before it is registered, not while the ORB dispatches requests,
+  - not hold a lock while it calls another CORBA object, the waiting thread may dispatch a
+    nested request to the same servant (wait strategy of TAO for multithreaded ORBs).
+  With one thread the requests are processed one after another, as before.
+
   \see \ref appserver for more informations
   \see \ref app_lifecycle more informations about the lifecycle of a corba server
   \see \ref firstservertemplate a first template with a single skeleton
@@ -368,7 +423,7 @@ private:
    PortableServer::POA_var        root_poa_    = {}; ///< Root POA reference
    PortableServer::POAManager_var poa_manager_ = {}; ///< POA Manager reference
    PortableServer::POA_var        servant_poa_ = {}; ///< Dedicated POA for activating servants
-   std::thread                    orb_thread_;       ///< Background thread for ORB event loop
+   std::vector<std::thread>       orb_threads_;      ///< Background threads running the ORB event loop
    std::chrono::milliseconds      wait_interval_;    ///< Wait interval for shutdown polling
 
    /**
@@ -442,15 +497,22 @@ public:
    /** \brief Destructor shuts down and deactivates all registered servants */
    virtual ~CORBAServer() {
       shutdown_all();
+      if (IsActive()) {
+         stop_orb(true);
+         Wait();
+         }
       log_trace<9>("[{} {}] CORBAServer deleted.", Text(), ::getTimeStamp());
       }
 
    bool IsActive() const {
-      return orb_thread_.joinable() ? true : false;
+      return std::ranges::any_of(orb_threads_, [](std::thread const& thread) { return thread.joinable(); });
       }
 
+   /** \brief Waits for all ORB threads, they finish after the ORB was shut down (\ref stop_orb) */
    void Wait() {
-      if (IsActive()) orb_thread_.join();
+      for (auto& thread : orb_threads_)
+         if (thread.joinable()) thread.join();
+      orb_threads_.clear();
       }
 
    /**
@@ -552,12 +614,17 @@ public:
       }
 
    /**
-    * \brief Launches the ORB loop in a background thread and waits for shutdown
+    * \brief Launches the ORB loop in background threads and waits for shutdown
+    * \details Each thread calls `orb()->run()`, TAO dispatches the requests with all of them (see the
+    *          thread safety of the servants in the description of the class).
     * \param shutdown_requested Flag for stopping the loop
+    * \param threads Number of threads dispatching the requests, 0 = hardware concurrency
     */
-   void run(std::atomic<bool>& shutdown_requested) {
-      orb_thread_ = std::thread([&]() {
-         std::string strOrb = "ORB Thread for "s + Name();
+   void run(std::atomic<bool>& shutdown_requested, std::size_t threads = 1) {
+      if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+      orb_threads_.reserve(orb_threads_.size() + threads);
+      for (std::size_t i = 0; i < threads; ++i) orb_threads_.emplace_back([this, i]() {
+         std::string strOrb = std::format("ORB Thread {} for {}", i, Name());
          try {
             orb()->run();
             log_trace<9>("   [{} {}] orb->run() finished.", strOrb, ::getTimeStamp());
@@ -572,6 +639,7 @@ public:
             log_error("  [{} {}], unknown Exception in orb->run()", strOrb, ::getTimeStamp());
             }
          });
+      log_trace<9>("[{} {}] ORB started with {} dispatch threads.", Text(), ::getTimeStamp(), threads);
       log_state("[{} {}] Server is ready. <Waiting for shutdown signal (e.g. Cntrl+C) ...", Text(), ::getTimeStamp());
       while (!shutdown_requested) {
          std::this_thread::sleep_for(wait_interval_);
@@ -19,7 +19,7 @@
            In this project, multiple POAs are used to separate concerns and optimize servant management:
  
            - A **persistent POA** for long-lived objects like the `Company` servant.
-           - A **transient POA** for short-lived or per-request servants like `Employee`.
+           - A **transient POA** with a default servant or a servant locator for the `Employee` references.
  
   This separation allows clean shutdown, controlled memory management, and support for complex interaction scenarios.
  
@@ -28,16 +28,24 @@
   \details POAs are configured during server startup using different policy sets:
  
   - `LifespanPolicy::PERSISTENT` is used for `CompanyPOA`, allowing the company object to be consistently resolvable via the Naming Service.
-  - `LifespanPolicy::TRANSIENT` and `ServantRetentionPolicy::RETAIN` are used for `EmployeePOA`, which dynamically creates and destroys employee servants.
+  - `LifespanPolicy::TRANSIENT`, `IdAssignmentPolicy::USER_ID`, `IdUniquenessPolicy::MULTIPLE_ID`,
+    `ServantRetentionPolicy::NON_RETAIN` and `RequestProcessingPolicy::USE_DEFAULT_SERVANT` are used for
+    `EmployeePOA`. No servant is activated for an employee, the references are created with
+    `create_reference_with_id()` and the ObjectId contains the person id. The one stateless
+    `EmployeeDefaultServant_i` reads the id with `PortableServer::Current` and the data from the store.
  
-  \details Example creation:
+  \details Alternatively the server can be started with `-EmployeeCache <n>`. Then `EmployeePOA` uses
+           `RequestProcessingPolicy::USE_SERVANT_MANAGER` with an `EmployeeServantLocator`. The locator
+           incarnates an `Employee_i` per employee on demand and keeps at most `n` of them in a LRU cache.
+           The least recently used servant is etherealized when the cache is full, so the number of
+           servants is bounded even when clients never call `destroy()`. The counters of the cache
+           (hits, misses, evictions) are available with `Company_i::employeeCacheStatistics()`.
+
+  \details Example creation (see `EmployeePOA.h`):
   \code{.cpp}
-  CORBA::PolicyList empl_pol;
-  empl_pol.length(2);
-  empl_pol[0] = root_poa->create_lifespan_policy(PortableServer::TRANSIENT);
-  empl_pol[1] = root_poa->create_servant_retention_policy(PortableServer::RETAIN);
- 
+  CORBA::PolicyList empl_pol = CreateEmployeePolicies(root_poa.in());
   PortableServer::POA_var employee_poa = root_poa->create_POA("EmployeePOA", poa_manager.in(), empl_pol);
+  for (CORBA::ULong i = 0; i < empl_pol.length(); ++i) empl_pol[i]->destroy();
   \endcode
  
   \section poa_assignment Deferred POA Assignment
@@ -51,6 +59,8 @@
   \section poa_notes Notes
   - Each servant is explicitly activated via the assigned POA.
   - Transient servants like `Employee_i` should implement `destroy()` to cleanly deactivate themselves from the POA.
+  - References served by a default servant don't own server resources, `destroy()` is a no-op for them.
+  - Servants incarnated by the servant locator have no ObjectId set, `destroy()` leaves their lifetime to the cache.
   - It is critical to duplicate POA pointers (`_duplicate`) before storing them in member variables.
   - Correct use of `PortableServer::ObjectId` and POA deactivation ensures that resources are reclaimed safely.
  